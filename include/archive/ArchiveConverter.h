@@ -0,0 +1,43 @@
+#ifndef ARCHIVECONVERTER_H
+#define ARCHIVECONVERTER_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Command-line conversions between PGN files and GameArchive files
+ * ("chess archive ..."). Each reports its counts and throughput on stdout.
+ */
+class ArchiveConverter {
+private:
+    // Private constructor to prevent instantiation
+    ArchiveConverter() = delete;
+
+public:
+    /**
+     * Converts a PGN file to an archive, then decodes the archive again to
+     * report the compression ratio and decode speed in moves/sec.
+     * @param pgnFile Input PGN file
+     * @param archiveFile Output archive
+     * @return Process exit code (0 if every game was converted)
+     */
+    static int pack(const std::string& pgnFile, const std::string& archiveFile);
+
+    /**
+     * Converts an archive back to PGN.
+     * @param archiveFile Input archive
+     * @param pgnFile Output PGN file
+     * @return Process exit code (0 if every game was converted)
+     */
+    static int unpack(const std::string& archiveFile, const std::string& pgnFile);
+
+    /**
+     * Prints one game of an archive as PGN, using the offset index.
+     * @param archiveFile The archive
+     * @param index Game number (0-based)
+     * @return Process exit code (0 if the game was found)
+     */
+    static int show(const std::string& archiveFile, uint64_t index);
+};
+
+#endif // ARCHIVECONVERTER_H
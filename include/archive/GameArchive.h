@@ -0,0 +1,183 @@
+#ifndef GAMEARCHIVE_H
+#define GAMEARCHIVE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "enums/Color.h"
+#include "game/Game.h"
+#include "input/PGNReader.h"
+#include "input/PGNWriter.h"
+#include "util/MappedFile.h"
+
+/**
+ * One game as stored in a GameArchive: its Seven Tag Roster, the start
+ * position (empty for the standard one) and one byte per ply.
+ */
+struct ArchivedGame {
+    PGNHeader header;
+    std::string startFen;
+    std::vector<uint8_t> moves;  // index of each move in GameArchive::legalMoves()
+};
+
+/**
+ * Read-only access to a binary game archive written by GameArchiveWriter.
+ *
+ * Each move is stored as its index in the position's legal moves, ordered by
+ * from-square and then by Move::encode(), so one byte covers any position (at
+ * most 218 moves) and decoding needs no SAN resolution; it only generates
+ * moves up to the stored index. The file is memory-mapped, and an offset
+ * index at the end gives random access to any game.
+ *
+ * File layout (little-endian):
+ *   char[4]  magic "CCGA"
+ *   uint32   version
+ *   uint64   game count
+ *   uint64   offset of the index
+ *   records  per game: Event, Site, Date, Round, White, Black, Result and
+ *            start FEN as uint8 length + bytes, then uint16 ply count and
+ *            one uint8 move index per ply
+ *   uint64   offsets[game count]   start of each record
+ */
+class GameArchive {
+private:
+    MappedFile file;
+    uint64_t gameCount = 0;
+    uint64_t indexOffset = 0;
+
+public:
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 24;
+
+    GameArchive() = default;
+    GameArchive(const GameArchive&) = delete;
+    GameArchive& operator=(const GameArchive&) = delete;
+
+    /**
+     * Maps an archive file and checks its header.
+     * @param filename Path to the archive
+     * @return true if the archive can be read
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmaps the file.
+     */
+    void close();
+
+    /**
+     * Checks whether an archive is open.
+     * @return true after a successful open()
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the number of games in the archive.
+     * @return Game count
+     */
+    uint64_t size() const;
+
+    /**
+     * Reads one game.
+     * @param index Game number (0-based)
+     * @param game Receives the game
+     * @return false if the index is out of range or the record is corrupt
+     */
+    bool read(uint64_t index, ArchivedGame& game) const;
+
+    /**
+     * Generates the legal moves of a position in archive order (by from-square,
+     * then by Move::encode()), with underpromotions as separate moves.
+     * @param board The position
+     * @param side The side to move
+     * @return Legal moves
+     */
+    static std::vector<Move> legalMoves(const Board& board, Color side);
+
+    /**
+     * Converts a parsed PGN game to archive form.
+     * @param pgn Game read by PGNReader
+     * @param game Receives the tags, start position and move indices
+     * @return false if a move could not be resolved
+     */
+    static bool encode(const PGNGame& pgn, ArchivedGame& game);
+
+    /**
+     * Turns stored move indices back into moves.
+     * @param game Archived game
+     * @param moves Receives the moves
+     * @return false if an index is out of range
+     */
+    static bool decode(const ArchivedGame& game, std::vector<Move>& moves);
+
+    /**
+     * Replays an archived game into a Game, e.g. to export it as PGN.
+     * @param archived Archived game
+     * @param game The game object to reset and update
+     * @return true if every move was applied
+     */
+    static bool toGame(const ArchivedGame& archived, Game& game);
+};
+
+/**
+ * Writes a GameArchive file. Records are appended as they come; the offset
+ * index and the header are written by close().
+ */
+class GameArchiveWriter {
+private:
+    std::ofstream file;
+    std::vector<uint64_t> offsets;
+    uint64_t position = 0;
+    std::string record;
+    bool closed = false;
+
+public:
+    /**
+     * Creates (truncates) an archive file.
+     * @param filename Path to the archive
+     */
+    explicit GameArchiveWriter(const std::string& filename);
+
+    /**
+     * Finishes the file if close() was not called.
+     */
+    ~GameArchiveWriter();
+
+    GameArchiveWriter(const GameArchiveWriter&) = delete;
+    GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+    /**
+     * Checks whether the file was created.
+     * @return true if games can be added
+     */
+    bool isOpen() const;
+
+    /**
+     * Appends a game.
+     * @param game The game
+     */
+    void add(const ArchivedGame& game);
+
+    /**
+     * Writes the offset index and the header, then closes the file.
+     * @return false if a write failed
+     */
+    bool close();
+
+    /**
+     * Gets the number of games added.
+     * @return Game count
+     */
+    uint64_t size() const;
+
+    /**
+     * Gets the number of bytes written so far (without the index).
+     * @return Byte count
+     */
+    uint64_t bytesWritten() const;
+};
+
+#endif // GAMEARCHIVE_H
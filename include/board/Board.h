@@ -5,6 +5,11 @@
 #include "board/Square.h"
 #include "pieces/Piece.h"
 #include "enums/Color.h"
+#include "eval/Nnue.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 class Board {
@@ -22,6 +27,14 @@ private:
     bool blackRookH_Moved = false;
     Move* lastMove = nullptr;
 
+    // Incrementally maintained evaluation sums (White minus Black)
+    int midgameScore = 0;
+    int endgameScore = 0;
+    int gamePhase = 0;
+    uint64_t pawnKey = 0;
+    uint64_t pieceKey = 0;
+    NnueAccumulator accumulator{};
+
     /**
      * Helper to check if a move is an en passant capture.
      */
@@ -37,7 +50,39 @@ private:
      */
     bool isPawnPromotion(const Piece* piece, const Square& to) const;
 
+    /**
+     * Removes a piece from its color's piece list (does not free it).
+     */
+    void detachPiece(Piece* piece);
+
+    /**
+     * Puts newPiece on its square in place of oldPiece, fixing the piece
+     * lists and freeing oldPiece. Used for promotion.
+     */
+    void replacePiece(Piece* oldPiece, Piece* newPiece);
+
+    /**
+     * Clears the castling right tied to a king or rook home square when
+     * a piece moves from or to it.
+     */
+    void updateCastlingRights(const Square& square);
+
+    /**
+     * Adds (sign = 1) or removes (sign = -1) a piece's material, PST and
+     * phase contribution, toggles it in the piece key (and the pawn key if it
+     * is a pawn), and
+     * updates the NNUE accumulator when a network is loaded.
+     * Called on every square write.
+     */
+    void updateEvalTerms(const Piece* piece, int file, int rank, int sign);
+
 public:
+    // Castling rights bitmask returned by getCastlingRights()
+    static const int CASTLE_WHITE_KING = 1;
+    static const int CASTLE_WHITE_QUEEN = 2;
+    static const int CASTLE_BLACK_KING = 4;
+    static const int CASTLE_BLACK_QUEEN = 8;
+
     Board();
     Board(const Board& other);
     Board& operator=(const Board& other);
@@ -55,9 +100,76 @@ public:
 
     /**
      * Sets piece at the specified square.
+     * Keeps the incremental evaluation sums in step with the change.
      */
     void setPieceAt(const Square& square, Piece* piece);
 
+    /**
+     * Gets the incremental middlegame material + PST sum (White minus Black).
+     */
+    int getMidgameScore() const;
+
+    /**
+     * Gets the incremental endgame material + PST sum (White minus Black).
+     */
+    int getEndgameScore() const;
+
+    /**
+     * Gets the incremental game phase (24 = all pieces on board, 0 = pawn ending).
+     */
+    int getGamePhase() const;
+
+    /**
+     * Gets the Zobrist key of the pawn placement only (both colors).
+     * Used to index the pawn-structure hash table.
+     */
+    uint64_t getPawnKey() const;
+
+    /**
+     * Gets the Zobrist key of the whole position: piece placement (kept
+     * incrementally), castling rights, en passant file and side to move.
+     * @param sideToMove The side to move
+     * @return 64-bit position key
+     */
+    uint64_t getHashKey(Color sideToMove) const;
+
+    /**
+     * Gets the castling rights still available (king and rook unmoved).
+     * @return Bitmask of CASTLE_* flags
+     */
+    int getCastlingRights() const;
+
+    /**
+     * Replaces the position with one described in Forsyth-Edwards Notation.
+     * The string is validated before the board is touched; on failure the
+     * board is left unchanged. The clock fields may be omitted.
+     * @param fen FEN string, e.g. "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+     * @param sideToMove Receives the side to move
+     * @param halfmoveClock Receives the halfmove clock (0 if omitted)
+     * @param fullmoveNumber Receives the fullmove number (1 if omitted)
+     * @return true if the FEN was valid and loaded
+     */
+    bool loadFen(std::string_view fen, Color& sideToMove, int& halfmoveClock, int& fullmoveNumber);
+
+    /**
+     * Writes the position in Forsyth-Edwards Notation.
+     * @param sideToMove The side to move
+     * @param halfmoveClock Plies since the last capture or pawn move
+     * @param fullmoveNumber Current move number
+     * @return FEN string
+     */
+    std::string toFen(Color sideToMove, int halfmoveClock = 0, int fullmoveNumber = 1) const;
+
+    /**
+     * Gets the incrementally updated NNUE first-layer accumulator.
+     */
+    const NnueAccumulator& getAccumulator() const;
+
+    /**
+     * Recomputes the NNUE accumulator from scratch, e.g. after Nnue::load().
+     */
+    void refreshAccumulator();
+
     /**
      * Checks if a square is within board bounds.
      */
@@ -85,10 +197,12 @@ public:
     Move* getLastMove() const;
 
     /**
-     * Applies a move to the board and returns the captured piece (if any).
-     * Handles regular moves, captures, castling, en passant, and promotion.
+     * Applies a move to the board and returns the type of the captured piece (if any).
+     * Handles regular moves, captures, castling, en passant, and promotion, and
+     * keeps castling rights, the en passant target and the piece lists up to date.
+     * Captured and promoted-away pieces are freed.
      */
-    Piece* applyMove(const Move& move);
+    std::optional<PieceType> applyMove(const Move& move);
 
     /**
      * Checks if a square is attacked by pieces of the specified color.
@@ -114,6 +228,13 @@ public:
 
     bool isLegalMove(const Move& move, Color turn) const;
 
+    /**
+     * Checks whether a pseudo-legal move leaves the mover's king safe, by
+     * looking for attackers around the king with the move's squares overlaid
+     * (cheaper than isLegalMove(), which copies the board).
+     */
+    bool leavesKingSafe(const Move& move, Color turn) const;
+
     bool canCastleKingSide(Color turn) const;
     bool canCastleQueenSide(Color turn) const;
     bool isEnPassantAvailable() const;
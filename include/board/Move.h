@@ -3,7 +3,9 @@
 
 #include "enums/PieceType.h"
 #include "board/Square.h"
+#include <cstdint>
 #include <optional>
+#include <string>
 
 /**
  * Represents a chess move from one square to another.
@@ -54,6 +56,39 @@ public:
      * @return true if this is a promotion move, false otherwise
      */
     bool isPromotion() const;
+
+    /**
+     * Checks equality with another move (squares and promotion).
+     * @param other Move to compare with
+     * @return true if both moves are identical
+     */
+    bool operator==(const Move& other) const;
+
+    /**
+     * Checks inequality with another move.
+     * @param other Move to compare with
+     * @return true if the moves differ
+     */
+    bool operator!=(const Move& other) const;
+
+    /**
+     * Packs the move into 16 bits: from (6) | to (6) | promotion (3).
+     * @return Encoded move, never 0 for a real move
+     */
+    uint16_t encode() const;
+
+    /**
+     * Unpacks a move produced by encode().
+     * @param code Encoded move
+     * @return The decoded move
+     */
+    static Move decode(uint16_t code);
+
+    /**
+     * Converts the move to coordinate notation (e.g., "e2e4", "e7e8q").
+     * @return Coordinate notation string
+     */
+    std::string toString() const;
 };
 
 #endif // MOVE_H
\ No newline at end of file
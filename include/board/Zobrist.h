@@ -0,0 +1,50 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "enums/Color.h"
+#include "enums/PieceType.h"
+
+/**
+ * Fixed pseudo-random keys for Zobrist hashing of board positions.
+ * Keys are generated once from a constant seed, so hashes are stable
+ * across runs and can be stored on disk.
+ */
+class Zobrist {
+private:
+    // Private constructor to prevent instantiation
+    Zobrist() = delete;
+
+public:
+    /**
+     * Gets the key for a piece of the given type and color on a square.
+     * @param type The piece type
+     * @param color The piece color
+     * @param file The file (0-7)
+     * @param rank The rank (0-7)
+     * @return 64-bit key
+     */
+    static uint64_t pieceKey(PieceType type, Color color, int file, int rank);
+
+    /**
+     * Gets the key XOR-ed in when Black is to move.
+     * @return 64-bit key
+     */
+    static uint64_t sideKey();
+
+    /**
+     * Gets the key for a set of castling rights.
+     * @param rights Bitmask of Board::CASTLE_* flags (0-15)
+     * @return 64-bit key
+     */
+    static uint64_t castlingKey(int rights);
+
+    /**
+     * Gets the key for an en passant target on the given file.
+     * @param file The file (0-7)
+     * @return 64-bit key
+     */
+    static uint64_t enPassantKey(int file);
+};
+
+#endif // ZOBRIST_H
@@ -0,0 +1,32 @@
+#ifndef BOOKBUILDER_H
+#define BOOKBUILDER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Builds an OpeningBook file from PGN game collections.
+ *
+ * Games are streamed with PGNReader and replayed through PGNHandler/MoveParser;
+ * each of a game's first
+ * plies is counted for the side that played it: a win adds 2 to the move's
+ * weight, a draw or unknown result 1, a loss nothing. Moves that never scored
+ * are left out, and weights are scaled per position to fit 16 bits.
+ */
+class BookBuilder {
+private:
+    // Private constructor to prevent instantiation
+    BookBuilder() = delete;
+
+public:
+    /**
+     * Builds a book and writes it sorted by key.
+     * @param pgnFiles PGN files to read
+     * @param bookFile Output book file
+     * @param maxPlies Number of plies per game to include
+     * @return Process exit code (0 on success)
+     */
+    static int build(const std::vector<std::string>& pgnFiles, const std::string& bookFile, int maxPlies);
+};
+
+#endif // BOOKBUILDER_H
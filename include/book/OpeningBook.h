@@ -0,0 +1,118 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "enums/Color.h"
+#include "util/MappedFile.h"
+
+/**
+ * A move stored in the opening book with its weight.
+ */
+struct BookEntry {
+    Move move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+/**
+ * Polyglot opening book: 16-byte records sorted by key, all fields
+ * big-endian, with no file header:
+ *   uint64 key, uint16 move, uint16 weight, uint32 learn
+ * Keys are Polyglot hashes (the Random64 table over pieces, castling rights,
+ * the en passant file when a capture is possible, and White to move), and
+ * moves use Polyglot's encoding (to file, to rank, from file, from rank,
+ * promotion in 3-bit fields; castling written as king takes own rook), so
+ * standard .bin books can be used and books from BookBuilder work in other
+ * programs.
+ *
+ * The file is memory-mapped and positions are found by binary search.
+ */
+class OpeningBook {
+private:
+    static MappedFile file;
+    static size_t entryCount;
+
+    /**
+     * Reads the key of the record at an index.
+     */
+    static uint64_t keyAt(size_t index);
+
+    // Private constructor to prevent instantiation
+    OpeningBook() = delete;
+
+public:
+    static const size_t ENTRY_SIZE = 16;
+
+    /**
+     * Maps a book file, replacing any loaded book.
+     * @param filename Path to the book
+     * @return true if the file was mapped and has a valid size
+     */
+    static bool load(const std::string& filename);
+
+    /**
+     * Unmaps the book.
+     */
+    static void unload();
+
+    /**
+     * Checks whether a book is loaded.
+     * @return true if probes can return moves
+     */
+    static bool isLoaded();
+
+    /**
+     * Gets the number of records in the book.
+     * @return Record count
+     */
+    static size_t size();
+
+    /**
+     * Gets the Polyglot key of a position.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @return 64-bit key
+     */
+    static uint64_t key(const Board& board, Color sideToMove);
+
+    /**
+     * Finds the legal book moves for a position.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @return Entries in file order (empty if the position is not in the book)
+     */
+    static std::vector<BookEntry> probe(const Board& board, Color sideToMove);
+
+    /**
+     * Picks a book move at random with probability proportional to its weight.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @param rng Random number generator
+     * @return The move, or empty if the position is not in the book
+     */
+    static std::optional<Move> pickMove(const Board& board, Color sideToMove, std::mt19937& rng);
+
+    /**
+     * Packs a move in the Polyglot encoding.
+     * @param board Position before the move (to recognise castling)
+     * @param move The move
+     * @return Encoded move
+     */
+    static uint16_t encodeMove(const Board& board, const Move& move);
+
+    /**
+     * Unpacks a Polyglot move, turning "king takes rook" back into castling.
+     * @param board Position before the move
+     * @param code Encoded move
+     * @return The move
+     */
+    static Move decodeMove(const Board& board, uint16_t code);
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,84 @@
+#ifndef BATCHSESSION_H
+#define BATCHSESSION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "engine/Search.h"
+#include "engine/TranspositionTable.h"
+#include "enums/Color.h"
+
+/**
+ * Headless command mode for scripts ("chess --batch"). Every input line is
+ * one command on a current position, and every command is answered with
+ * one line of JSON, in order:
+ *
+ *   fen <fen>                      set the position
+ *   startpos                       set the start position
+ *   moves <m1> <m2> ...            play moves (coordinate notation or SAN)
+ *   fen                            print the position as FEN
+ *   legal moves                    list the legal moves
+ *   is check|checkmate|stalemate   test the position
+ *   status                         side to move, check/mate/stalemate, move count
+ *   eval                           static evaluation for the side to move
+ *   best move [depth n] [nodes n] [time ms]   search the position
+ *   perft <depth>                  count move-tree leaves
+ *
+ * run() reads whatever the pipe holds, answers every complete line into one
+ * buffer and writes it with a single flush, so a script streaming thousands
+ * of commands is not slowed down by per-line writes, while one sending a
+ * command and waiting still gets its answer at once.
+ */
+class BatchSession {
+private:
+    Board board;
+    Color sideToMove;
+    int halfmoveClock;
+    int fullmoveNumber;
+    TranspositionTable table;
+    Search search;
+
+    /**
+     * Finds a legal move given in coordinate notation or SAN.
+     * @param text The move
+     * @param legal Legal moves of the current position
+     * @return The move, or empty if it is not legal
+     */
+    std::optional<Move> findMove(std::string_view text, const std::vector<Move>& legal) const;
+
+    /**
+     * Plays a legal move and updates the side to move and move counters.
+     * @param move The move
+     */
+    void play(const Move& move);
+
+public:
+    static const size_t READ_SIZE = 1 << 16;
+    static const int DEFAULT_DEPTH = 4;
+
+    /**
+     * Creates a session at the start position.
+     */
+    BatchSession();
+
+    BatchSession(const BatchSession&) = delete;
+    BatchSession& operator=(const BatchSession&) = delete;
+
+    /**
+     * Executes one command.
+     * @param line The command (without the newline)
+     * @param out Receives one line of JSON, newline included (nothing for blank or '#' lines)
+     */
+    void execute(std::string_view line, std::string& out);
+
+    /**
+     * Answers commands from stdin on stdout until end of input.
+     * @return Process exit code
+     */
+    int run();
+};
+
+#endif // BATCHSESSION_H
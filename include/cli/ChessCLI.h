@@ -1,7 +1,13 @@
 #ifndef CHESSCLI_H
 #define CHESSCLI_H
 
+#include <cstdint>
+#include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include "engine/Search.h"
+#include "engine/TranspositionTable.h"
 #include "game/Game.h"
 #include "timer/Timer.h"
 
@@ -13,6 +19,20 @@ class ChessCLI {
 private:
     Game* game;
     Timer* timer;
+    TranspositionTable table;
+    std::optional<Color> engineColor;
+    std::string lastEngineMove;
+    std::mt19937 bookRng;  // varies the computer's book choices between games
+
+    // Pondering: the engine searches its reply to the expected move while the
+    // player is typing.
+    bool ponderEnabled;
+    std::optional<Move> ponderMove;
+    uint64_t ponderKey;
+    Search* ponderSearch;
+    SearchResult ponderResult;
+    std::thread ponderThread;
+    bool ponderHit;
 
     /**
      * Displays the main menu and handles menu selection.
@@ -24,6 +44,60 @@ private:
      */
     void startNewGame();
 
+    /**
+     * Starts a new game against the engine after asking for the player's color.
+     */
+    void startEngineGame();
+
+    /**
+     * Lets the engine search the current position and play its move,
+     * using a time budget taken from the engine's clock.
+     */
+    void playEngineMove();
+
+    /**
+     * Prints the engine's best lines for the current position.
+     * @param lines Number of lines to show
+     */
+    void analyzePosition(int lines);
+
+    /**
+     * Searches for a forced mate for the player to move.
+     * @param moves Largest number of moves to try
+     * @param allMoves true to try quiet attacker moves as well as checks
+     */
+    void solveMate(int moves, bool allMoves);
+
+    /**
+     * Lists the moves played from the current position in the position
+     * database, with their results and the most played reply to each.
+     */
+    void explorePosition();
+
+    /**
+     * Suggests a move for the player to move: the tablebase move when the
+     * position is covered, otherwise the result of a short search.
+     */
+    void showHint();
+
+    /**
+     * Starts searching the position after the expected reply on a background
+     * thread, if pondering is enabled and a reply was predicted.
+     */
+    void startPondering();
+
+    /**
+     * Checks the player's move against the ponder move: on a hit the ponder
+     * search gets the engine's time budget and keeps running, otherwise it is
+     * stopped.
+     */
+    void resolvePondering();
+
+    /**
+     * Stops and joins the ponder search, discarding its result.
+     */
+    void stopPondering();
+
     /**
      * Loads a game from a PGN file.
      * NOTE: This function requires PGNParser implementation.
@@ -69,7 +143,6 @@ private:
 
     /**
      * Saves the current game to a PGN file.
-     * NOTE: This function requires PGNExporter implementation.
      */
     void saveGame();
 
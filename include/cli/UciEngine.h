@@ -0,0 +1,128 @@
+#ifndef UCIENGINE_H
+#define UCIENGINE_H
+
+#include <condition_variable>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "board/Board.h"
+#include "engine/Search.h"
+#include "engine/TimeManager.h"
+#include "engine/TranspositionTable.h"
+#include "enums/Color.h"
+
+/**
+ * Universal Chess Interface front end ("chess --uci"), so the engine can be
+ * driven by chess GUIs and tournament managers instead of the menu.
+ *
+ * The thread that calls run() only reads and handles commands; every "go"
+ * starts the search on its own thread and returns at once. "stop",
+ * "ponderhit" and "isready" are therefore answered while the engine is
+ * thinking, and since the search polls its stop flag at every node, the
+ * best move follows a "stop" almost immediately.
+ *
+ * With Threads > 1 the extra threads run the same search on the shared
+ * transposition table (lazy SMP), every other one starting a ply deeper;
+ * the table is aged once per "go", and the move and the info lines come
+ * from the first thread.
+ */
+class UciEngine {
+private:
+    TranspositionTable table;
+    int threads;
+    Board board;
+    Color sideToMove;
+
+    std::mutex outputLock;
+
+    // State of the running search, guarded by searchLock.
+    std::mutex searchLock;
+    std::condition_variable released;
+    std::vector<std::unique_ptr<Search>> searches;
+    std::thread searchThread;
+    bool holdBestMove;       // "go infinite"/"go ponder": wait for stop or ponderhit
+    TimeBudget ponderBudget; // deadlines applied on ponderhit
+
+    /**
+     * Writes one line to stdout and flushes it.
+     * @param line Text without the newline
+     */
+    void send(const std::string& line);
+
+    /**
+     * Handles "position [startpos | fen <fen>] [moves <m1> <m2> ...]".
+     * @param args The words after "position"
+     */
+    void setPosition(std::istringstream& args);
+
+    /**
+     * Handles "go" and starts the search thread.
+     * @param args The words after "go"
+     */
+    void go(std::istringstream& args);
+
+    /**
+     * Handles "setoption name <name> [value <value>]".
+     * @param args The words after "setoption"
+     */
+    void setOption(std::istringstream& args);
+
+    /**
+     * Runs on the search thread: searches, waits for stop or ponderhit if
+     * the search must not end on its own, then prints the best move.
+     */
+    void think(Board position, Color side, SearchLimits limits);
+
+    /**
+     * Stops all search threads and releases a held best move. Thread safe.
+     */
+    void stop();
+
+    /**
+     * Gives a ponder search its real deadlines. Thread safe.
+     */
+    void ponderHit();
+
+    /**
+     * Stops the current search (if any) and waits for its best move.
+     */
+    void finishSearch();
+
+    /**
+     * Formats an "info" line for a completed iteration.
+     * @param result The iteration's result
+     * @return The line
+     */
+    std::string infoLine(const SearchResult& result) const;
+
+public:
+    static const int DEFAULT_HASH_MB = 16;
+    static const int MAX_HASH_MB = 4096;
+    static const int MAX_THREADS = 256;
+
+    /**
+     * Creates an engine at the start position with default options.
+     */
+    UciEngine();
+
+    UciEngine(const UciEngine&) = delete;
+    UciEngine& operator=(const UciEngine&) = delete;
+
+    /**
+     * Stops a running search.
+     */
+    ~UciEngine();
+
+    /**
+     * Reads and executes commands until "quit" or end of input.
+     * @param input Command stream (normally std::cin)
+     * @return Process exit code
+     */
+    int run(std::istream& input);
+};
+
+#endif // UCIENGINE_H
@@ -0,0 +1,125 @@
+#ifndef POSITIONDATABASE_H
+#define POSITIONDATABASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "enums/Color.h"
+#include "util/MappedFile.h"
+
+/**
+ * A move played from a database position with the results of the games
+ * that played it. Games with an unknown result count in games only.
+ */
+struct PositionMove {
+    Move move;
+    uint32_t games;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+};
+
+/**
+ * One record of a position database: a (position, move) pair and its
+ * counters. Used as the in-memory form by PositionDbBuilder.
+ */
+struct PositionRecord {
+    uint64_t key;
+    uint16_t move;
+    uint32_t games;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+};
+
+/**
+ * Read-only position database built by PositionDbBuilder: for every position
+ * reached in a game collection, the moves played from it and their results.
+ *
+ * File layout (little-endian):
+ *   char[4]  magic "CCPD"
+ *   uint32   version
+ *   uint64   record count
+ *   records  ENTRY_SIZE bytes each, sorted by key then move:
+ *            uint64 key (Board::getHashKey), uint16 move (Move::encode),
+ *            uint16 reserved, uint32 games, white wins, draws, black wins
+ *
+ * The file is memory-mapped and positions are found by binary search, so a
+ * lookup touches a few pages however large the database is.
+ */
+class PositionDatabase {
+private:
+    static MappedFile file;
+    static size_t recordCount;
+
+    /**
+     * Reads the key of the record at an index.
+     */
+    static uint64_t keyAt(size_t index);
+
+    // Private constructor to prevent instantiation
+    PositionDatabase() = delete;
+
+public:
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t ENTRY_SIZE = 28;
+
+    /**
+     * Maps a database file, replacing any loaded database.
+     * @param filename Path to the database
+     * @return true if the file was mapped and its header is valid
+     */
+    static bool load(const std::string& filename);
+
+    /**
+     * Unmaps the database.
+     */
+    static void unload();
+
+    /**
+     * Checks whether a database is loaded.
+     * @return true if probes can return moves
+     */
+    static bool isLoaded();
+
+    /**
+     * Gets the number of (position, move) records.
+     * @return Record count
+     */
+    static size_t size();
+
+    /**
+     * Finds the moves played from a position.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @return Moves, most played first (empty if the position is not in the database)
+     */
+    static std::vector<PositionMove> probe(const Board& board, Color sideToMove);
+
+    /**
+     * Serializes a record in the file layout.
+     * @param record The record
+     * @param out Receives ENTRY_SIZE bytes
+     */
+    static void writeRecord(const PositionRecord& record, char* out);
+
+    /**
+     * Deserializes a record.
+     * @param data ENTRY_SIZE bytes in the file layout
+     * @return The record
+     */
+    static PositionRecord readRecord(const char* data);
+
+    /**
+     * Builds the file header.
+     * @param count Number of records that follow
+     * @param out Receives HEADER_SIZE bytes
+     */
+    static void writeHeader(uint64_t count, char* out);
+};
+
+#endif // POSITIONDATABASE_H
@@ -0,0 +1,41 @@
+#ifndef POSITIONDBBUILDER_H
+#define POSITIONDBBUILDER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Builds a PositionDatabase file from PGN game collections.
+ *
+ * Games are replayed in parallel through PGNPipeline. Each worker collects
+ * (position, move, result) records in its own buffer, adding a game's
+ * records only after the whole game has replayed, so a game with a bad move
+ * adds none. When the buffer reaches its share of the memory limit it is
+ * sorted, equal records are summed, and the result is written to a
+ * temporary run file next to the output. The runs are then merged with a k-way merge (in several passes if
+ * there are more than MERGE_WAYS of them), so the database can be much
+ * larger than the memory used to build it.
+ */
+class PositionDbBuilder {
+private:
+    // Private constructor to prevent instantiation
+    PositionDbBuilder() = delete;
+
+public:
+    static const size_t MERGE_WAYS = 64;
+
+    /**
+     * Builds a database and writes it sorted by key and move.
+     * @param pgnFiles PGN files to read
+     * @param dbFile Output database file
+     * @param threads Worker threads (0 = one per core)
+     * @param maxPlies Number of plies per game to include (0 = all)
+     * @param memoryMb Memory for the record buffers of all workers, in MiB
+     * @return Process exit code (0 on success)
+     */
+    static int build(const std::vector<std::string>& pgnFiles, const std::string& dbFile, int threads,
+                     int maxPlies, size_t memoryMb);
+};
+
+#endif // POSITIONDBBUILDER_H
@@ -0,0 +1,88 @@
+#ifndef MATESOLVER_H
+#define MATESOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "enums/Color.h"
+
+/**
+ * Result of a mate search.
+ */
+struct MateResult {
+    bool found = false;
+    int mateIn = 0;              // attacker moves to mate (0 if not found)
+    std::vector<Move> line;      // key move, then the longest defence and mating replies
+    uint64_t nodes = 0;
+    uint64_t hashHits = 0;
+    int64_t timeMs = 0;
+};
+
+/**
+ * Solves "mate in N" problems with an iterative-deepening AND/OR search.
+ *
+ * The attacker needs one move after which every defence still allows mate
+ * within the remaining moves; by default only checking moves are tried for
+ * the attacker, which makes direct-mate problems with checking solutions
+ * very cheap. Proven and refuted (position, moves left) pairs are kept in
+ * the solver's own hash table, separate from the engine's.
+ */
+class MateSolver {
+private:
+    struct Entry {
+        uint64_t key = 0;
+        int8_t proven = 0;     // mates in this many moves (0 = unknown)
+        int8_t refuted = 0;    // no mate within this many moves
+    };
+
+    std::vector<Entry> table;
+    uint64_t nodes = 0;
+    uint64_t hashHits = 0;
+    bool checksOnly = true;
+
+    /**
+     * Gets the hash slot for a position.
+     */
+    Entry& slot(uint64_t key);
+
+    /**
+     * Checks whether the attacker to move mates within the given moves.
+     */
+    bool attack(const Board& board, Color attacker, int moves);
+
+    /**
+     * Checks whether every defence (defender to move) allows mate within the
+     * given attacker moves.
+     */
+    bool defend(const Board& board, Color defender, int moves);
+
+    /**
+     * Gets the attacker's candidate moves, checks first.
+     */
+    std::vector<Move> attackerMoves(const Board& board, Color attacker);
+
+public:
+    // Largest N accepted by the "mate" commands; solve() itself stops at
+    // INT8_MAX, the most moves its table entries can hold.
+    static const int MAX_MOVES = 10;
+
+    /**
+     * Creates a solver with a hash table of roughly the given size.
+     * @param megabytes Table size in MiB
+     */
+    explicit MateSolver(size_t megabytes = 16);
+
+    /**
+     * Searches for the shortest mate up to a number of moves.
+     * @param board The position
+     * @param attacker The side to move, which is to give mate
+     * @param maxMoves Largest N to try (values above INT8_MAX are treated as INT8_MAX)
+     * @param onlyChecks true to try only checking moves for the attacker
+     * @return The solution, if any, and search statistics
+     */
+    MateResult solve(const Board& board, Color attacker, int maxMoves, bool onlyChecks = true);
+};
+
+#endif // MATESOLVER_H
@@ -0,0 +1,164 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "engine/TimeManager.h"
+#include "engine/TranspositionTable.h"
+#include "enums/Color.h"
+
+/**
+ * Limits for one search. Zero means "no limit" for nodes and time.
+ */
+struct SearchLimits {
+    int depth = 64;       // Search::MAX_DEPTH
+    uint64_t nodes = 0;
+    TimeBudget time;
+    bool ponder = false;  // clock and stop flag are owned by the caller, see Search::ponderHit
+    std::vector<Move> excludedRootMoves;  // root moves to skip (multi-PV)
+    bool newSearch = true;  // age the table; false when the caller did it for several threads
+    int startDepth = 1;     // first iteration (helper threads start deeper)
+};
+
+/**
+ * Result of a completed iteration (also passed to the info callback).
+ */
+struct SearchResult {
+    std::optional<Move> bestMove;
+    std::vector<Move> pv;
+    int score = 0;        // centipawns from the side to move, or mate score
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+};
+
+/**
+ * Iterative-deepening alpha-beta (PVS) search with quiescence, a shared
+ * transposition table and time control through TimeManager.
+ * Positions are searched by copy-make on Board, the same way move legality
+ * is checked elsewhere in the program.
+ */
+class Search {
+private:
+    TranspositionTable& table;
+    TimeManager timeManager;
+    std::atomic<bool> stopRequested{false};
+    SearchLimits limits;
+    uint64_t nodes = 0;
+    std::vector<uint64_t> keyStack;
+    uint16_t killers[64][2] = {};
+    int history[2][64][64] = {};
+    std::function<void(const SearchResult&)> infoCallback;
+
+    /**
+     * Checks the stop flag every node and the clock/node limits every 1024 nodes.
+     */
+    bool shouldStop();
+
+    int searchRoot(const Board& board, Color side, int depth, int alpha, int beta,
+                   std::optional<Move>& bestMove);
+    int negamax(const Board& board, Color side, int depth, int alpha, int beta, int ply);
+    int quiescence(const Board& board, Color side, int alpha, int beta, int ply);
+
+    /**
+     * Generates pseudo-legal moves ordered best-first (TT move, captures by
+     * MVV-LVA, promotions, killers, history).
+     */
+    std::vector<Move> orderedMoves(const Board& board, Color side, uint16_t ttMove, int ply,
+                                   bool capturesOnly) const;
+
+    bool isRepetition(uint64_t key) const;
+    bool isExcluded(const Move& move) const;
+    std::vector<Move> extractPv(const Board& board, Color side, int maxLength) const;
+
+public:
+    static const int MAX_DEPTH = 64;
+    static const int INFINITE_SCORE = 32000;
+    static const int MATE_SCORE = 30000;
+
+    /**
+     * Creates a search that uses the given transposition table.
+     * @param table Table shared with other searches (must outlive this object)
+     */
+    explicit Search(TranspositionTable& table);
+
+    /**
+     * Searches a position until a limit is reached or stop() is called.
+     * A ponder search runs without deadlines until stop() or ponderHit(), and
+     * does not clear a stop() that arrived before it started, so it can be
+     * launched on another thread without racing the caller.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @param limits Depth/node/time limits
+     * @return Result of the deepest completed iteration
+     */
+    SearchResult run(const Board& board, Color sideToMove, const SearchLimits& limits);
+
+    /**
+     * Searches the best lines of a position one after another. Each line is a
+     * full search with the moves of the previous lines excluded at the root,
+     * and all lines share the transposition table.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @param limits Limits applied to each line separately
+     * @param lines Number of lines wanted
+     * @return Up to `lines` results, best score first
+     */
+    std::vector<SearchResult> runMultiPv(const Board& board, Color sideToMove,
+                                         const SearchLimits& limits, int lines);
+
+    /**
+     * Asks a running search to stop as soon as possible. Thread safe.
+     */
+    void stop();
+
+    /**
+     * Turns a ponder search (limits.ponder) into a normal timed search once
+     * the predicted move was played. The search keeps its tree and table
+     * entries; only the deadlines change. Thread safe.
+     * @param budget Time for the move, measured from now
+     */
+    void ponderHit(const TimeBudget& budget);
+
+    /**
+     * Sets a function called after every completed iteration.
+     * @param callback Receives the iteration's result
+     */
+    void setInfoCallback(std::function<void(const SearchResult&)> callback);
+
+    /**
+     * Gets the time manager of this search (e.g. to move its deadlines).
+     * @return Reference to the time manager
+     */
+    TimeManager& getTimeManager();
+
+    /**
+     * Generates all legal moves for a side.
+     * @param board The position
+     * @param side The side to move
+     * @return Legal moves
+     */
+    static std::vector<Move> generateLegalMoves(const Board& board, Color side);
+
+    /**
+     * Checks whether a side's king is attacked.
+     * @param board The position
+     * @param side The side whose king to test
+     * @return true if in check
+     */
+    static bool isInCheck(const Board& board, Color side);
+
+    /**
+     * Checks whether a score means forced mate.
+     * @param score Search score
+     * @return true for mate scores
+     */
+    static bool isMateScore(int score);
+};
+
+#endif // SEARCH_H
@@ -0,0 +1,99 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <atomic>
+#include <cstdint>
+#include "enums/Color.h"
+
+class Timer;
+
+/**
+ * Thinking time for one move. A limit of 0 means "no limit".
+ */
+struct TimeBudget {
+    int softMs = 0;  // don't start a new iteration after this
+    int hardMs = 0;  // abort the search at this point
+};
+
+/**
+ * Allocates thinking time from the game clock and tracks the deadlines of
+ * the running search. The hard deadline is an atomic so the search can poll
+ * it cheaply and another thread (e.g. on a ponder hit) can move it.
+ */
+class TimeManager {
+private:
+    static const int64_t NO_DEADLINE = INT64_MAX;
+
+    std::atomic<int64_t> startTime{0};
+    std::atomic<int64_t> softDeadline{NO_DEADLINE};
+    std::atomic<int64_t> hardDeadline{NO_DEADLINE};
+
+public:
+    /**
+     * Safety margin kept on the clock for move transmission and output.
+     */
+    static const int MOVE_OVERHEAD_MS = 50;
+
+    /**
+     * Computes soft and hard budgets from the remaining clock time.
+     * @param remainingMs Time left on the mover's clock
+     * @param incrementMs Increment gained after the move
+     * @param movesToGo Moves until the next time control (0 = sudden death)
+     * @return The budget for this move
+     */
+    static TimeBudget allocate(int remainingMs, int incrementMs, int movesToGo = 0);
+
+    /**
+     * Computes the budget for a side from a running game Timer.
+     * @param timer The game clock
+     * @param side The side to move
+     * @return The budget for this move
+     */
+    static TimeBudget fromTimer(const Timer& timer, Color side);
+
+    /**
+     * Gets a monotonic timestamp.
+     * @return Milliseconds since an arbitrary epoch
+     */
+    static int64_t nowMs();
+
+    /**
+     * Starts the clock for a search with the given budget.
+     * @param budget Soft/hard limits (0 = unlimited)
+     */
+    void start(const TimeBudget& budget);
+
+    /**
+     * Replaces the deadlines, measured from now. Used when a ponder search
+     * turns into a real search.
+     * @param budget Soft/hard limits (0 = unlimited)
+     */
+    void restart(const TimeBudget& budget);
+
+    /**
+     * Checks whether the hard deadline has passed.
+     * @return true if the search must stop now
+     */
+    bool hardLimitReached() const;
+
+    /**
+     * Checks whether the soft deadline has passed.
+     * @return true if no new iteration should be started
+     */
+    bool softLimitReached() const;
+
+    /**
+     * Predicts whether another iteration can finish before the soft deadline,
+     * assuming it takes at least as long as everything searched so far.
+     * @return true if a new iteration should be started
+     */
+    bool nextIterationFits() const;
+
+    /**
+     * Gets the time since start() or restart().
+     * @return Elapsed milliseconds
+     */
+    int64_t elapsedMs() const;
+};
+
+#endif // TIMEMANAGER_H
@@ -0,0 +1,92 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Kind of score stored in a transposition table entry.
+ */
+enum class Bound : uint8_t {
+    NONE,
+    EXACT,
+    LOWER,  // score is a lower bound (fail high)
+    UPPER   // score is an upper bound (fail low)
+};
+
+/**
+ * Unpacked transposition table entry.
+ */
+struct TTEntry {
+    uint16_t move = 0;  // Move::encode(), 0 if none
+    int16_t score = 0;
+    int8_t depth = 0;
+    Bound bound = Bound::NONE;
+};
+
+/**
+ * Hash table of search results keyed by Board::getHashKey().
+ * Each slot stores (key ^ data, data) as two relaxed atomics, so torn writes
+ * from concurrent searches are detected instead of returning garbage; the
+ * table can be shared between threads without locks.
+ */
+class TranspositionTable {
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};  // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slotCount = 0;
+    std::atomic<uint8_t> generation{0};  // read by every searching thread
+
+public:
+    /**
+     * Creates a table of roughly the given size.
+     * @param megabytes Table size in MiB
+     */
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    /**
+     * Reallocates the table, discarding its contents.
+     * @param megabytes Table size in MiB
+     */
+    void resize(size_t megabytes);
+
+    /**
+     * Empties every slot.
+     */
+    void clear();
+
+    /**
+     * Marks the start of a new search so older entries are replaced first.
+     * Threads sharing one search call it once, before any of them starts.
+     */
+    void newSearch();
+
+    /**
+     * Looks up a position.
+     * @param key Position key
+     * @param entry Receives the entry on a hit
+     * @return true if a matching entry was found
+     */
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    /**
+     * Stores a search result, keeping deeper entries from the current search.
+     * @param key Position key
+     * @param entry The entry to store
+     */
+    void store(uint64_t key, const TTEntry& entry);
+
+    /**
+     * Estimates how full the table is from a sample of slots.
+     * @return Used slots per thousand
+     */
+    int hashfull() const;
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,129 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "enums/Color.h"
+#include "enums/PieceType.h"
+#include "eval/PawnHashTable.h"
+
+class Board;
+
+/**
+ * Tapered piece-square-table evaluation.
+ * Material and PST sums are kept incrementally inside Board, so evaluate()
+ * only blends the middlegame and endgame totals by the current game phase.
+ * Pawn-structure terms (doubled, isolated, backward, passed) are cached in a
+ * per-thread pawn hash table keyed by Board::getPawnKey().
+ * All scores are in centipawns.
+ */
+class Evaluator {
+private:
+    static bool verification;
+
+    // Private constructor to prevent instantiation
+    Evaluator() = delete;
+
+public:
+    /**
+     * Game phase of the starting position (4 minors, 4 rooks, 2 queens).
+     */
+    static const int MAX_PHASE = 24;
+
+    /**
+     * Gets the middlegame value (material + PST) of a piece on a square.
+     * @param type The piece type
+     * @param color The piece color
+     * @param file The file (0-7)
+     * @param rank The rank (0-7)
+     * @return Middlegame score from the piece owner's point of view
+     */
+    static int midgameValue(PieceType type, Color color, int file, int rank);
+
+    /**
+     * Gets the endgame value (material + PST) of a piece on a square.
+     * @param type The piece type
+     * @param color The piece color
+     * @param file The file (0-7)
+     * @param rank The rank (0-7)
+     * @return Endgame score from the piece owner's point of view
+     */
+    static int endgameValue(PieceType type, Color color, int file, int rank);
+
+    /**
+     * Gets the phase weight a piece type contributes (N/B=1, R=2, Q=4).
+     * @param type The piece type
+     * @return Phase weight
+     */
+    static int phaseWeight(PieceType type);
+
+    /**
+     * Evaluates the position with the active evaluator: the NNUE network if
+     * one is loaded, otherwise the PST evaluation.
+     * In verification mode the incremental state is cross-checked against a
+     * full recompute.
+     * @param board The board to evaluate
+     * @param sideToMove The side whose point of view the score is returned from
+     * @return Score in centipawns, positive when sideToMove is better
+     * @throws std::logic_error in verification mode if the sums are out of sync
+     */
+    static int evaluate(const Board& board, Color sideToMove);
+
+    /**
+     * Evaluates the position from the incrementally maintained PST sums
+     * plus the cached pawn-structure terms.
+     * @param board The board to evaluate
+     * @param sideToMove The side whose point of view the score is returned from
+     * @return Score in centipawns, positive when sideToMove is better
+     */
+    static int evaluatePst(const Board& board, Color sideToMove);
+
+    /**
+     * Evaluates the PST position by scanning every square (no incremental state).
+     * @param board The board to evaluate
+     * @param sideToMove The side whose point of view the score is returned from
+     * @return Score in centipawns, positive when sideToMove is better
+     */
+    static int evaluateFull(const Board& board, Color sideToMove);
+
+    /**
+     * Computes the pawn-structure terms and passed-pawn masks from scratch.
+     * @param board The board to analyse
+     * @return Entry keyed by the board's pawn key
+     */
+    static PawnEntry evaluatePawns(const Board& board);
+
+    /**
+     * Gets the pawn-structure entry for a board, using the calling thread's
+     * pawn hash table and filling it on a miss.
+     * @param board The board to analyse
+     * @return The cached or freshly computed entry
+     */
+    static PawnEntry probePawns(const Board& board);
+
+    /**
+     * Gets the calling thread's pawn hash table.
+     * @return Reference to the thread-local table
+     */
+    static PawnHashTable& pawnTable();
+
+    /**
+     * Checks that the board's incremental sums match a full recompute.
+     * @param board The board to check
+     * @return true if midgame, endgame, phase, pawn key and (when a network
+     *         is loaded) the NNUE accumulator all agree
+     */
+    static bool verify(const Board& board);
+
+    /**
+     * Enables or disables full-recompute verification inside evaluate().
+     * @param enabled true to verify every evaluation
+     */
+    static void setVerification(bool enabled);
+
+    /**
+     * Checks whether verification mode is enabled.
+     * @return true if evaluate() cross-checks against a full recompute
+     */
+    static bool isVerificationEnabled();
+};
+
+#endif // EVALUATOR_H
@@ -0,0 +1,126 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "enums/Color.h"
+#include "enums/PieceType.h"
+#include "util/MappedFile.h"
+
+class Board;
+
+/**
+ * First-layer outputs for both perspectives, kept inside Board and updated
+ * incrementally by adding or subtracting one weight column per square write.
+ */
+struct NnueAccumulator {
+    alignas(32) int16_t values[2][64];  // [perspective][hidden], HIDDEN = 64
+};
+
+/**
+ * Small efficiently-updatable network: 768 piece-square features per
+ * perspective -> 64 hidden units (clipped ReLU) -> 1 output.
+ *
+ * Weights are memory-mapped from a binary file with this little-endian layout:
+ *   char[4]  magic "CCNN"
+ *   uint32   version (1)
+ *   uint32   hidden size (must be 64)
+ *   uint32   output scale (score = raw / scale)
+ *   int16    featureWeights[768][64]
+ *   int16    featureBias[64]
+ *   int16    outputWeights[2][64]   (side to move first)
+ *   int32    outputBias
+ *
+ * Vector code uses GCC/Clang vector extensions, so it compiles to SSE/AVX2 or
+ * NEON depending on the target; other compilers use the scalar loops.
+ */
+class Nnue {
+private:
+    static const int16_t* featureWeights;
+    static const int16_t* featureBias;
+    static const int16_t* outputWeights;
+    static int32_t outputBias;
+    static int32_t outputScale;
+    static MappedFile weightsFile;
+
+    // Private constructor to prevent instantiation
+    Nnue() = delete;
+
+public:
+    static const int HIDDEN = 64;
+    static const int FEATURES = 768;
+    static const uint32_t VERSION = 1;
+
+    /**
+     * Memory-maps a weights file and makes it the active network.
+     * Boards created earlier must call Board::refreshAccumulator().
+     * @param filename Path to the weights file
+     * @return true if the file was mapped and its header is valid
+     */
+    static bool load(const std::string& filename);
+
+    /**
+     * Unmaps the active network. Evaluation falls back to PST.
+     */
+    static void unload();
+
+    /**
+     * Checks whether a network is loaded.
+     * @return true if load() succeeded
+     */
+    static bool isLoaded();
+
+    /**
+     * Writes a weights file with small deterministic pseudo-random weights.
+     * Useful for exercising the pipeline until trained weights are available.
+     * @param filename Path to write
+     * @param seed Random seed
+     * @return true on success
+     */
+    static bool writeRandomWeights(const std::string& filename, unsigned seed);
+
+    /**
+     * Adds (sign = 1) or subtracts (sign = -1) a piece's feature columns
+     * from both perspectives of an accumulator.
+     * @param acc The accumulator to update
+     * @param type The piece type
+     * @param color The piece color
+     * @param file The file (0-7)
+     * @param rank The rank (0-7)
+     * @param sign 1 to add, -1 to remove
+     */
+    static void update(NnueAccumulator& acc, PieceType type, Color color, int file, int rank, int sign);
+
+    /**
+     * Builds an accumulator from scratch by scanning the board.
+     * @param board The board to scan
+     * @return Freshly computed accumulator
+     */
+    static NnueAccumulator computeAccumulator(const Board& board);
+
+    /**
+     * Runs the output layer on the board's incremental accumulator.
+     * @param board The board to evaluate
+     * @param sideToMove The side whose point of view the score is returned from
+     * @return Score in centipawns, positive when sideToMove is better
+     */
+    static int evaluate(const Board& board, Color sideToMove);
+
+    /**
+     * Runs the output layer on an accumulator recomputed from scratch.
+     * @param board The board to evaluate
+     * @param sideToMove The side whose point of view the score is returned from
+     * @return Score in centipawns, positive when sideToMove is better
+     */
+    static int evaluateFull(const Board& board, Color sideToMove);
+
+    /**
+     * Checks that the board's accumulator matches a full recompute.
+     * @param board The board to check
+     * @return true if every hidden value agrees
+     */
+    static bool verify(const Board& board);
+};
+
+#endif // NNUE_H
@@ -0,0 +1,76 @@
+#ifndef PAWNHASHTABLE_H
+#define PAWNHASHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Cached pawn-structure evaluation for one pawn configuration.
+ * Scores are White minus Black; passed masks use bit (rank * 8 + file).
+ */
+struct PawnEntry {
+    uint64_t key = 0;
+    uint64_t passedPawns[2] = {0, 0};  // indexed by Color
+    int16_t midgame = 0;
+    int16_t endgame = 0;
+    bool valid = false;
+};
+
+/**
+ * Fixed-size, always-replace hash table of pawn-structure evaluations,
+ * indexed by Board's pawn-only Zobrist key. Not thread safe: each search
+ * thread uses its own instance (see Evaluator::pawnTable()).
+ */
+class PawnHashTable {
+private:
+    std::vector<PawnEntry> entries;
+    uint64_t mask;
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+public:
+    /**
+     * Creates a table with the given number of entries (rounded down to a power of two).
+     * @param size Requested number of entries
+     */
+    explicit PawnHashTable(size_t size = 16384);
+
+    /**
+     * Looks up a pawn configuration.
+     * @param key Pawn-only Zobrist key
+     * @return Pointer to the cached entry, or nullptr on a miss
+     */
+    const PawnEntry* probe(uint64_t key);
+
+    /**
+     * Stores an entry, replacing whatever occupied its slot.
+     * @param entry The entry to store (its key selects the slot)
+     */
+    void store(const PawnEntry& entry);
+
+    /**
+     * Empties the table and resets the statistics.
+     */
+    void clear();
+
+    /**
+     * Gets the number of probes since the last clear.
+     * @return Probe count
+     */
+    uint64_t getProbes() const;
+
+    /**
+     * Gets the number of successful probes since the last clear.
+     * @return Hit count
+     */
+    uint64_t getHits() const;
+
+    /**
+     * Gets the fraction of probes that hit.
+     * @return Hit rate in [0, 1]
+     */
+    double getHitRate() const;
+};
+
+#endif // PAWNHASHTABLE_H
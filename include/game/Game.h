@@ -36,6 +36,9 @@ private:
     bool drawOffered;
     std::optional<Color> drawOfferedBy;
     std::vector<std::string> moveHistory;
+    int halfmoveClock;          // plies since the last capture or pawn move
+    int fullmoveNumber;
+    std::string startFen;       // empty when the game began from the standard position
 
     /**
      * Initializes the chess board with pieces in starting positions.
@@ -78,11 +81,33 @@ private:
     std::string moveToSAN(const Move& move, const Piece* piece);
 
 public:
+    static const char* const START_FEN;
+
     /**
      * Constructs a new game with the board in starting position.
      */
     Game();
 
+    /**
+     * Sets up a position from Forsyth-Edwards Notation, clearing the move
+     * history and any draw offer. On failure the game is left unchanged.
+     * @param fen FEN string (the clock fields may be omitted)
+     * @return true if the FEN was valid
+     */
+    bool loadFen(const std::string& fen);
+
+    /**
+     * Writes the current position in Forsyth-Edwards Notation.
+     * @return FEN string including side to move, castling, en passant and clocks
+     */
+    std::string toFen() const;
+
+    /**
+     * Gets the FEN the game was set up from.
+     * @return FEN string, or empty if the game began from the standard position
+     */
+    const std::string& getStartFen() const;
+
     /**
      * Gets the current game board.
      * @return Reference to the board
@@ -153,6 +178,12 @@ public:
      */
     bool makeMove(const Move& move);
 
+    /**
+     * Generates every legal move for the current player.
+     * @return Vector of legal moves (promotions are listed once per piece type)
+     */
+    std::vector<Move> getLegalMoves() const;
+
     /**
      * Gets the winner of the game.
      * @return "White", "Black", or empty string if no winner yet
@@ -163,7 +194,7 @@ public:
      * Gets the move history in SAN notation.
      * @return Vector of moves in SAN notation
      */
-    std::vector<std::string> getMoveHistory() const;
+    const std::vector<std::string>& getMoveHistory() const;
 
     /**
      * Sets the move history.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <optional>
 #include "board/Move.h"
 #include "board/Board.h"
@@ -20,25 +21,25 @@ struct ParsedMove {
 
 class MoveParser {
 public:
-    static ParsedMove parse(const std::string& input, const Board& board, Color turn);
-    static ParsedMove parseSimple(const std::string& input, const Board& board, Color turn);
-    static ParsedMove parseAlgebraic(const std::string& input, const Board& board, Color turn);
+    static ParsedMove parse(std::string_view input, const Board& board, Color turn);
+    static ParsedMove parseSimple(std::string_view input, const Board& board, Color turn);
+    static ParsedMove parseAlgebraic(std::string_view input, const Board& board, Color turn);
 
-private:
-    static std::optional<Move> resolveAlgebraic(
-        const std::string& token,
-        const Board& board,
-        Color turn,
-        bool& isCapture,
-        bool& isCheck,
-        bool& isCastling,
-        std::optional<PieceType>& promotion
-    );
+    /**
+     * Resolves a SAN move ("Nbd7", "exd6", "e8=Q+", "O-O") without allocating:
+     * the target square and disambiguation are decoded in place, and only
+     * pieces whose movement pattern reaches the target are checked.
+     * @param san The move text, optionally with check and annotation marks
+     * @param board The position
+     * @param turn The side to move
+     * @return The unique legal move, or empty if none or several match
+     */
+    static std::optional<Move> resolveSan(std::string_view san, const Board& board, Color turn);
 
-    static std::vector<Piece*> getCandidates(
-        PieceType type,
-        const Board& board,
-        Color turn,
-        const Square& target
-    );
-};
\ No newline at end of file
+private:
+    /**
+     * Checks whether a piece's movement pattern takes it to a square,
+     * including pawn pushes, captures and en passant.
+     */
+    static bool reaches(const Board& board, const Piece* piece, const Square& target);
+};
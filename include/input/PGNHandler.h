@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include "board/Move.h"
 #include "game/Game.h"
+#include "input/PGNReader.h"
+#include "input/PGNWriter.h"
 
 class PGNHandler {
 public:
@@ -9,8 +14,10 @@ public:
      * Saves the current game state to a PGN file.
      * @param game The game to save
      * @param filename The path to the file
+     * @param header Seven Tag Roster values (the result comes from the game)
+     * @return true if the file was written
      */
-    static void saveToFile(const Game& game, const std::string& filename);
+    static bool saveToFile(const Game& game, const std::string& filename, const PGNHeader& header = PGNHeader());
 
     /**
      * Loads a game from a PGN file.
@@ -20,6 +27,34 @@ public:
      */
     static void loadFromFile(Game& game, const std::string& filename);
 
-private:
-    static std::string generatePGN(const Game& game);
+    /**
+     * Loads one game of a multi-game PGN file through its sidecar index
+     * (see PGNIndex), building the index first if it is missing or stale.
+     * @param game The game object to update
+     * @param filename The path to the file
+     * @param gameNumber Game to load (0-based)
+     * @return true if the game exists and every move was applied
+     */
+    static bool loadFromFile(Game& game, const std::string& filename, uint64_t gameNumber);
+
+    /**
+     * Loads a single game from PGN text.
+     * Resets the provided game object and applies the moves in the text.
+     * @param game The game object to update
+     * @param pgn PGN text of one game (tags are skipped)
+     * @param onMove Called with the position and move before each move is applied
+     * @return true if every move was applied
+     */
+    static bool loadFromString(Game& game, const std::string& pgn,
+                               const std::function<void(const Game&, const Move&)>& onMove = nullptr);
+
+    /**
+     * Replays a game read by PGNReader, starting from its FEN tag if any.
+     * @param game The game object to reset and update
+     * @param pgn The parsed game
+     * @param onMove Called with the position and move before each move is applied
+     * @return true if every move was applied
+     */
+    static bool replay(Game& game, const PGNGame& pgn,
+                       const std::function<void(const Game&, const Move&)>& onMove = nullptr);
 };
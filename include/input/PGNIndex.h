@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "game/Game.h"
+#include "input/PGNReader.h"
+#include "util/MappedFile.h"
+
+/**
+ * Location and main tags of one game in an indexed PGN file. The strings
+ * point into the mapped index and stay valid while it is open.
+ */
+struct PGNIndexEntry {
+    uint64_t offset = 0;  // first byte of the game in the PGN file
+    uint64_t length = 0;  // bytes up to the next game
+    std::string_view white;
+    std::string_view black;
+    std::string_view date;
+    std::string_view result;
+};
+
+/**
+ * Totals of a PGNIndex::build() run.
+ */
+struct PGNIndexStats {
+    bool ok = false;
+    uint64_t games = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+};
+
+/**
+ * Random access to the games of a large PGN file through a sidecar index.
+ *
+ * build() maps the PGN and finds game boundaries in one pass, scanning for
+ * tag lines ('[' after a newline) several bytes at a time; like PGNReader, a
+ * tag line that follows movetext starts a new game. open() maps both the PGN
+ * and its index, so game N or the games matching a tag are reached without
+ * reading anything before them.
+ *
+ * Index layout (little-endian):
+ *   char[4]  magic "CCPI"
+ *   uint32   version
+ *   uint64   game count
+ *   uint64   size of the indexed PGN file (a changed file is rejected)
+ *   uint64   offset of the string table
+ *   records  per game: uint64 offset, uint64 length, uint64 start of its
+ *            strings in the string table
+ *   strings  per game: White, Black, Date and Result as uint8 length + bytes
+ */
+class PGNIndex {
+private:
+    MappedFile pgnFile;
+    MappedFile indexFile;
+    uint64_t gameCount = 0;
+    uint64_t stringsOffset = 0;
+
+public:
+    static const uint32_t VERSION = 2;
+    static const size_t HEADER_SIZE = 32;
+    static const size_t RECORD_SIZE = 24;
+
+    PGNIndex() = default;
+    PGNIndex(const PGNIndex&) = delete;
+    PGNIndex& operator=(const PGNIndex&) = delete;
+
+    /**
+     * Gets the default sidecar path of a PGN file.
+     * @param pgnFilename Path to the PGN file
+     * @return The path with ".idx" appended
+     */
+    static std::string indexPath(const std::string& pgnFilename);
+
+    /**
+     * Indexes a PGN file.
+     * @param pgnFilename Path to the PGN file
+     * @param indexFilename Path of the index to write
+     * @return Game count, bytes scanned and time (ok is false if a file could not be used)
+     */
+    static PGNIndexStats build(const std::string& pgnFilename, const std::string& indexFilename);
+
+    /**
+     * Maps a PGN file and its index.
+     * @param pgnFilename Path to the PGN file
+     * @param indexFilename Path to the index
+     * @return false if either file cannot be read or the index does not match the PGN
+     */
+    bool open(const std::string& pgnFilename, const std::string& indexFilename);
+
+    /**
+     * Unmaps both files.
+     */
+    void close();
+
+    /**
+     * Checks whether an index is open.
+     * @return true after a successful open()
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the number of indexed games.
+     * @return Game count
+     */
+    uint64_t size() const;
+
+    /**
+     * Gets the location and tags of a game.
+     * @param index Game number (0-based, below size())
+     * @return The entry
+     */
+    PGNIndexEntry entry(uint64_t index) const;
+
+    /**
+     * Gets the raw text of a game.
+     * @param index Game number (0-based, below size())
+     * @return View into the mapped PGN
+     */
+    std::string_view text(uint64_t index) const;
+
+    /**
+     * Tokenizes a game.
+     * @param index Game number (0-based, below size())
+     * @param game Receives the game (views into the mapped PGN)
+     */
+    void read(uint64_t index, PGNGame& game) const;
+
+    /**
+     * Replays a game into a Game.
+     * @param index Game number (0-based)
+     * @param game The game object to reset and update
+     * @return false if the index is out of range or a move could not be applied
+     */
+    bool load(uint64_t index, Game& game) const;
+
+    /**
+     * Finds the games whose tag contains a value.
+     * @param tag "White", "Black", "Date" or "Result"
+     * @param value Text to look for (case-sensitive)
+     * @return Matching game numbers in file order
+     */
+    std::vector<uint64_t> find(std::string_view tag, std::string_view value) const;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include "board/Move.h"
+#include "game/Game.h"
+#include "input/PGNReader.h"
+
+/**
+ * Settings for PGNPipeline::run().
+ */
+struct PipelineOptions {
+    int threads = 0;          // worker threads (0 = one per core)
+    size_t queueBatches = 0;  // bounded queue capacity in batches (0 = 4 per worker)
+    size_t batchSize = 64;    // games handed over per batch
+    bool replay = true;       // replay moves through Game (false = tokenize only)
+};
+
+/**
+ * Counters and per-stage timings of a pipeline run. Worker times are summed
+ * over all workers.
+ */
+struct PipelineStats {
+    bool opened = false;
+    int threads = 0;
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    uint64_t failed = 0;         // games with a move that could not be replayed
+    uint64_t bytes = 0;
+    double wallSeconds = 0;
+    double readSeconds = 0;      // reader: reading and splitting games
+    double blockedSeconds = 0;   // reader: waiting for queue space (workers too slow)
+    double parseSeconds = 0;     // workers: tokenizing
+    double replaySeconds = 0;    // workers: SAN resolution and Game::makeMove
+    double idleSeconds = 0;      // workers: waiting for batches (reader too slow)
+};
+
+/**
+ * Parallel PGN ingestion: one reader thread splits the file at game
+ * boundaries and hands batches of game text through a bounded queue to a
+ * pool of workers, which tokenize and replay them. Results are delivered
+ * through callbacks tagged with the worker index, so callers can keep
+ * per-thread accumulators and merge them afterwards without locking.
+ */
+class PGNPipeline {
+private:
+    // Private constructor to prevent instantiation
+    PGNPipeline() = delete;
+
+public:
+    typedef std::function<void(int worker, const PGNGame& pgn, const Game& position, const Move& move)> MoveHandler;
+    typedef std::function<void(int worker, const PGNGame& pgn, const Game& finalPosition, bool replayed)> GameHandler;
+
+    /**
+     * Resolves the number of worker threads run() will use.
+     * @param options Pipeline settings
+     * @return Worker count (at least 1)
+     */
+    static int workerCount(const PipelineOptions& options);
+
+    /**
+     * Ingests a PGN file.
+     * @param filename PGN file
+     * @param options Pipeline settings
+     * @param onGame Called after each game (optional)
+     * @param onMove Called before each replayed move (optional, needs replay)
+     * @return Counters and timings (opened is false if the file could not be read)
+     */
+    static PipelineStats run(const std::string& filename, const PipelineOptions& options,
+                             const GameHandler& onGame = nullptr, const MoveHandler& onMove = nullptr);
+
+    /**
+     * Prints throughput and the per-stage breakdown.
+     * @param stats Result of run()
+     * @param out Output stream
+     */
+    static void printStats(const PipelineStats& stats, std::ostream& out);
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * One game read by PGNReader. The views point into the reader's game buffer
+ * and stay valid until the next call to PGNReader::next().
+ */
+struct PGNGame {
+    std::vector<std::pair<std::string_view, std::string_view>> tags;  // name, value
+    std::vector<std::string_view> moves;  // SAN tokens, without numbers, comments or variations
+    std::string_view result;              // "1-0", "0-1", "1/2-1/2" or "*" (empty if missing)
+    std::string_view text;                // the game's raw text
+    uint64_t number = 0;                  // 0-based position in the file (not set by tokenize())
+
+    /**
+     * Looks up a tag value.
+     * @param name Tag name, e.g. "White"
+     * @return The value, or empty if the tag is absent
+     */
+    std::string_view tag(std::string_view name) const;
+};
+
+/**
+ * Streaming reader for multi-game PGN files.
+ *
+ * The file is read through a fixed-size buffer and only the current game is
+ * kept in memory, so archives of any size can be scanned. A new game starts
+ * at a tag line that follows movetext (or at the first tag line of the file).
+ */
+class PGNReader {
+private:
+    std::ifstream file;
+    std::vector<char> buffer;
+    size_t bufferPos = 0;
+    size_t bufferEnd = 0;
+    bool endOfFile = false;
+
+    std::string lineCarry;      // a line that straddles two buffer fills
+    std::string pendingLine;    // first tag line of the next game
+    bool hasPendingLine = false;
+    std::string gameText;       // storage behind PGNGame's views
+
+    uint64_t bytesRead = 0;
+    uint64_t gamesRead = 0;
+
+    /**
+     * Reads the next line without its terminator.
+     * @return false at end of file
+     */
+    bool readLine(std::string_view& line);
+
+    /**
+     * Collects the lines of the next game into gameText.
+     * @return false when there are no more games
+     */
+    bool readGame();
+
+public:
+    /**
+     * Opens a PGN file.
+     * @param filename Path to the file
+     * @param bufferSize Size of the read buffer in bytes
+     */
+    explicit PGNReader(const std::string& filename, size_t bufferSize = 1 << 20);
+
+    /**
+     * Checks whether the file was opened.
+     * @return true if games can be read
+     */
+    bool isOpen() const;
+
+    /**
+     * Reads the next game.
+     * @param game Receives the game (views valid until the next call)
+     * @return false when there are no more games
+     */
+    bool next(PGNGame& game);
+
+    /**
+     * Reads the raw text of the next game without tokenizing it, e.g. to hand
+     * it to another thread.
+     * @param text Receives the game text (its old buffer is reused by the reader)
+     * @return false when there are no more games
+     */
+    bool nextText(std::string& text);
+
+    /**
+     * Splits the text of one game into tags, move tokens and the result.
+     * @param text Game text; must outlive the views stored in game
+     * @param game Receives the parsed game
+     */
+    static void tokenize(std::string_view text, PGNGame& game);
+
+    /**
+     * Gets the number of bytes consumed so far.
+     * @return Byte count
+     */
+    uint64_t getBytesRead() const;
+
+    /**
+     * Gets the number of games returned so far.
+     * @return Game count
+     */
+    uint64_t getGamesRead() const;
+
+    /**
+     * Gets the capacity of the game buffer, i.e. the largest game held so far.
+     * @return Bytes reserved for one game
+     */
+    size_t getGameCapacity() const;
+};
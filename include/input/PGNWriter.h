@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "game/Game.h"
+#include "util/BoundedQueue.h"
+
+/**
+ * Seven Tag Roster values for an exported game. Unless set, the Result tag is
+ * taken from the game itself.
+ */
+struct PGNHeader {
+    std::string event = "Console Chess Game";
+    std::string site = "?";
+    std::string date = "????.??.??";
+    std::string round = "?";
+    std::string white = "?";
+    std::string black = "?";
+    std::string result;  // empty: PGNWriter::result() of the game
+};
+
+/**
+ * Buffered writer for multi-game PGN files.
+ *
+ * Games are formatted straight into a large output buffer, which is written
+ * to the file in one call whenever it fills up. With a background writer the
+ * full buffer is handed to a writer thread instead, so formatting continues
+ * while the previous chunk is being written.
+ */
+class PGNWriter {
+private:
+    std::ofstream file;
+    std::string buffer;
+    size_t chunkSize;
+    bool background;
+    BoundedQueue<std::string> chunks;  // full buffers waiting for the writer thread
+    std::thread writerThread;
+    std::atomic<bool> writeFailed{false};
+    bool closed = false;
+
+    uint64_t gamesWritten = 0;
+    uint64_t bytesWritten = 0;
+
+    /**
+     * Writes out (or hands off) the buffered text.
+     */
+    void flushBuffer();
+
+public:
+    static const size_t LINE_LENGTH = 79;
+
+    /**
+     * Opens (truncates) a PGN file for writing.
+     * @param filename Path to the file
+     * @param chunkSize Bytes buffered before each write
+     * @param background true to write chunks from a separate thread
+     */
+    explicit PGNWriter(const std::string& filename, size_t chunkSize = 1 << 20, bool background = false);
+
+    /**
+     * Flushes and closes the file.
+     */
+    ~PGNWriter();
+
+    PGNWriter(const PGNWriter&) = delete;
+    PGNWriter& operator=(const PGNWriter&) = delete;
+
+    /**
+     * Checks whether the file was opened.
+     * @return true if games can be written
+     */
+    bool isOpen() const;
+
+    /**
+     * Appends a game to the output.
+     * @param game The game (moves, start position and result)
+     * @param header Tag values
+     */
+    void write(const Game& game, const PGNHeader& header = PGNHeader());
+
+    /**
+     * Writes all buffered text and waits for the background writer.
+     * @return false if a write failed
+     */
+    bool close();
+
+    /**
+     * Gets the number of games written.
+     * @return Game count
+     */
+    uint64_t getGamesWritten() const;
+
+    /**
+     * Gets the number of bytes formatted so far.
+     * @return Byte count
+     */
+    uint64_t getBytesWritten() const;
+
+    /**
+     * Formats one game in PGN export format: Seven Tag Roster, SetUp/FEN
+     * tags for set-up positions, movetext wrapped at LINE_LENGTH columns and
+     * the result, followed by a blank line.
+     * @param out Text to append to
+     * @param game The game
+     * @param header Tag values
+     */
+    static void append(std::string& out, const Game& game, const PGNHeader& header);
+
+    /**
+     * Gets the PGN result of a game.
+     * @param game The game
+     * @return "1-0", "0-1", "1/2-1/2" or "*" while it is still in progress
+     */
+    static const char* result(const Game& game);
+};
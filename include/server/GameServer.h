@@ -0,0 +1,57 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Settings for GameServer::run().
+ */
+struct ServerOptions {
+    std::string socketPath = "chess.sock";  // Unix domain socket (used when port is 0)
+    int port = 0;              // localhost TCP port instead of the socket
+    int workers = 0;           // engine threads (0 = one per core)
+    int depth = 4;             // engine search depth
+    size_t hashMb = 64;        // transposition tables, split between the engine threads
+};
+
+/**
+ * Hosts many games in one process ("chess serve").
+ *
+ * A single thread runs an epoll event loop over the listening socket and all
+ * connections; each connection owns one Game. Clients send text lines:
+ *
+ *   new [white|black]   start a game; with a color the client plays it
+ *                       against the engine, otherwise it plays both sides
+ *   move <move>         coordinate notation or SAN
+ *   fen                 current position
+ *   quit                close the connection
+ *
+ * and get one line back per command ("ok new", "ok <move> <state>",
+ * "illegal <move>", "fen <fen>", "error <text>"). Moves are validated on
+ * the event loop with MoveParser and Game::makeMove. Engine replies are
+ * searched by a pool of worker threads, each with its own transposition
+ * table, and come back through an eventfd, then reach the client as
+ * "engine <move> <state>", so a slow search never holds up other games.
+ *
+ * The server runs until SIGINT or SIGTERM and then prints the number of
+ * connections and moves and the p50/p99 time spent validating a move.
+ * Linux only (epoll); elsewhere run() reports that it is unsupported.
+ */
+class GameServer {
+private:
+    // Private constructor to prevent instantiation
+    GameServer() = delete;
+
+public:
+    static const size_t MAX_LINE = 4096;
+
+    /**
+     * Listens and serves games until interrupted.
+     * @param options Address, engine threads and depth
+     * @return Process exit code
+     */
+    static int run(const ServerOptions& options);
+};
+
+#endif // GAMESERVER_H
@@ -0,0 +1,45 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <string>
+
+/**
+ * Settings for LoadGenerator::run().
+ */
+struct LoadOptions {
+    std::string socketPath = "chess.sock";  // server socket (used when port is 0)
+    int port = 0;             // localhost TCP port instead of the socket
+    int games = 1000;         // concurrent connections, one game each
+    int seconds = 10;         // measuring time
+    int thinkMs = 0;          // pause before each client move
+    int maxPlies = 200;       // start a new game after this many plies
+    bool engine = false;      // play White against the engine instead of both sides
+    unsigned seed = 1;
+};
+
+/**
+ * Load generator for GameServer ("chess loadgen").
+ *
+ * Opens one connection per game and drives them all from one epoll loop.
+ * Every client keeps its own Board, picks a random legal move, sends it and
+ * waits for the answer before the next move (and, against the engine, for
+ * the engine's reply), so the load is closed-loop: each game has at most
+ * one move in flight. The time from sending a move to receiving "ok" is the
+ * move-validation latency; the report gives moves per second, p50, p99 and
+ * the maximum.
+ */
+class LoadGenerator {
+private:
+    // Private constructor to prevent instantiation
+    LoadGenerator() = delete;
+
+public:
+    /**
+     * Connects the clients, plays for the configured time and prints the report.
+     * @param options Server address, number of games and duration
+     * @return Process exit code (0 if all clients connected)
+     */
+    static int run(const LoadOptions& options);
+};
+
+#endif // LOADGENERATOR_H
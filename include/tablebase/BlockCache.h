@@ -0,0 +1,93 @@
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Bounded least-recently-used cache of decompressed tablebase blocks,
+ * shared by all threads. Blocks are handed out as shared pointers, so a
+ * block evicted while another thread is reading it stays valid until that
+ * thread lets go of it.
+ */
+class BlockCache {
+public:
+    typedef std::shared_ptr<const std::vector<uint8_t>> Block;
+
+private:
+    size_t capacity;
+    std::list<std::pair<uint64_t, Block>> order;  // most recently used first
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Block>>::iterator> entries;
+    mutable std::mutex lock;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+public:
+    /**
+     * Creates a cache holding up to the given number of blocks.
+     * @param capacity Maximum number of blocks (at least 1)
+     */
+    explicit BlockCache(size_t capacity = 1024);
+
+    /**
+     * Looks up a block and marks it as recently used.
+     * @param key Block key (table id and block number)
+     * @return The block, or nullptr on a miss
+     */
+    Block get(uint64_t key);
+
+    /**
+     * Inserts a block, evicting the least recently used ones if full.
+     * @param key Block key
+     * @param block Decompressed block
+     */
+    void put(uint64_t key, Block block);
+
+    /**
+     * Changes the capacity, evicting blocks if needed.
+     * @param blocks New maximum number of blocks (at least 1)
+     */
+    void setCapacity(size_t blocks);
+
+    /**
+     * Drops every block and resets the statistics.
+     */
+    void clear();
+
+    /**
+     * Resets the hit and miss counters, keeping the blocks.
+     */
+    void resetStats();
+
+    /**
+     * Gets the number of cached blocks.
+     * @return Block count
+     */
+    size_t size() const;
+
+    /**
+     * Gets the maximum number of cached blocks.
+     * @return Capacity in blocks
+     */
+    size_t getCapacity() const;
+
+    /**
+     * Gets the number of lookups that found their block.
+     * @return Hit count
+     */
+    uint64_t getHits() const;
+
+    /**
+     * Gets the number of lookups that missed.
+     * @return Miss count
+     */
+    uint64_t getMisses() const;
+};
+
+#endif // BLOCKCACHE_H
@@ -0,0 +1,201 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "board/Board.h"
+#include "board/Move.h"
+#include "enums/Color.h"
+#include "tablebase/BlockCache.h"
+#include "tablebase/TablebaseIndex.h"
+#include "util/MappedFile.h"
+
+/**
+ * Game-theoretic value of a position for the side to move.
+ */
+enum class Wdl {
+    LOSS,
+    DRAW,
+    WIN
+};
+
+/**
+ * Result of a tablebase probe.
+ */
+struct TablebaseResult {
+    Wdl wdl = Wdl::DRAW;
+    int pliesToMate = 0;  // distance to mate in plies (0 for draws)
+};
+
+/**
+ * Probe counters, see Tablebase::getStats().
+ */
+struct TablebaseStats {
+    uint64_t probes = 0;              // table lookups (probe() and probeRaw())
+    uint64_t cacheHits = 0;           // lookups served from a cached block
+    uint64_t cacheMisses = 0;         // lookups that had to decompress a block
+    uint64_t decompressionNs = 0;     // total time spent decompressing
+    int tablesMapped = 0;             // tables mapped so far (mapping is lazy)
+    size_t cachedBlocks = 0;
+};
+
+/**
+ * Endgame tablebases produced by TablebaseGenerator, stored as
+ * "<material>.cctb" files (e.g. "KQK.cctb").
+ *
+ * init() only reads the headers; a file is memory-mapped the first time one
+ * of its positions is probed. Values are stored in fixed-size blocks that are
+ * run-length encoded, and decompressed blocks are kept in an LRU cache shared
+ * by all threads.
+ *
+ * File layout (little-endian):
+ *   char[4]  magic "CCTB"
+ *   uint32   version (2; version 1 files store raw values after the header)
+ *   char[8]  material, zero padded
+ *   uint64   entry count
+ *   uint32   entries per block
+ *   uint32   block count
+ *   uint64   offsets[block count + 1]   start of each block in the data
+ *   data     run-length encoded blocks (see compressBlock())
+ *
+ * Each value is 0 for a draw, ILLEGAL for an impossible position, otherwise
+ * distance to mate in plies + 1: a win when the strong side is to move and a
+ * loss when the bare king is to move.
+ */
+class Tablebase {
+private:
+    struct Table {
+        std::string path;
+        TablebaseIndex index;
+        int id = 0;
+        uint32_t version = 0;
+        uint32_t blockSize = 0;
+        uint32_t blockCount = 0;
+        MappedFile file;
+        std::mutex openLock;
+        std::atomic<bool> mapped{false};
+        explicit Table(const std::string& material) : index(material) {}
+    };
+
+    static std::map<std::string, std::unique_ptr<Table>> tables;
+    static int largestTable;
+    static BlockCache cache;
+    static std::atomic<uint64_t> probes;
+    static std::atomic<uint64_t> decompressionNs;
+    static std::atomic<int> tablesMapped;
+
+    /**
+     * Maps a table's file on first use.
+     */
+    static bool ensureMapped(Table& table);
+
+    /**
+     * Reads one value, going through the block cache for compressed tables.
+     */
+    static std::optional<uint8_t> readValue(Table& table, uint64_t index);
+
+    // Private constructor to prevent instantiation
+    Tablebase() = delete;
+
+public:
+    static const uint8_t DRAW = 0;
+    static const uint8_t ILLEGAL = 255;
+    static const uint32_t VERSION = 2;
+    static const size_t HEADER_SIZE = 24;
+    static const uint32_t BLOCK_SIZE = 4096;
+
+    /**
+     * Registers every "*.cctb" file in a directory, replacing loaded tables.
+     * Only headers are read; files are mapped on first probe.
+     * @param directory Directory to scan
+     * @return Number of tables found
+     */
+    static int init(const std::string& directory);
+
+    /**
+     * Unmaps all tables and empties the block cache.
+     */
+    static void clear();
+
+    /**
+     * Sets how many decompressed blocks the shared cache may hold.
+     * @param blocks Capacity in blocks of BLOCK_SIZE entries
+     */
+    static void setCacheSize(size_t blocks);
+
+    /**
+     * Gets probe and cache counters since the last init() or resetStats().
+     * @return Current statistics
+     */
+    static TablebaseStats getStats();
+
+    /**
+     * Resets the probe and cache counters.
+     */
+    static void resetStats();
+
+    /**
+     * Run-length encodes one block of values, with literal runs for stretches
+     * that do not repeat.
+     * @param values First value of the block
+     * @param count Number of values
+     * @return Encoded bytes
+     */
+    static std::vector<uint8_t> compressBlock(const uint8_t* values, size_t count);
+
+    /**
+     * Decodes a block written by compressBlock().
+     * @param data Encoded bytes
+     * @param length Number of encoded bytes
+     * @param count Number of values expected
+     * @param out Receives the values
+     * @return false if the data is corrupt
+     */
+    static bool decompressBlock(const char* data, size_t length, size_t count, std::vector<uint8_t>& out);
+
+    /**
+     * Gets the material names of the registered tables.
+     * @return Names such as "KQK", in sorted order
+     */
+    static std::vector<std::string> getMaterials();
+
+    /**
+     * Gets the largest number of men covered by a loaded table.
+     * @return Piece count, or 0 when nothing is loaded
+     */
+    static int maxPieces();
+
+    /**
+     * Looks up a position.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @return The result, or empty if no table covers the material
+     */
+    static std::optional<TablebaseResult> probe(const Board& board, Color sideToMove);
+
+    /**
+     * Looks up a raw table value (used by the generator for promotions).
+     * @param material Material name, e.g. "KQK"
+     * @param squares Squares in TablebaseIndex order
+     * @param strongToMove true if the strong side is to move
+     * @return The stored byte, or empty if the table is not loaded
+     */
+    static std::optional<uint8_t> probeRaw(const std::string& material, const int* squares, bool strongToMove);
+
+    /**
+     * Picks the move that keeps the best tablebase value: the fastest mate
+     * when winning, a drawing move when drawn, the longest defence when lost.
+     * @param board The position
+     * @param sideToMove The side to move
+     * @return The move, or empty if the position is not in a table
+     */
+    static std::optional<Move> bestMove(const Board& board, Color sideToMove);
+};
+
+#endif // TABLEBASE_H
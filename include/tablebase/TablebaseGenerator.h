@@ -0,0 +1,47 @@
+#ifndef TABLEBASEGENERATOR_H
+#define TABLEBASEGENERATOR_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Builds endgame tablebases (king and pieces against a bare king) by
+ * retrograde analysis, writing files that Tablebase can map.
+ *
+ * Starting from the mates, every pass walks the positions decided in the
+ * previous pass backwards: positions where the strong side can move into a
+ * lost position are wins, and positions where every move of the bare king
+ * leads to a win are losses. Captures by the bare king and promotions leave
+ * the table; they are looked up in the smaller tables. Passes are split
+ * across threads; entries are claimed with atomic compare-and-swap.
+ */
+class TablebaseGenerator {
+private:
+    // Private constructor to prevent instantiation
+    TablebaseGenerator() = delete;
+
+public:
+    /**
+     * Generates one table and writes "<directory>/<material>.cctb".
+     * The tables its captures and promotions lead to must be loaded in
+     * Tablebase (e.g. KQK and KRK for KPK and for KQRK).
+     * @param material Material name, e.g. "KRK"
+     * @param directory Output directory (must exist)
+     * @param threads Number of worker threads
+     * @return true if the table was written
+     */
+    static bool generate(const std::string& material, const std::string& directory, int threads);
+
+    /**
+     * Generates several tables plus the ones they need that the directory
+     * lacks, smaller tables first, reloading Tablebase from the directory
+     * before tables that need others.
+     * @param directory Output directory (created if missing)
+     * @param threads Number of worker threads (0 = one per core)
+     * @param materials Tables to build (empty = KQK, KRK, KPK, KBNK)
+     * @return Process exit code (0 on success)
+     */
+    static int generateAll(const std::string& directory, int threads, std::vector<std::string> materials);
+};
+
+#endif // TABLEBASEGENERATOR_H
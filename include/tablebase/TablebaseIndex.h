@@ -0,0 +1,93 @@
+#ifndef TABLEBASEINDEX_H
+#define TABLEBASEINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "enums/PieceType.h"
+
+/**
+ * Maps positions of one material set (king and pieces against a bare king)
+ * to dense table indices.
+ *
+ * Positions are always seen from the strong side, which plays "up" the board
+ * like White. Squares are 0-63 (a1 = 0, h8 = 63) and stored as
+ *   squares[0] = strong king, squares[1] = weak king, squares[2..] = pieces
+ * with the pieces in PieceType order (Q, R, B, N, P).
+ *
+ * Tables without pawns use the 8 board symmetries to keep the strong king in
+ * the a1-d1-d4 triangle (10 squares), which shrinks them eightfold.
+ */
+class TablebaseIndex {
+private:
+    std::vector<PieceType> pieces;  // strong side's non-king pieces
+    bool pawns;
+    uint64_t entries;
+
+public:
+    static const int MAX_PIECES = 4;  // kings included
+
+    /**
+     * Creates the index for a material string such as "KQK" or "KBNK".
+     * @param material Material name (see isValidMaterial)
+     * @throws std::invalid_argument if the material is not supported
+     */
+    explicit TablebaseIndex(const std::string& material);
+
+    /**
+     * Checks whether a material string describes a supported table:
+     * "K", one to MAX_PIECES - 2 pieces in Q/R/B/N/P order (repeats allowed), then "K".
+     * @param material The material string
+     * @return true if a table can be built for it
+     */
+    static bool isValidMaterial(const std::string& material);
+
+    /**
+     * Builds a material string from the strong side's pieces.
+     * @param pieces Non-king pieces in any order
+     * @return Material name, e.g. "KBNK"
+     */
+    static std::string materialName(std::vector<PieceType> pieces);
+
+    /**
+     * Gets the number of men (kings included).
+     * @return Piece count
+     */
+    int pieceCount() const;
+
+    /**
+     * Gets the strong side's non-king pieces in index order.
+     * @return Piece types
+     */
+    const std::vector<PieceType>& getPieces() const;
+
+    /**
+     * Checks whether the table contains pawns (no symmetry reduction).
+     * @return true if a pawn is present
+     */
+    bool hasPawns() const;
+
+    /**
+     * Gets the number of entries in the table.
+     * @return Entry count
+     */
+    uint64_t size() const;
+
+    /**
+     * Computes the index of a position, applying the board symmetry first.
+     * @param squares Squares in the order described above
+     * @param strongToMove true if the strong side is to move
+     * @return Table index
+     */
+    uint64_t index(const int* squares, bool strongToMove) const;
+
+    /**
+     * Recovers a position from an index (the inverse of index()).
+     * @param index Table index
+     * @param squares Receives pieceCount() squares
+     * @param strongToMove Receives the side to move
+     */
+    void decode(uint64_t index, int* squares, bool& strongToMove) const;
+};
+
+#endif // TABLEBASEINDEX_H
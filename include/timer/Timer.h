@@ -19,6 +19,7 @@ private:
     std::thread timerThread;
     std::atomic<bool> stopFlag;
     int totalSeconds;
+    int incrementSeconds;
 
     /**
      * Timer loop that runs in background thread.
@@ -36,8 +37,9 @@ public:
     /**
      * Constructs a timer with specified minutes per player.
      * @param minutesPerPlayer Starting time for each player in minutes
+     * @param incrementSeconds Seconds added to a player's clock after each of their moves
      */
-    Timer(int minutesPerPlayer);
+    Timer(int minutesPerPlayer, int incrementSeconds = 0);
 
     /**
      * Destructor - stops the timer thread.
@@ -55,7 +57,8 @@ public:
     void stop();
 
     /**
-     * Switches the turn to the other player.
+     * Switches the turn to the other player, adding the increment to the
+     * player who just moved.
      */
     void switchTurn();
 
@@ -71,6 +74,18 @@ public:
      */
     int getRemainingSeconds(Color color) const;
 
+    /**
+     * Gets the per-move increment.
+     * @return Increment in seconds
+     */
+    int getIncrementSeconds() const;
+
+    /**
+     * Gets whose clock is currently running.
+     * @return The color of the running clock
+     */
+    Color getRunningColor() const;
+
     /**
      * Checks if a player has run out of time.
      * @param color The player's color
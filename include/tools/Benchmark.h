@@ -0,0 +1,118 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game/Game.h"
+
+/**
+ * Micro-benchmarks for the engine components, run from the command line
+ * (e.g. "chess bench eval"). Results are printed to stdout.
+ */
+class Benchmark {
+private:
+    // Private constructor to prevent instantiation
+    Benchmark() = delete;
+
+public:
+    /**
+     * Plays deterministic pseudo-random games from the starting position and
+     * collects every position reached.
+     * @param games Number of games to play
+     * @param maxPlies Maximum plies per game
+     * @param seed Random seed
+     * @return Games snapshotted after every ply
+     */
+    static std::vector<Game> samplePositions(int games, int maxPlies, unsigned seed);
+
+    /**
+     * Verifies the incremental PST sums against a full recompute on sampled
+     * positions, then measures evaluations per second for both paths and
+     * reports the pawn hash hit rate.
+     * @param iterations Number of evaluate() calls to time
+     * @return Process exit code (0 if every position verified)
+     */
+    static int runEval(long iterations);
+
+    /**
+     * Loads an NNUE weights file, checks incremental accumulators against a
+     * full recompute on sampled positions, and compares evaluations per
+     * second with the PST evaluator.
+     * @param weightsFile Path to the network weights
+     * @param iterations Number of evaluations to time per evaluator
+     * @return Process exit code (0 if every accumulator verified)
+     */
+    static int runNnue(const std::string& weightsFile, long iterations);
+
+    /**
+     * Checks move generation with perft from the starting position, then
+     * searches sampled positions to a fixed depth and reports nodes per second.
+     * @param depth Search depth in plies
+     * @return Process exit code (0 if perft matched the known counts)
+     */
+    static int runSearch(int depth);
+
+    /**
+     * Probes random entries of every table in a directory from several
+     * threads, first through a tiny block cache and then through the default
+     * one, checks that both passes read the same values and reports the
+     * probe rate, cache hit rate and decompression time.
+     * @param directory Tablebase directory
+     * @param probes Number of probes per pass
+     * @param threads Number of probing threads
+     * @return Process exit code (0 if both passes agreed)
+     */
+    static int runTablebase(const std::string& directory, long probes, int threads);
+
+    /**
+     * Streams every game of a PGN file and reports games, moves and bytes per
+     * second together with the largest game buffer, optionally replaying
+     * each game through PGNHandler to check its moves.
+     * @param filename PGN file
+     * @param replay true to replay the games as well as tokenizing them
+     * @return Process exit code (0 if the file was read and every replay succeeded)
+     */
+    static int runPgnScan(const std::string& filename, bool replay);
+
+    /**
+     * Writes pseudo-random games to a PGN file, first through a per-game
+     * stringstream (the old export path), then through PGNWriter with and
+     * without its background thread, and reports games/sec for each. The
+     * PGNWriter output is read back to check every game and move arrived.
+     * @param filename Output file (overwritten by each pass)
+     * @param games Number of games written per pass
+     * @return Process exit code (0 if the output read back correctly)
+     */
+    static int runPgnWrite(const std::string& filename, long games);
+
+    /**
+     * Replays the games of a PGN file (from their FEN tag, if any) and times
+     * SAN resolution separately from applying the moves, reporting SAN moves
+     * resolved per second.
+     * @param filename PGN file
+     * @return Process exit code (0 if every move resolved)
+     */
+    static int runSan(const std::string& filename);
+
+    /**
+     * Tokenizes every game of a PGN file held in memory with PGNReader's
+     * block-scanning tokenizer and with the previous per-character loop,
+     * checks that they agree and reports MB/s for each.
+     * @param filename PGN file
+     * @param passes Times each tokenizer goes over the games
+     * @return Process exit code (0 if both tokenizers agree on every game)
+     */
+    static int runTokenize(const std::string& filename, int passes);
+
+    /**
+     * Counts leaf nodes of the legal move tree.
+     * @param board The position
+     * @param side The side to move
+     * @param depth Depth in plies
+     * @return Number of leaf positions
+     */
+    static uint64_t perft(const Board& board, Color side, int depth);
+};
+
+#endif // BENCHMARK_H
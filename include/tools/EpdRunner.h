@@ -0,0 +1,53 @@
+#ifndef EPDRUNNER_H
+#define EPDRUNNER_H
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "board/Move.h"
+
+/**
+ * One test position from an EPD file.
+ */
+struct EpdPosition {
+    std::string fen;              // the four EPD position fields
+    std::string id;
+    std::vector<Move> bestMoves;  // "bm": any of these solves the position
+    std::vector<Move> avoidMoves; // "am": none of these may be played
+};
+
+/**
+ * Runs EPD test suites ("chess epd <file>"): every position is searched for
+ * a fixed time, several positions at once, and each result is printed as a
+ * JSON line (or CSV row) followed by a summary.
+ *
+ * A position is solved when the final best move satisfies its bm/am
+ * operations; the time to solution is when the search last switched to a
+ * correct move and kept it until the end.
+ */
+class EpdRunner {
+private:
+    // Private constructor to prevent instantiation
+    EpdRunner() = delete;
+
+public:
+    /**
+     * Parses one EPD line. bm/am moves are resolved from SAN (or coordinate
+     * notation) in the position.
+     * @param line EPD record
+     * @return The position, or empty if the line is blank or invalid
+     */
+    static std::optional<EpdPosition> parseLine(const std::string& line);
+
+    /**
+     * Solves every position of a suite.
+     * @param filename EPD file
+     * @param timeMs Search time per position
+     * @param threads Number of positions searched concurrently
+     * @param csv true for CSV output, false for JSON lines
+     * @return Process exit code (0 if the file could be read)
+     */
+    static int run(const std::string& filename, int timeMs, int threads, bool csv);
+};
+
+#endif // EPDRUNNER_H
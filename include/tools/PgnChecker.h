@@ -0,0 +1,76 @@
+#ifndef PGNCHECKER_H
+#define PGNCHECKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "game/Game.h"
+#include "input/PGNReader.h"
+
+/**
+ * Why a game was rejected.
+ */
+enum class GameError {
+    NONE,
+    BAD_FEN,         // FEN tag that does not load
+    BAD_MOVE,        // SAN that is malformed, ambiguous or has no legal match
+    REJECTED_MOVE,   // resolved move refused by Game::makeMove
+    MOVE_AFTER_END,  // moves after checkmate or stalemate
+    WRONG_RESULT     // result contradicts the final position or the Result tag
+};
+
+/**
+ * Settings for PgnChecker::run().
+ */
+struct PgnCheckOptions {
+    int threads = 0;          // worker threads (0 = one per core)
+    size_t memoryMb = 256;    // memory for duplicate detection before spilling to disk
+    std::string output;       // file for the valid, unique games (empty = report only)
+};
+
+/**
+ * Validates and deduplicates PGN collections ("chess pgn-check").
+ *
+ * Games are read and replayed in parallel through PGNPipeline; every move
+ * is resolved from SAN and applied with Game::makeMove, so only fully legal
+ * games pass. Each valid game is identified by a 128-bit hash of its start
+ * position and move sequence. The hashes are sorted in per-worker buffers
+ * and spilled to run files once the memory limit is reached, then merged
+ * to find the duplicates; the first game of each set is kept. With an
+ * output file, a second pass copies the valid, unique games in file order.
+ */
+class PgnChecker {
+private:
+    // Private constructor to prevent instantiation
+    PgnChecker() = delete;
+
+public:
+    static const size_t MERGE_WAYS = 64;
+
+    /**
+     * Replays one game with full legality checks.
+     * @param pgn The parsed game
+     * @param game Scratch game object (reset and replayed)
+     * @param hash Receives the 128-bit hash of the start position and moves
+     * @param badToken Receives the offending move, if any
+     * @return NONE if the game is legal
+     */
+    static GameError check(const PGNGame& pgn, Game& game, uint64_t hash[2], std::string_view& badToken);
+
+    /**
+     * Describes an error type.
+     * @param error The error
+     * @return Short description
+     */
+    static const char* describe(GameError error);
+
+    /**
+     * Checks a PGN file and prints the error summary and throughput.
+     * @param filename PGN file
+     * @param options Threads, memory limit and output file
+     * @return Process exit code (0 if the file was read and the output written)
+     */
+    static int run(const std::string& filename, const PgnCheckOptions& options);
+};
+
+#endif // PGNCHECKER_H
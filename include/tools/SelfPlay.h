@@ -0,0 +1,85 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Settings for SelfPlay::run().
+ */
+struct SelfPlayOptions {
+    std::string openings;          // FEN/EPD file (empty = start position only)
+    int randomPlies = 8;           // random moves opening each game when there is no openings file
+    std::string output = "selfplay.pgn";
+    int games = 100;
+    int threads = 0;               // games played at once (0 = one per core)
+    int baseMs = 10000;            // clock per side
+    int incrementMs = 100;
+    int depth = 0;                 // fixed depth per move instead of the clock (0 = off)
+    uint64_t nodes = 0;            // node limit per move (0 = none)
+    int maxPlies = 400;            // adjudicate a draw after this many plies
+    size_t hashMb = 16;            // transposition table per thread
+};
+
+/**
+ * How a self-play game ended.
+ */
+enum class Termination {
+    CHECKMATE,
+    STALEMATE,
+    REPETITION,     // threefold repetition
+    FIFTY_MOVES,
+    MATERIAL,       // neither side can mate
+    MAX_PLIES,
+    TIME,           // a clock ran out
+    ILLEGAL_MOVE    // the engine had no move the game accepted
+};
+
+/**
+ * Engine-vs-engine games for evaluating engine changes ("chess selfplay").
+ *
+ * Games are played concurrently, one per pool thread, each with its own
+ * Game, clocks and transposition table. Every game starts from the next
+ * opening of the file (cycled); without a file, each game opens with a few
+ * random legal moves (seeded by the game number, so runs repeat) to keep the
+ * games apart. Both sides think on a clock with
+ * increment: the budget comes from TimeManager::allocate and the time a
+ * search really took is charged, so a side can lose on time. Moves go
+ * through Game::makeMove, which detects mate and stalemate; repetition,
+ * the fifty-move rule, bare material and overlong games are adjudicated
+ * as draws here. Finished games are appended to a PGN file with PGNWriter
+ * in the order they end (the Round tag is the game number).
+ */
+class SelfPlay {
+private:
+    // Private constructor to prevent instantiation
+    SelfPlay() = delete;
+
+public:
+    /**
+     * Reads opening positions: the first four fields of each FEN or EPD line,
+     * plus the move counters when a FEN line has them (otherwise "0 1").
+     * @param filename FEN/EPD file
+     * @param fens Receives the positions as full FENs
+     * @return false if the file cannot be read
+     */
+    static bool loadOpenings(const std::string& filename, std::vector<std::string>& fens);
+
+    /**
+     * Describes a termination.
+     * @param termination How the game ended
+     * @return Short description
+     */
+    static const char* describe(Termination termination);
+
+    /**
+     * Plays the games and prints results, games/hour and thread utilization.
+     * @param options Openings, output file, game count, threads and time control
+     * @return Process exit code (0 if every game was played and written)
+     */
+    static int run(const SelfPlayOptions& options);
+};
+
+#endif // SELFPLAY_H
@@ -0,0 +1,73 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+/**
+ * Fixed-capacity blocking queue for producer/consumer pipelines.
+ * push() waits while the queue is full, which slows a fast producer down to
+ * the pace of its consumers; pop() waits while it is empty. After close(),
+ * consumers drain the remaining items and then receive nothing.
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    bool closed = false;
+    std::mutex lock;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+
+public:
+    /**
+     * Creates a queue.
+     * @param capacity Maximum number of queued items (at least 1)
+     */
+    explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+    /**
+     * Adds an item, waiting for space.
+     * @param item The item
+     * @return false if the queue was closed
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Removes the oldest item, waiting for one to arrive.
+     * @return The item, or empty once the queue is closed and drained
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+        if (items.empty()) return std::nullopt;
+        T item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return item;
+    }
+
+    /**
+     * Stops accepting items and wakes every waiting thread.
+     */
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,61 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Collects latency samples in a fixed-size histogram and reports
+ * percentiles, so memory stays the same however long a server runs.
+ *
+ * Samples are whole microseconds in log-linear (HDR-style) buckets: values
+ * below 64 us are exact, larger ones share a bucket with values within
+ * 1/32 (about 3%) of them. A percentile is the upper end of its bucket,
+ * capped at the largest sample, so the maximum is exact.
+ */
+class LatencyStats {
+private:
+    static const int SUB_BITS = 5;                     // 32 buckets per power of two
+    static const int BUCKETS = (33 - SUB_BITS) << SUB_BITS;
+
+    uint64_t buckets[BUCKETS] = {};
+    size_t samples = 0;
+    uint32_t largest = 0;
+
+    /**
+     * Gets the bucket of a value.
+     */
+    static int bucketOf(uint32_t micros);
+
+    /**
+     * Gets the largest value that falls into a bucket.
+     */
+    static uint32_t bucketTop(int bucket);
+
+public:
+    /**
+     * Adds a sample.
+     * @param nanoseconds Measured latency
+     */
+    void add(int64_t nanoseconds);
+
+    /**
+     * Gets the number of samples.
+     * @return Sample count
+     */
+    size_t count() const;
+
+    /**
+     * Gets a percentile.
+     * @param percent 0 to 100 (e.g. 50 for the median, 99 for p99)
+     * @return The latency in microseconds (0 without samples)
+     */
+    uint32_t percentileUs(double percent) const;
+
+    /**
+     * Removes all samples.
+     */
+    void clear();
+};
+
+#endif // LATENCYSTATS_H
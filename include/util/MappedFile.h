@@ -0,0 +1,59 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Uses mmap on POSIX systems; on Windows the file is read into memory instead.
+ */
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    std::vector<char> fallback;  // used when mmap is unavailable
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Destructor - unmaps the file.
+     */
+    ~MappedFile();
+
+    /**
+     * Maps a file, replacing any previous mapping.
+     * @param filename Path to the file
+     * @return true if the file was opened and mapped (empty files fail)
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmaps the file.
+     */
+    void close();
+
+    /**
+     * Checks whether a file is mapped.
+     * @return true if data() is valid
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the mapped bytes.
+     * @return Pointer to the first byte, or nullptr if nothing is mapped
+     */
+    const char* data() const;
+
+    /**
+     * Gets the mapped length.
+     * @return File size in bytes
+     */
+    size_t size() const;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,156 @@
+#include "archive/ArchiveConverter.h"
+#include "archive/GameArchive.h"
+#include "input/PGNReader.h"
+#include "input/PGNWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Seconds elapsed since a time point.
+ */
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+/**
+ * Converts a PGN file to an archive and times decoding it.
+ */
+int ArchiveConverter::pack(const std::string& pgnFile, const std::string& archiveFile) {
+    PGNReader reader(pgnFile);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read " << pgnFile << std::endl;
+        return 1;
+    }
+    GameArchiveWriter writer(archiveFile);
+    if (!writer.isOpen()) {
+        std::cerr << "Cannot write " << archiveFile << std::endl;
+        return 1;
+    }
+
+    auto begin = Clock::now();
+    PGNGame pgn;
+    ArchivedGame game;
+    uint64_t moves = 0, skipped = 0;
+    while (reader.next(pgn)) {
+        if (!GameArchive::encode(pgn, game)) {
+            std::cerr << "Skipping game " << reader.getGamesRead() << ": unresolved move" << std::endl;
+            skipped++;
+            continue;
+        }
+        moves += game.moves.size();
+        writer.add(game);
+    }
+    uint64_t games = writer.size();
+    if (!writer.close()) {
+        std::cerr << "Write failed: " << archiveFile << std::endl;
+        return 1;
+    }
+    double encodeSeconds = secondsSince(begin);
+
+    GameArchive archive;
+    if (!archive.open(archiveFile)) {
+        std::cerr << "Cannot read back " << archiveFile << std::endl;
+        return 1;
+    }
+    uint64_t archiveBytes = 0;
+    {
+        std::ifstream in(archiveFile, std::ios::binary | std::ios::ate);
+        archiveBytes = static_cast<uint64_t>(in.tellg());
+    }
+
+    // Decode every game back to moves to measure the read side.
+    begin = Clock::now();
+    std::vector<Move> decoded;
+    uint64_t decodedMoves = 0, bad = 0;
+    for (uint64_t i = 0; i < archive.size(); i++) {
+        if (!archive.read(i, game) || !GameArchive::decode(game, decoded)) {
+            bad++;
+            continue;
+        }
+        decodedMoves += decoded.size();
+    }
+    double decodeSeconds = secondsSince(begin);
+
+    uint64_t pgnBytes = reader.getBytesRead();
+    std::cout << "Games:    " << games << " (" << skipped << " skipped), " << moves << " moves" << std::endl;
+    std::cout << "Size:     " << pgnBytes << " bytes PGN -> " << archiveBytes << " bytes archive ("
+              << static_cast<double>(pgnBytes) / std::max<uint64_t>(archiveBytes, 1) << ":1, "
+              << moves << " bytes of moves)" << std::endl;
+    std::cout << "Encode:   " << encodeSeconds << " s, " << static_cast<long long>(moves / std::max(encodeSeconds, 1e-9))
+              << " moves/s" << std::endl;
+    std::cout << "Decode:   " << decodeSeconds << " s, "
+              << static_cast<long long>(decodedMoves / std::max(decodeSeconds, 1e-9)) << " moves/s"
+              << (bad ? " (" + std::to_string(bad) + " games failed)" : "") << std::endl;
+    return skipped == 0 && bad == 0 && decodedMoves == moves ? 0 : 1;
+}
+
+/**
+ * Converts an archive back to PGN.
+ */
+int ArchiveConverter::unpack(const std::string& archiveFile, const std::string& pgnFile) {
+    GameArchive archive;
+    if (!archive.open(archiveFile)) {
+        std::cerr << "Cannot read archive " << archiveFile << std::endl;
+        return 1;
+    }
+    PGNWriter writer(pgnFile);
+    if (!writer.isOpen()) {
+        std::cerr << "Cannot write " << pgnFile << std::endl;
+        return 1;
+    }
+
+    auto begin = Clock::now();
+    ArchivedGame archived;
+    Game game;
+    uint64_t failed = 0;
+    for (uint64_t i = 0; i < archive.size(); i++) {
+        if (!archive.read(i, archived) || !GameArchive::toGame(archived, game)) {
+            failed++;
+            continue;
+        }
+        writer.write(game, archived.header);
+    }
+    if (!writer.close()) {
+        std::cerr << "Write failed: " << pgnFile << std::endl;
+        return 1;
+    }
+    double seconds = secondsSince(begin);
+    std::cout << "Games:    " << writer.getGamesWritten() << " (" << failed << " failed), "
+              << writer.getBytesWritten() << " bytes PGN" << std::endl;
+    std::cout << "Time:     " << seconds << " s, "
+              << static_cast<long long>(writer.getGamesWritten() / std::max(seconds, 1e-9)) << " games/s" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * Prints one game of an archive as PGN.
+ */
+int ArchiveConverter::show(const std::string& archiveFile, uint64_t index) {
+    GameArchive archive;
+    if (!archive.open(archiveFile)) {
+        std::cerr << "Cannot read archive " << archiveFile << std::endl;
+        return 1;
+    }
+    ArchivedGame archived;
+    Game game;
+    if (!archive.read(index, archived)) {
+        std::cerr << "No game " << index << " (archive has " << archive.size() << ")" << std::endl;
+        return 1;
+    }
+    if (!GameArchive::toGame(archived, game)) {
+        std::cerr << "Game " << index << " is corrupt" << std::endl;
+        return 1;
+    }
+    std::string text;
+    PGNWriter::append(text, game, archived.header);
+    std::cout << text;
+    return 0;
+}
@@ -0,0 +1,373 @@
+#include "archive/GameArchive.h"
+#include "input/MoveParser.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'G', 'A'};
+
+/**
+ * Reads a little-endian integer from the mapped file.
+ */
+template <typename T>
+T readInt(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+/**
+ * Appends a little-endian integer to a record.
+ */
+template <typename T>
+void appendInt(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Appends a string with a one-byte length (longer strings are cut at 255 bytes).
+ */
+void appendString(std::string& out, const std::string& value) {
+    size_t length = std::min<size_t>(value.size(), 255);
+    out += static_cast<char>(length);
+    out.append(value, 0, length);
+}
+
+/**
+ * Reads a one-byte length string, advancing the cursor.
+ */
+bool readString(const char*& cursor, const char* end, std::string& value) {
+    if (cursor >= end) return false;
+    size_t length = static_cast<unsigned char>(*cursor++);
+    if (static_cast<size_t>(end - cursor) < length) return false;
+    value.assign(cursor, length);
+    cursor += length;
+    return true;
+}
+
+/**
+ * Gets a tag value, or "?" if the game does not have it.
+ */
+std::string tagOrUnknown(const PGNGame& pgn, std::string_view name) {
+    std::string_view value = pgn.tag(name);
+    return value.empty() ? "?" : std::string(value);
+}
+
+/**
+ * Sets up a board from a FEN, or the standard start position if it is empty.
+ */
+bool setUp(Board& board, Color& side, const std::string& fen) {
+    int halfmoveClock = 0;
+    int fullmoveNumber = 1;
+    return board.loadFen(fen.empty() ? Game::START_FEN : fen, side, halfmoveClock, fullmoveNumber);
+}
+
+/**
+ * Gets the other side.
+ */
+Color opponent(Color side) {
+    return side == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+} // namespace
+
+/**
+ * Maps an archive file and checks its header.
+ */
+bool GameArchive::open(const std::string& filename) {
+    close();
+    if (!file.open(filename)) return false;
+
+    const char* data = file.data();
+    if (file.size() < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || readInt<uint32_t>(data + 4) != VERSION) {
+        file.close();
+        return false;
+    }
+    gameCount = readInt<uint64_t>(data + 8);
+    indexOffset = readInt<uint64_t>(data + 16);
+    if (indexOffset < HEADER_SIZE || indexOffset > file.size() ||
+        (file.size() - indexOffset) / sizeof(uint64_t) < gameCount) {
+        file.close();
+        gameCount = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Unmaps the file.
+ */
+void GameArchive::close() {
+    file.close();
+    gameCount = 0;
+    indexOffset = 0;
+}
+
+/**
+ * Checks whether an archive is open.
+ */
+bool GameArchive::isOpen() const {
+    return file.isOpen();
+}
+
+/**
+ * Gets the number of games in the archive.
+ */
+uint64_t GameArchive::size() const {
+    return gameCount;
+}
+
+/**
+ * Reads one game through the offset index.
+ */
+bool GameArchive::read(uint64_t index, ArchivedGame& game) const {
+    if (index >= gameCount) return false;
+    uint64_t offset = readInt<uint64_t>(file.data() + indexOffset + index * sizeof(uint64_t));
+    if (offset < HEADER_SIZE || offset >= indexOffset) return false;
+
+    const char* cursor = file.data() + offset;
+    const char* end = file.data() + indexOffset;
+    PGNHeader& header = game.header;
+    for (std::string* field : {&header.event, &header.site, &header.date, &header.round,
+                               &header.white, &header.black, &header.result, &game.startFen}) {
+        if (!readString(cursor, end, *field)) return false;
+    }
+
+    if (end - cursor < 2) return false;
+    uint16_t plies = readInt<uint16_t>(cursor);
+    cursor += 2;
+    if (end - cursor < plies) return false;
+    game.moves.assign(cursor, cursor + plies);
+    return true;
+}
+
+/**
+ * Walks the legal moves of a position in archive order: pieces by square
+ * (a1 first), each piece's moves by Move::encode(). Stops when the visitor
+ * returns false.
+ */
+template <typename Visitor>
+static void forEachLegalMove(const Board& board, Color side, Visitor visit) {
+    const Piece* king = nullptr;
+    const Piece* pieces[16];
+    size_t count = 0;
+    for (const Piece* piece : board.getPieces(side)) {
+        if (piece->getType() == PieceType::KING) king = piece;
+        if (count < 16) pieces[count++] = piece;
+    }
+    if (king == nullptr) return;
+    auto squareOf = [](const Piece* piece) { return piece->getRank() * 8 + piece->getFile(); };
+    std::sort(pieces, pieces + count, [&](const Piece* a, const Piece* b) { return squareOf(a) < squareOf(b); });
+
+    int kingFile = king->getFile();
+    int kingRank = king->getRank();
+    bool inCheck = board.isSquareAttacked(kingFile, kingRank, side == Color::WHITE ? Color::BLACK : Color::WHITE);
+
+    uint16_t codes[64];
+    for (size_t i = 0; i < count; i++) {
+        const Piece* piece = pieces[i];
+        // Out of check, a piece that shares no line with its king cannot be
+        // pinned, so only king moves and en passant still need the full test.
+        int df = piece->getFile() - kingFile;
+        int dr = piece->getRank() - kingRank;
+        bool aligned = df == 0 || dr == 0 || df == dr || df == -dr;
+        bool pawn = piece->getType() == PieceType::PAWN;
+
+        size_t legal = 0;
+        for (const Move& move : piece->getLegalMoves(board)) {
+            if (inCheck || aligned || (pawn && move.getFrom().getFile() != move.getTo().getFile() &&
+                                       board.getPieceAt(move.getTo()) == nullptr)) {
+                if (!board.leavesKingSafe(move, side)) continue;
+            }
+            if (legal < 64) codes[legal++] = move.encode();
+        }
+        std::sort(codes, codes + legal);
+        for (size_t j = 0; j < legal; j++) {
+            if (!visit(codes[j])) return;
+        }
+    }
+}
+
+/**
+ * Generates the legal moves of a position in archive order.
+ */
+std::vector<Move> GameArchive::legalMoves(const Board& board, Color side) {
+    std::vector<Move> moves;
+    forEachLegalMove(board, side, [&](uint16_t code) {
+        moves.push_back(Move::decode(code));
+        return true;
+    });
+    return moves;
+}
+
+/**
+ * Converts a parsed PGN game to move indices.
+ */
+bool GameArchive::encode(const PGNGame& pgn, ArchivedGame& game) {
+    game.header.event = tagOrUnknown(pgn, "Event");
+    game.header.site = tagOrUnknown(pgn, "Site");
+    game.header.date = tagOrUnknown(pgn, "Date");
+    game.header.round = tagOrUnknown(pgn, "Round");
+    game.header.white = tagOrUnknown(pgn, "White");
+    game.header.black = tagOrUnknown(pgn, "Black");
+    std::string_view result = pgn.result.empty() ? pgn.tag("Result") : pgn.result;
+    game.header.result = result.empty() ? "*" : std::string(result);
+    game.startFen = std::string(pgn.tag("FEN"));
+    game.moves.clear();
+
+    Board board;
+    Color side = Color::WHITE;
+    if (!setUp(board, side, game.startFen)) return false;
+    if (pgn.moves.size() > UINT16_MAX) return false;
+
+    for (std::string_view san : pgn.moves) {
+        std::optional<Move> move = MoveParser::resolveSan(san, board, side);
+        if (!move.has_value()) return false;
+
+        // SAN without a piece letter ("e8") promotes to a queen.
+        Move resolved = move.value();
+        Piece* piece = board.getPieceAt(resolved.getFrom());
+        int lastRank = side == Color::WHITE ? 7 : 0;
+        if (!resolved.isPromotion() && piece->getType() == PieceType::PAWN && resolved.getTo().getRank() == lastRank) {
+            resolved = Move(resolved.getFrom(), resolved.getTo(), PieceType::QUEEN);
+        }
+
+        uint16_t target = resolved.encode();
+        int index = 0;
+        bool found = false;
+        forEachLegalMove(board, side, [&](uint16_t code) {
+            found = code == target;
+            if (!found) index++;
+            return !found;
+        });
+        if (!found || index > UINT8_MAX) return false;
+        game.moves.push_back(static_cast<uint8_t>(index));
+
+        board.applyMove(resolved);
+        side = opponent(side);
+    }
+    return true;
+}
+
+/**
+ * Turns stored move indices back into moves.
+ */
+bool GameArchive::decode(const ArchivedGame& game, std::vector<Move>& moves) {
+    moves.clear();
+    Board board;
+    Color side = Color::WHITE;
+    if (!setUp(board, side, game.startFen)) return false;
+
+    for (uint8_t index : game.moves) {
+        // Only the moves up to the stored index need to be generated.
+        int remaining = index;
+        std::optional<Move> move;
+        forEachLegalMove(board, side, [&](uint16_t code) {
+            if (remaining-- > 0) return true;
+            move = Move::decode(code);
+            return false;
+        });
+        if (!move.has_value()) return false;
+        moves.push_back(move.value());
+        board.applyMove(move.value());
+        side = opponent(side);
+    }
+    return true;
+}
+
+/**
+ * Replays an archived game into a Game.
+ */
+bool GameArchive::toGame(const ArchivedGame& archived, Game& game) {
+    game = Game();
+    if (!archived.startFen.empty() && !game.loadFen(archived.startFen)) return false;
+
+    std::vector<Move> moves;
+    if (!decode(archived, moves)) return false;
+    for (const Move& move : moves) {
+        if (!game.makeMove(move)) return false;
+    }
+    return true;
+}
+
+/**
+ * Creates an archive file with a placeholder header.
+ */
+GameArchiveWriter::GameArchiveWriter(const std::string& filename)
+    : file(filename, std::ios::binary | std::ios::trunc) {
+    if (file.is_open()) {
+        char header[GameArchive::HEADER_SIZE] = {};
+        file.write(header, sizeof(header));
+        position = sizeof(header);
+    }
+}
+
+/**
+ * Finishes the file if close() was not called.
+ */
+GameArchiveWriter::~GameArchiveWriter() {
+    close();
+}
+
+/**
+ * Checks whether the file was created.
+ */
+bool GameArchiveWriter::isOpen() const {
+    return file.is_open();
+}
+
+/**
+ * Appends one game record.
+ */
+void GameArchiveWriter::add(const ArchivedGame& game) {
+    if (closed || !file.is_open()) return;
+    const PGNHeader& header = game.header;
+    record.clear();
+    for (const std::string* field : {&header.event, &header.site, &header.date, &header.round,
+                                     &header.white, &header.black, &header.result, &game.startFen}) {
+        appendString(record, *field);
+    }
+    appendInt<uint16_t>(record, static_cast<uint16_t>(game.moves.size()));
+    record.append(game.moves.begin(), game.moves.end());
+
+    offsets.push_back(position);
+    file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    position += record.size();
+}
+
+/**
+ * Writes the offset index and the header.
+ */
+bool GameArchiveWriter::close() {
+    if (closed) return true;
+    closed = true;
+    if (!file.is_open()) return false;
+
+    file.write(reinterpret_cast<const char*>(offsets.data()),
+               static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+
+    uint32_t version = GameArchive::VERSION;
+    uint64_t count = offsets.size();
+    file.seekp(0);
+    file.write(MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(&position), sizeof(position));
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * Gets the number of games added.
+ */
+uint64_t GameArchiveWriter::size() const {
+    return offsets.size();
+}
+
+/**
+ * Gets the number of bytes written so far.
+ */
+uint64_t GameArchiveWriter::bytesWritten() const {
+    return position;
+}
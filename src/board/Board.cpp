@@ -10,15 +10,24 @@
 #include "pieces/Knight.h"
 #include "pieces/Pawn.h"
 
+#include "board/Zobrist.h"
+#include "eval/Evaluator.h"
+
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 
+const int Board::CASTLE_WHITE_KING;
+const int Board::CASTLE_WHITE_QUEEN;
+const int Board::CASTLE_BLACK_KING;
+const int Board::CASTLE_BLACK_QUEEN;
+
 Board::Board()
     : enPassantTarget(0, 0), enPassantAvailable(false),
       whiteKingMoved(false), blackKingMoved(false),
       whiteRookA_Moved(false), whiteRookH_Moved(false),
       blackRookA_Moved(false), blackRookH_Moved(false),
-      lastMove(nullptr) {
+      lastMove(nullptr), midgameScore(0), endgameScore(0), gamePhase(0), pawnKey(0), pieceKey(0), accumulator{} {
     for (int f = 0; f < 8; f++)
         for (int r = 0; r < 8; r++)
             squares[f][r] = nullptr;
@@ -32,7 +41,13 @@ Board::Board(const Board& other)
       whiteRookA_Moved(other.whiteRookA_Moved),
       whiteRookH_Moved(other.whiteRookH_Moved),
       blackRookA_Moved(other.blackRookA_Moved),
-      blackRookH_Moved(other.blackRookH_Moved) {
+      blackRookH_Moved(other.blackRookH_Moved),
+      midgameScore(other.midgameScore),
+      endgameScore(other.endgameScore),
+      gamePhase(other.gamePhase),
+      pawnKey(other.pawnKey),
+      pieceKey(other.pieceKey),
+      accumulator(other.accumulator) {
     for (int f = 0; f < 8; f++) {
         for (int r = 0; r < 8; r++) {
             if (other.squares[f][r]) {
@@ -78,6 +93,12 @@ Board& Board::operator=(const Board& other) {
     whiteRookH_Moved = other.whiteRookH_Moved;
     blackRookA_Moved = other.blackRookA_Moved;
     blackRookH_Moved = other.blackRookH_Moved;
+    midgameScore = other.midgameScore;
+    endgameScore = other.endgameScore;
+    gamePhase = other.gamePhase;
+    pawnKey = other.pawnKey;
+    pieceKey = other.pieceKey;
+    accumulator = other.accumulator;
 
     // 3. Deep copy pieces
     for (int f = 0; f < 8; f++) {
@@ -128,7 +149,251 @@ Piece* Board::getPieceAt(const Square& square) const {
 }
 
 void Board::setPieceAt(const Square& square, Piece* piece) {
-    squares[square.getFile()][square.getRank()] = piece;
+    int f = square.getFile();
+    int r = square.getRank();
+    if (squares[f][r] != nullptr) updateEvalTerms(squares[f][r], f, r, -1);
+    squares[f][r] = piece;
+    if (piece != nullptr) updateEvalTerms(piece, f, r, 1);
+}
+
+void Board::updateEvalTerms(const Piece* piece, int file, int rank, int sign) {
+    PieceType type = piece->getType();
+    Color color = piece->getColor();
+    int side = (color == Color::WHITE) ? sign : -sign;
+    midgameScore += side * Evaluator::midgameValue(type, color, file, rank);
+    endgameScore += side * Evaluator::endgameValue(type, color, file, rank);
+    gamePhase += sign * Evaluator::phaseWeight(type);
+    uint64_t key = Zobrist::pieceKey(type, color, file, rank);
+    pieceKey ^= key;
+    if (type == PieceType::PAWN) pawnKey ^= key;
+    if (Nnue::isLoaded()) Nnue::update(accumulator, type, color, file, rank, sign);
+}
+
+int Board::getMidgameScore() const {
+    return midgameScore;
+}
+
+int Board::getEndgameScore() const {
+    return endgameScore;
+}
+
+int Board::getGamePhase() const {
+    return gamePhase;
+}
+
+uint64_t Board::getPawnKey() const {
+    return pawnKey;
+}
+
+uint64_t Board::getHashKey(Color sideToMove) const {
+    uint64_t key = pieceKey ^ Zobrist::castlingKey(getCastlingRights());
+    if (enPassantAvailable) key ^= Zobrist::enPassantKey(enPassantTarget.getFile());
+    if (sideToMove == Color::BLACK) key ^= Zobrist::sideKey();
+    return key;
+}
+
+int Board::getCastlingRights() const {
+    int rights = 0;
+    if (!whiteKingMoved && !whiteRookH_Moved) rights |= CASTLE_WHITE_KING;
+    if (!whiteKingMoved && !whiteRookA_Moved) rights |= CASTLE_WHITE_QUEEN;
+    if (!blackKingMoved && !blackRookH_Moved) rights |= CASTLE_BLACK_KING;
+    if (!blackKingMoved && !blackRookA_Moved) rights |= CASTLE_BLACK_QUEEN;
+    return rights;
+}
+
+namespace {
+
+/**
+ * Splits off the next space-separated field of a FEN string.
+ */
+std::string_view nextField(std::string_view& rest) {
+    size_t start = rest.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        rest = std::string_view();
+        return rest;
+    }
+    rest.remove_prefix(start);
+    size_t end = std::min(rest.find(' '), rest.size());
+    std::string_view field = rest.substr(0, end);
+    rest.remove_prefix(end);
+    return field;
+}
+
+/**
+ * Parses a non-negative decimal field; empty fields give the fallback.
+ */
+bool parseCount(std::string_view field, int fallback, int& value) {
+    if (field.empty()) {
+        value = fallback;
+        return true;
+    }
+    value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9' || value > 100000) return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+/**
+ * Creates a piece from its FEN letter (upper case = White).
+ */
+Piece* makePiece(char letter, int file, int rank) {
+    Color color = std::isupper(static_cast<unsigned char>(letter)) ? Color::WHITE : Color::BLACK;
+    switch (std::toupper(static_cast<unsigned char>(letter))) {
+        case 'K': return new King(color, file, rank);
+        case 'Q': return new Queen(color, file, rank);
+        case 'R': return new Rook(color, file, rank);
+        case 'B': return new Bishop(color, file, rank);
+        case 'N': return new Knight(color, file, rank);
+        default:  return new Pawn(color, file, rank);
+    }
+}
+
+} // namespace
+
+bool Board::loadFen(std::string_view fen, Color& sideToMove, int& halfmoveClock, int& fullmoveNumber) {
+    std::string_view rest = fen;
+    std::string_view placement = nextField(rest);
+    std::string_view side = nextField(rest);
+    std::string_view castling = nextField(rest);
+    std::string_view enPassant = nextField(rest);
+    std::string_view halfmoves = nextField(rest);
+    std::string_view fullmoves = nextField(rest);
+    if (!nextField(rest).empty()) return false;
+
+    // Piece placement, rank 8 first, into a scratch grid.
+    char grid[8][8] = {};
+    int file = 0, rank = 7;
+    int kings[2] = { 0, 0 };
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) return false;
+            file = 0;
+            rank--;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return false;
+        } else {
+            char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            if (file >= 8 || !charToPieceType(upper).has_value()) return false;
+            if (upper == 'P' && (rank == 0 || rank == 7)) return false;
+            if (upper == 'K') kings[std::isupper(static_cast<unsigned char>(c)) ? 0 : 1]++;
+            grid[file++][rank] = c;
+        }
+    }
+    if (file != 8 || rank != 0 || kings[0] != 1 || kings[1] != 1) return false;
+
+    Color turn;
+    if (side == "w") turn = Color::WHITE;
+    else if (side == "b") turn = Color::BLACK;
+    else return false;
+
+    // Rights whose king or rook is not at home are dropped rather than rejected.
+    int rights = 0;
+    if (castling != "-") {
+        for (char c : castling) {
+            switch (c) {
+                case 'K': if (grid[4][0] == 'K' && grid[7][0] == 'R') rights |= CASTLE_WHITE_KING; break;
+                case 'Q': if (grid[4][0] == 'K' && grid[0][0] == 'R') rights |= CASTLE_WHITE_QUEEN; break;
+                case 'k': if (grid[4][7] == 'k' && grid[7][7] == 'r') rights |= CASTLE_BLACK_KING; break;
+                case 'q': if (grid[4][7] == 'k' && grid[0][7] == 'r') rights |= CASTLE_BLACK_QUEEN; break;
+                default: return false;
+            }
+        }
+    }
+
+    std::optional<Square> epTarget;
+    if (enPassant != "-") {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' ||
+            enPassant[1] != (turn == Color::WHITE ? '6' : '3')) {
+            return false;
+        }
+        // Only kept if the pawn that just advanced two squares is there.
+        int epFile = enPassant[0] - 'a';
+        int pawnRank = turn == Color::WHITE ? 4 : 3;
+        if (grid[epFile][pawnRank] == (turn == Color::WHITE ? 'p' : 'P')) {
+            epTarget = Square(epFile, enPassant[1] - '1');
+        }
+    }
+
+    int halfmove, fullmove;
+    if (!parseCount(halfmoves, 0, halfmove) || !parseCount(fullmoves, 1, fullmove)) return false;
+
+    // Valid: replace the position.
+    for (int f = 0; f < 8; f++)
+        for (int r = 0; r < 8; r++)
+            removePieceAt(f, r);
+    for (int f = 0; f < 8; f++)
+        for (int r = 0; r < 8; r++)
+            if (grid[f][r] != 0) placePiece(makePiece(grid[f][r], f, r));
+
+    whiteKingMoved = (rights & (CASTLE_WHITE_KING | CASTLE_WHITE_QUEEN)) == 0;
+    whiteRookH_Moved = (rights & CASTLE_WHITE_KING) == 0;
+    whiteRookA_Moved = (rights & CASTLE_WHITE_QUEEN) == 0;
+    blackKingMoved = (rights & (CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN)) == 0;
+    blackRookH_Moved = (rights & CASTLE_BLACK_KING) == 0;
+    blackRookA_Moved = (rights & CASTLE_BLACK_QUEEN) == 0;
+
+    // En passant captures are recognised from the last move, so recreate the
+    // double pawn push that produced the target square.
+    delete lastMove;
+    lastMove = nullptr;
+    enPassantAvailable = epTarget.has_value();
+    if (epTarget.has_value()) {
+        enPassantTarget = epTarget.value();
+        int direction = turn == Color::WHITE ? -1 : 1;  // direction the pawn moved
+        int target = enPassantTarget.getRank();
+        lastMove = new Move(Square(enPassantTarget.getFile(), target - direction),
+                            Square(enPassantTarget.getFile(), target + direction));
+    }
+
+    sideToMove = turn;
+    halfmoveClock = halfmove;
+    fullmoveNumber = std::max(1, fullmove);
+    return true;
+}
+
+std::string Board::toFen(Color sideToMove, int halfmoveClock, int fullmoveNumber) const {
+    std::string fen;
+    fen.reserve(90);
+    for (int r = 7; r >= 0; r--) {
+        int empty = 0;
+        for (int f = 0; f < 8; f++) {
+            const Piece* piece = squares[f][r];
+            if (piece == nullptr) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            char letter = pieceTypeToChar(piece->getType());
+            fen += piece->getColor() == Color::WHITE ? letter : static_cast<char>(std::tolower(letter));
+        }
+        if (empty > 0) fen += static_cast<char>('0' + empty);
+        if (r > 0) fen += '/';
+    }
+
+    fen += sideToMove == Color::WHITE ? " w " : " b ";
+    int rights = getCastlingRights();
+    if (rights == 0) fen += '-';
+    if (rights & CASTLE_WHITE_KING) fen += 'K';
+    if (rights & CASTLE_WHITE_QUEEN) fen += 'Q';
+    if (rights & CASTLE_BLACK_KING) fen += 'k';
+    if (rights & CASTLE_BLACK_QUEEN) fen += 'q';
+
+    fen += ' ';
+    fen += enPassantAvailable ? enPassantTarget.toString() : "-";
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+    return fen;
+}
+
+const NnueAccumulator& Board::getAccumulator() const {
+    return accumulator;
+}
+
+void Board::refreshAccumulator() {
+    accumulator = Nnue::computeAccumulator(*this);
 }
 
 bool Board::isInBounds(const Square& square) const {
@@ -203,7 +468,7 @@ bool Board::isEnemy(int file, int rank, Color myColor) const {
 }
 
 void Board::placePiece(Piece* piece) {
-    squares[piece->getFile()][piece->getRank()] = piece;
+    setPieceAt(Square(piece->getFile(), piece->getRank()), piece);
     if (piece->getColor() == Color::WHITE)
         whitePieces.push_back(piece);
     else
@@ -216,8 +481,8 @@ void Board::removePieceAt(int file, int rank) {
     if (!p) return;
     auto& vec = (p->getColor() == Color::WHITE) ? whitePieces : blackPieces;
     vec.erase(std::remove(vec.begin(), vec.end(), p), vec.end());
+    setPieceAt(Square(file, rank), nullptr);
     delete p;
-    squares[file][rank] = nullptr;
 }
 
 bool Board::sameSquare(const Square& a, const Square& b) const {
@@ -267,13 +532,13 @@ bool Board::isEnPassantMove(const Move& move, const Piece* moving) const {
     return false;
 }
 
-Piece* Board::applyMove(const Move& move) {
+std::optional<PieceType> Board::applyMove(const Move& move) {
     Square from = move.getFrom();
     Square to = move.getTo();
-    if (!isInBounds(from) || !isInBounds(to)) return nullptr;
+    if (!isInBounds(from) || !isInBounds(to)) return std::nullopt;
 
     Piece* moving = getPieceAt(from);
-    if (moving == nullptr) return nullptr;
+    if (moving == nullptr) return std::nullopt;
 
     Piece* captured = nullptr;
 
@@ -313,6 +578,9 @@ Piece* Board::applyMove(const Move& move) {
         }
     }
 
+    // Decide this before a promotion replaces (and deletes) the moving pawn.
+    bool doublePawnPush = moving->getType() == PieceType::PAWN && std::abs(to.getRank() - from.getRank()) == 2;
+
     // Handle pawn promotion
     PieceType promoType = move.getPromotion().value_or(PieceType::PAWN);
     if (move.getPromotion().has_value() && moving->getType() == PieceType::PAWN) {
@@ -326,18 +594,62 @@ Piece* Board::applyMove(const Move& move) {
             case PieceType::KNIGHT: promoted = new Knight(moving->getColor(), file, rank); break;
             default: promoted = new Queen(moving->getColor(), file, rank); break;
         }
-        setPieceAt(to, promoted);
+        replacePiece(moving, promoted);
     } else if (isPawnPromotion(moving, to)) {
         // Auto-promote to Queen if no promotion specified
         Piece* promoted = new Queen(moving->getColor(), to.getFile(), to.getRank());
-        setPieceAt(to, promoted);
+        replacePiece(moving, promoted);
+    }
+
+    // Update castling rights: a king or rook leaving its home square, or a
+    // rook being captured on it, loses the corresponding right.
+    updateCastlingRights(from);
+    updateCastlingRights(to);
+
+    // Update en passant target for the next move
+    enPassantAvailable = false;
+    if (doublePawnPush) {
+        enPassantTarget = Square(to.getFile(), (from.getRank() + to.getRank()) / 2);
+        enPassantAvailable = true;
     }
 
     // Update lastMove
     delete lastMove;
     lastMove = new Move(from, to);
 
-    return captured;
+    if (captured == nullptr) return std::nullopt;
+
+    PieceType capturedType = captured->getType();
+    detachPiece(captured);
+    delete captured;
+    return capturedType;
+}
+
+void Board::detachPiece(Piece* piece) {
+    auto& vec = (piece->getColor() == Color::WHITE) ? whitePieces : blackPieces;
+    vec.erase(std::remove(vec.begin(), vec.end(), piece), vec.end());
+}
+
+void Board::replacePiece(Piece* oldPiece, Piece* newPiece) {
+    setPieceAt(Square(newPiece->getFile(), newPiece->getRank()), newPiece);
+    detachPiece(oldPiece);
+    delete oldPiece;
+    auto& vec = (newPiece->getColor() == Color::WHITE) ? whitePieces : blackPieces;
+    vec.push_back(newPiece);
+}
+
+void Board::updateCastlingRights(const Square& square) {
+    int f = square.getFile();
+    int r = square.getRank();
+    if (r == 0) {
+        if (f == 4) whiteKingMoved = true;
+        if (f == 0) whiteRookA_Moved = true;
+        if (f == 7) whiteRookH_Moved = true;
+    } else if (r == 7) {
+        if (f == 4) blackKingMoved = true;
+        if (f == 0) blackRookA_Moved = true;
+        if (f == 7) blackRookH_Moved = true;
+    }
 }
 
 bool Board::isSquareAttacked(const Square& target, Color byColor) const {
@@ -452,38 +764,38 @@ void Board::makeMove(const Move& move) {
 
         bool kingSide = to.getFile() > from.getFile();
 
-        squares[from.getFile()][from.getRank()] = nullptr;
+        setPieceAt(from, nullptr);
         piece->setPosition(to.getFile(), to.getRank());
-        squares[to.getFile()][to.getRank()] = piece;
+        setPieceAt(to, piece);
 
         if (piece->getColor() == Color::WHITE) {
             whiteKingMoved = true;
             if (kingSide) {
                 Piece* rook = getPieceAt(7, 0);
-                squares[7][0] = nullptr;
+                setPieceAt(Square(7, 0), nullptr);
                 rook->setPosition(5, 0);
-                squares[5][0] = rook;
+                setPieceAt(Square(5, 0), rook);
                 whiteRookH_Moved = true;
             } else {
                 Piece* rook = getPieceAt(0, 0);
-                squares[0][0] = nullptr;
+                setPieceAt(Square(0, 0), nullptr);
                 rook->setPosition(3, 0);
-                squares[3][0] = rook;
+                setPieceAt(Square(3, 0), rook);
                 whiteRookA_Moved = true;
             }
         } else {
             blackKingMoved = true;
             if (kingSide) {
                 Piece* rook = getPieceAt(7, 7);
-                squares[7][7] = nullptr;
+                setPieceAt(Square(7, 7), nullptr);
                 rook->setPosition(5, 7);
-                squares[5][7] = rook;
+                setPieceAt(Square(5, 7), rook);
                 blackRookH_Moved = true;
             } else {
                 Piece* rook = getPieceAt(0, 7);
-                squares[0][7] = nullptr;
+                setPieceAt(Square(0, 7), nullptr);
                 rook->setPosition(3, 7);
-                squares[3][7] = rook;
+                setPieceAt(Square(3, 7), rook);
                 blackRookA_Moved = true;
             }
         }
@@ -510,7 +822,7 @@ void Board::makeMove(const Move& move) {
     }
 
     removePieceAt(to.getFile(), to.getRank());
-    squares[from.getFile()][from.getRank()] = nullptr;
+    setPieceAt(from, nullptr);
 
     if (piece->getType() == PieceType::PAWN && move.isPromotion()) {
         Color color = piece->getColor();
@@ -527,13 +839,13 @@ void Board::makeMove(const Move& move) {
             default: newPiece = new Queen(color, to.getFile(), to.getRank()); break;
         }
 
-        squares[to.getFile()][to.getRank()] = newPiece;
+        setPieceAt(to, newPiece);
         vec.push_back(newPiece);
         return;
     }
 
     piece->setPosition(to.getFile(), to.getRank());
-    squares[to.getFile()][to.getRank()] = piece;
+    setPieceAt(to, piece);
 }
 
 void Board::undoMove(const Move& move, Piece* captured, Square from, Square to) {
@@ -560,6 +872,83 @@ bool Board::isLegalMove(const Move& move, Color turn) const {
     );
 }
 
+bool Board::leavesKingSafe(const Move& move, Color turn) const {
+    int fromFile = move.getFrom().getFile(), fromRank = move.getFrom().getRank();
+    int toFile = move.getTo().getFile(), toRank = move.getTo().getRank();
+    const Piece* moving = squares[fromFile][fromRank];
+    if (moving == nullptr) return false;
+    PieceType movingType = moving->getType();
+    bool enPassant = movingType == PieceType::PAWN && fromFile != toFile && squares[toFile][toRank] == nullptr;
+
+    int kingFile = toFile;
+    int kingRank = toRank;
+    if (movingType != PieceType::KING) {
+        const Piece* king = nullptr;
+        for (const Piece* p : turn == Color::WHITE ? whitePieces : blackPieces) {
+            if (p->getType() == PieceType::KING) king = p;
+        }
+        if (king == nullptr) return false;
+        kingFile = king->getFile();
+        kingRank = king->getRank();
+    }
+
+    // Enemy piece on a square once the move is made: the from square and an
+    // en passant victim are empty, the to square holds the mover.
+    auto enemyAt = [&](int file, int rank) -> const Piece* {
+        if (file == toFile && rank == toRank) return nullptr;
+        if (file == fromFile && rank == fromRank) return nullptr;
+        if (enPassant && file == toFile && rank == fromRank) return nullptr;
+        const Piece* p = squares[file][rank];
+        return p != nullptr && p->getColor() != turn ? p : nullptr;
+    };
+    auto occupied = [&](int file, int rank) {
+        if (file == toFile && rank == toRank) return true;
+        if (file == fromFile && rank == fromRank) return false;
+        if (enPassant && file == toFile && rank == fromRank) return false;
+        return squares[file][rank] != nullptr;
+    };
+    auto inside = [](int file, int rank) { return file >= 0 && file < 8 && rank >= 0 && rank < 8; };
+
+    static const int knightSteps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    static const int kingSteps[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+    for (const auto& step : knightSteps) {
+        int f = kingFile + step[0], r = kingRank + step[1];
+        if (!inside(f, r)) continue;
+        const Piece* p = enemyAt(f, r);
+        if (p != nullptr && p->getType() == PieceType::KNIGHT) return false;
+    }
+
+    // Enemy pawns attack the king from the rank in front of it.
+    int pawnRank = kingRank + (turn == Color::WHITE ? 1 : -1);
+    for (int f = kingFile - 1; f <= kingFile + 1; f += 2) {
+        if (!inside(f, pawnRank)) continue;
+        const Piece* p = enemyAt(f, pawnRank);
+        if (p != nullptr && p->getType() == PieceType::PAWN) return false;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        bool diagonal = i >= 4;
+        int f = kingFile + kingSteps[i][0];
+        int r = kingRank + kingSteps[i][1];
+        for (int distance = 1; inside(f, r); distance++) {
+            if (occupied(f, r)) {
+                const Piece* p = enemyAt(f, r);
+                if (p != nullptr) {
+                    PieceType type = p->getType();
+                    if (type == PieceType::QUEEN) return false;
+                    if (type == (diagonal ? PieceType::BISHOP : PieceType::ROOK)) return false;
+                    if (type == PieceType::KING && distance == 1) return false;
+                }
+                break;
+            }
+            f += kingSteps[i][0];
+            r += kingSteps[i][1];
+        }
+    }
+    return true;
+}
+
 bool Board::canCastleKingSide(Color turn) const {
     if (turn == Color::WHITE) {
         if (whiteKingMoved || whiteRookH_Moved) return false;
@@ -1,4 +1,5 @@
 #include "board/Move.h"
+#include <cctype>
 
 /**
  * Creates a new Move without promotion.
@@ -38,4 +39,51 @@ std::optional<PieceType> Move::getPromotion() const {
  */
 bool Move::isPromotion() const {
     return promotion.has_value();
-}
\ No newline at end of file
+}
+
+/**
+ * Checks equality with another move (squares and promotion).
+ */
+bool Move::operator==(const Move& other) const {
+    return from == other.from && to == other.to && promotion == other.promotion;
+}
+
+/**
+ * Checks inequality with another move.
+ */
+bool Move::operator!=(const Move& other) const {
+    return !(*this == other);
+}
+
+/**
+ * Packs the move into 16 bits.
+ */
+uint16_t Move::encode() const {
+    int fromIndex = from.getRank() * 8 + from.getFile();
+    int toIndex = to.getRank() * 8 + to.getFile();
+    int promo = promotion.has_value() ? static_cast<int>(promotion.value()) + 1 : 0;
+    return static_cast<uint16_t>(fromIndex | (toIndex << 6) | (promo << 12));
+}
+
+/**
+ * Unpacks a move produced by encode().
+ */
+Move Move::decode(uint16_t code) {
+    int fromIndex = code & 63;
+    int toIndex = (code >> 6) & 63;
+    int promo = (code >> 12) & 7;
+    std::optional<PieceType> promotion = std::nullopt;
+    if (promo != 0) promotion = static_cast<PieceType>(promo - 1);
+    return Move(Square(fromIndex & 7, fromIndex >> 3), Square(toIndex & 7, toIndex >> 3), promotion);
+}
+
+/**
+ * Converts the move to coordinate notation.
+ */
+std::string Move::toString() const {
+    std::string s = from.toString() + to.toString();
+    if (promotion.has_value()) {
+        s += static_cast<char>(std::tolower(pieceTypeToChar(promotion.value())));
+    }
+    return s;
+}
@@ -0,0 +1,63 @@
+#include "board/Zobrist.h"
+
+namespace {
+
+/**
+ * Key table filled from a splitmix64 sequence with a fixed seed.
+ */
+struct ZobristTable {
+    uint64_t pieces[2][6][64];
+    uint64_t side;
+    uint64_t castling[16];
+    uint64_t enPassant[8];
+
+    ZobristTable() {
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto& color : pieces)
+            for (auto& type : color)
+                for (uint64_t& key : type)
+                    key = next(state);
+        side = next(state);
+        for (uint64_t& key : castling) key = next(state);
+        for (uint64_t& key : enPassant) key = next(state);
+    }
+
+    static uint64_t next(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+const ZobristTable TABLE;
+
+} // namespace
+
+/**
+ * Gets the key for a piece of the given type and color on a square.
+ */
+uint64_t Zobrist::pieceKey(PieceType type, Color color, int file, int rank) {
+    return TABLE.pieces[static_cast<int>(color)][static_cast<int>(type)][rank * 8 + file];
+}
+
+/**
+ * Gets the key XOR-ed in when Black is to move.
+ */
+uint64_t Zobrist::sideKey() {
+    return TABLE.side;
+}
+
+/**
+ * Gets the key for a set of castling rights.
+ */
+uint64_t Zobrist::castlingKey(int rights) {
+    return TABLE.castling[rights & 15];
+}
+
+/**
+ * Gets the key for an en passant target on the given file.
+ */
+uint64_t Zobrist::enPassantKey(int file) {
+    return TABLE.enPassant[file];
+}
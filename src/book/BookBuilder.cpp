@@ -0,0 +1,92 @@
+#include "book/BookBuilder.h"
+#include "book/OpeningBook.h"
+#include "game/Game.h"
+#include "input/PGNHandler.h"
+#include "input/PGNReader.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <utility>
+
+namespace {
+
+/**
+ * Appends a big-endian unsigned integer of the given width.
+ */
+void writeBigEndian(std::vector<char>& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+} // namespace
+
+/**
+ * Builds a book from PGN files.
+ */
+int BookBuilder::build(const std::vector<std::string>& pgnFiles, const std::string& bookFile, int maxPlies) {
+    // (key, Polyglot move) -> accumulated weight
+    std::map<std::pair<uint64_t, uint16_t>, uint64_t> weights;
+    int games = 0, failed = 0;
+
+    for (const std::string& filename : pgnFiles) {
+        PGNReader reader(filename);
+        if (!reader.isOpen()) {
+            std::cerr << "Cannot read " << filename << std::endl;
+            return 1;
+        }
+
+        PGNGame pgn;
+        while (reader.next(pgn)) {
+            std::string_view result = pgn.tag("Result");
+            if (result.empty()) result = pgn.result;
+            int ply = 0;
+            auto onMove = [&](const Game& game, const Move& move) {
+                if (ply++ >= maxPlies) return;
+                Color side = game.getCurrentPlayer();
+                bool won = (result == "1-0" && side == Color::WHITE) || (result == "0-1" && side == Color::BLACK);
+                bool lost = (result == "1-0" && side == Color::BLACK) || (result == "0-1" && side == Color::WHITE);
+                uint64_t key = OpeningBook::key(game.getBoard(), side);
+                uint16_t code = OpeningBook::encodeMove(game.getBoard(), move);
+                weights[{ key, code }] += won ? 2 : lost ? 0 : 1;
+            };
+
+            Game game;
+            if (!PGNHandler::replay(game, pgn, onMove)) failed++;
+            games++;
+        }
+    }
+
+    // Scale each position's weights so the largest fits in 16 bits.
+    std::vector<char> out;
+    size_t entries = 0;
+    for (auto it = weights.begin(); it != weights.end();) {
+        auto last = it;
+        uint64_t largest = 0;
+        while (last != weights.end() && last->first.first == it->first.first) {
+            largest = std::max(largest, last->second);
+            ++last;
+        }
+        for (; it != last; ++it) {
+            uint64_t weight = largest > 0xFFFF ? it->second * 0xFFFF / largest : it->second;
+            if (weight == 0) continue;
+            writeBigEndian(out, it->first.first, 8);
+            writeBigEndian(out, it->first.second, 2);
+            writeBigEndian(out, weight, 2);
+            writeBigEndian(out, 0, 4);
+            entries++;
+        }
+    }
+
+    std::ofstream book(bookFile, std::ios::binary);
+    if (!book.is_open()) {
+        std::cerr << "Cannot write " << bookFile << std::endl;
+        return 1;
+    }
+    book.write(out.data(), out.size());
+
+    std::cout << "Read " << games << " game(s)" << (failed ? " (" + std::to_string(failed) + " with bad moves)" : "")
+              << ", wrote " << entries << " entries to " << bookFile << std::endl;
+    return book.good() ? 0 : 1;
+}
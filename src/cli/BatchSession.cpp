@@ -0,0 +1,319 @@
+#include "cli/BatchSession.h"
+#include "eval/Evaluator.h"
+#include "game/Game.h"
+#include "input/MoveParser.h"
+#include "pieces/Piece.h"
+#include "tools/Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const size_t BatchSession::READ_SIZE;
+const int BatchSession::DEFAULT_DEPTH;
+
+namespace {
+
+/**
+ * Splits a line into words at spaces and tabs.
+ */
+std::vector<std::string_view> splitWords(std::string_view line) {
+    std::vector<std::string_view> words;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t start = line.find_first_not_of(" \t\r", pos);
+        if (start == std::string_view::npos) break;
+        size_t end = line.find_first_of(" \t\r", start);
+        if (end == std::string_view::npos) end = line.size();
+        words.push_back(line.substr(start, end - start));
+        pos = end;
+    }
+    return words;
+}
+
+/**
+ * Appends a string quoted for JSON.
+ */
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * Appends a JSON array of moves in coordinate notation.
+ */
+void appendMoves(std::string& out, const std::vector<Move>& moves) {
+    out += '[';
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (i > 0) out += ',';
+        out += '"';
+        out += moves[i].toString();
+        out += '"';
+    }
+    out += ']';
+}
+
+/**
+ * Appends an error answer and ends the line.
+ */
+void appendError(std::string& out, std::string_view command, std::string_view message) {
+    out += "{\"cmd\":";
+    appendJsonString(out, command);
+    out += ",\"ok\":false,\"error\":";
+    appendJsonString(out, message);
+    out += "}\n";
+}
+
+/**
+ * Parses a non-negative number, or returns -1.
+ */
+long long parseNumber(std::string_view text) {
+    if (text.empty() || text.size() > 18) return -1;
+    long long value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return -1;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+/**
+ * Writes a buffer to stdout and flushes it.
+ */
+void writeOut(const std::string& out) {
+    if (out.empty()) return;
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+/**
+ * Creates a session at the start position.
+ */
+BatchSession::BatchSession()
+    : sideToMove(Color::WHITE), halfmoveClock(0), fullmoveNumber(1), table(16), search(table) {
+    board.loadFen(Game::START_FEN, sideToMove, halfmoveClock, fullmoveNumber);
+}
+
+/**
+ * Finds a legal move given in coordinate notation or SAN.
+ */
+std::optional<Move> BatchSession::findMove(std::string_view text, const std::vector<Move>& legal) const {
+    for (const Move& move : legal) {
+        if (move.toString() == text) return move;
+    }
+
+    // SAN, and coordinate moves without a promotion letter, promote to a queen.
+    std::optional<Move> parsed = MoveParser::parse(text, board, sideToMove).move;
+    if (!parsed.has_value()) return std::nullopt;
+    PieceType promotion = parsed->getPromotion().value_or(PieceType::QUEEN);
+    for (const Move& move : legal) {
+        if (move.getFrom() == parsed->getFrom() && move.getTo() == parsed->getTo() &&
+            move.getPromotion().value_or(PieceType::QUEEN) == promotion) {
+            return move;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Plays a legal move and updates the side to move and move counters.
+ */
+void BatchSession::play(const Move& move) {
+    const Piece* moving = board.getPieceAt(move.getFrom());
+    bool pawnMove = moving != nullptr && moving->getType() == PieceType::PAWN;
+    bool capture = board.applyMove(move).has_value();
+    halfmoveClock = pawnMove || capture ? 0 : halfmoveClock + 1;
+    if (sideToMove == Color::BLACK) fullmoveNumber++;
+    sideToMove = sideToMove == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+/**
+ * Executes one command and appends its JSON answer.
+ */
+void BatchSession::execute(std::string_view line, std::string& out) {
+    std::vector<std::string_view> words = splitWords(line);
+    if (words.empty() || words[0][0] == '#') return;
+    std::string_view command = words[0];
+
+    if (command == "fen" && words.size() > 1) {
+        // The rest of the line, without the "\r" of CRLF input or trailing blanks.
+        std::string_view fen = line.substr(words[1].data() - line.data());
+        fen = fen.substr(0, fen.find_last_not_of(" \t\r") + 1);
+        Board position;
+        Color side = Color::WHITE;
+        int halfmoves = 0;
+        int fullmoves = 1;
+        if (!position.loadFen(fen, side, halfmoves, fullmoves)) {
+            appendError(out, command, "invalid FEN");
+            return;
+        }
+        board = position;
+        sideToMove = side;
+        halfmoveClock = halfmoves;
+        fullmoveNumber = fullmoves;
+        out += "{\"cmd\":\"fen\",\"ok\":true}\n";
+    } else if (command == "startpos") {
+        board.loadFen(Game::START_FEN, sideToMove, halfmoveClock, fullmoveNumber);
+        out += "{\"cmd\":\"startpos\",\"ok\":true}\n";
+    } else if (command == "fen") {
+        out += "{\"cmd\":\"fen\",\"ok\":true,\"fen\":";
+        appendJsonString(out, board.toFen(sideToMove, halfmoveClock, fullmoveNumber));
+        out += "}\n";
+    } else if (command == "moves") {
+        // Moves up to an illegal one stay played; "played" tells how many.
+        size_t played = 0;
+        for (size_t i = 1; i < words.size(); i++) {
+            std::optional<Move> move = findMove(words[i], Search::generateLegalMoves(board, sideToMove));
+            if (!move.has_value()) {
+                out += "{\"cmd\":\"moves\",\"ok\":false,\"played\":" + std::to_string(played) + ",\"error\":";
+                appendJsonString(out, "illegal move " + std::string(words[i]));
+                out += "}\n";
+                return;
+            }
+            play(move.value());
+            played++;
+        }
+        out += "{\"cmd\":\"moves\",\"ok\":true,\"played\":" + std::to_string(played) + "}\n";
+    } else if (command == "legal") {
+        if (words.size() > 2 || (words.size() == 2 && words[1] != "moves")) {
+            appendError(out, command, "expected legal moves");
+            return;
+        }
+        std::vector<Move> legal = Search::generateLegalMoves(board, sideToMove);
+        out += "{\"cmd\":\"legal moves\",\"ok\":true,\"count\":" + std::to_string(legal.size()) + ",\"moves\":";
+        appendMoves(out, legal);
+        out += "}\n";
+    } else if (command == "is" && words.size() == 2) {
+        std::string_view query = words[1];
+        if (query != "check" && query != "checkmate" && query != "stalemate") {
+            appendError(out, command, "expected check, checkmate or stalemate");
+            return;
+        }
+        // Mate needs check, stalemate needs no check; only then count moves.
+        bool check = Search::isInCheck(board, sideToMove);
+        bool answer = check;
+        if (query != "check") {
+            answer = check == (query == "checkmate") && Search::generateLegalMoves(board, sideToMove).empty();
+        }
+        out += "{\"cmd\":\"is ";
+        out += query;
+        out += "\",\"ok\":true,\"result\":";
+        out += answer ? "true" : "false";
+        out += "}\n";
+    } else if (command == "status") {
+        bool check = Search::isInCheck(board, sideToMove);
+        size_t legal = Search::generateLegalMoves(board, sideToMove).size();
+        out += "{\"cmd\":\"status\",\"ok\":true,\"side\":";
+        out += sideToMove == Color::WHITE ? "\"white\"" : "\"black\"";
+        out += ",\"check\":";
+        out += check ? "true" : "false";
+        out += ",\"checkmate\":";
+        out += check && legal == 0 ? "true" : "false";
+        out += ",\"stalemate\":";
+        out += !check && legal == 0 ? "true" : "false";
+        out += ",\"legal\":" + std::to_string(legal) + ",\"halfmove\":" + std::to_string(halfmoveClock) + "}\n";
+    } else if (command == "eval") {
+        out += "{\"cmd\":\"eval\",\"ok\":true,\"score\":" +
+               std::to_string(Evaluator::evaluate(board, sideToMove)) + "}\n";
+    } else if (command == "best") {
+        SearchLimits limits;
+        limits.depth = DEFAULT_DEPTH;
+        bool depthGiven = false;
+        size_t i = words.size() > 1 && words[1] == "move" ? 2 : 1;
+        for (; i + 1 < words.size(); i += 2) {
+            long long value = parseNumber(words[i + 1]);
+            if (value <= 0) break;
+            if (words[i] == "depth") {
+                limits.depth = static_cast<int>(std::min<long long>(value, Search::MAX_DEPTH));
+                depthGiven = true;
+            } else if (words[i] == "nodes") limits.nodes = static_cast<uint64_t>(value);
+            else if (words[i] == "time") limits.time.softMs = limits.time.hardMs = static_cast<int>(std::min<long long>(value, 1000000000));
+            else break;
+        }
+        if (i != words.size()) {
+            appendError(out, "best move", "expected depth <n>, nodes <n> or time <ms>");
+            return;
+        }
+        // Limited by nodes or time only: search as deep as they allow.
+        if ((limits.nodes != 0 || limits.time.hardMs != 0) && !depthGiven) {
+            limits.depth = Search::MAX_DEPTH;
+        }
+
+        SearchResult result = search.run(board, sideToMove, limits);
+        out += "{\"cmd\":\"best move\",\"ok\":true,\"move\":";
+        if (result.bestMove.has_value()) {
+            appendJsonString(out, result.bestMove->toString());
+        } else {
+            out += "null";
+        }
+        out += ",\"score\":" + std::to_string(result.score);
+        if (Search::isMateScore(result.score)) {
+            int plies = Search::MATE_SCORE - std::abs(result.score);
+            out += ",\"mate\":" + std::to_string(result.score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+        }
+        out += ",\"depth\":" + std::to_string(result.depth) + ",\"nodes\":" + std::to_string(result.nodes) +
+               ",\"time_ms\":" + std::to_string(result.timeMs) + ",\"pv\":";
+        appendMoves(out, result.pv);
+        out += "}\n";
+    } else if (command == "perft" && words.size() == 2 && parseNumber(words[1]) > 0) {
+        int depth = static_cast<int>(std::min<long long>(parseNumber(words[1]), 10));
+        out += "{\"cmd\":\"perft\",\"ok\":true,\"depth\":" + std::to_string(depth) +
+               ",\"nodes\":" + std::to_string(Benchmark::perft(board, sideToMove, depth)) + "}\n";
+    } else {
+        appendError(out, command, "unknown command: " + std::string(line.substr(command.data() - line.data())));
+    }
+}
+
+/**
+ * Answers commands from stdin until end of input, one write per read.
+ */
+int BatchSession::run() {
+    std::vector<char> buffer(READ_SIZE);
+    std::string pending;  // incomplete last line of the previous read
+    std::string out;
+
+    while (true) {
+#ifdef _WIN32
+        int count = _read(0, buffer.data(), static_cast<unsigned>(buffer.size()));
+#else
+        ssize_t count = read(0, buffer.data(), buffer.size());
+#endif
+        if (count <= 0) break;
+
+        // Answer every complete line that arrived, then write once.
+        std::string_view chunk(buffer.data(), static_cast<size_t>(count));
+        size_t start = 0;
+        size_t newline;
+        while ((newline = chunk.find('\n', start)) != std::string_view::npos) {
+            std::string_view line = chunk.substr(start, newline - start);
+            if (!pending.empty()) {
+                pending.append(line.data(), line.size());
+                execute(pending, out);
+                pending.clear();
+            } else {
+                execute(line, out);
+            }
+            start = newline + 1;
+        }
+        pending.append(chunk.data() + start, chunk.size() - start);
+
+        writeOut(out);
+        out.clear();
+    }
+
+    if (!pending.empty()) execute(pending, out);
+    writeOut(out);
+    return 0;
+}
@@ -1,26 +1,37 @@
 #include "cli/ChessCLI.h"
+#include "book/OpeningBook.h"
 #include "cli/BoardPrinter.h"
+#include "db/PositionDatabase.h"
+#include "engine/MateSolver.h"
+#include "engine/Search.h"
+#include "engine/TimeManager.h"
 #include "enums/Color.h"
 #include "game/Game.h"
 #include "input/MoveParser.h"
 #include "input/PGNHandler.h"
-// #include "pgn/PGNExporter.h"  // Uncomment when implemented
+#include "tablebase/Tablebase.h"
 // #include "pgn/PGNParser.h"    // Uncomment when implemented
 #include "timer/Timer.h"
 #include <iostream>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <limits>
 
 /**
  * Constructs a new ChessCLI.
  */
-ChessCLI::ChessCLI() : game(nullptr), timer(nullptr) {}
+ChessCLI::ChessCLI()
+    : game(nullptr), timer(nullptr), table(16), bookRng(std::random_device()()),
+      ponderEnabled(true), ponderKey(0), ponderSearch(nullptr), ponderHit(false) {}
 
 /**
  * Destructor - cleans up game and timer.
  */
 ChessCLI::~ChessCLI() {
+    stopPondering();
     delete game;
     delete timer;
 }
@@ -41,8 +52,9 @@ void ChessCLI::showMainMenu() {
         printBox("CONSOLE CHESS", 50);
         std::cout << std::endl;
         printMenuOption("1", "New Game");
-        printMenuOption("2", "Load Game");
-        printMenuOption("3", "Exit");
+        printMenuOption("2", "Play vs Computer");
+        printMenuOption("3", "Load Game");
+        printMenuOption("4", "Exit");
         std::cout << std::endl;
         printSeparator(50);
         std::cout << "  > ";
@@ -52,8 +64,10 @@ void ChessCLI::showMainMenu() {
         if (choice == "1") {
             startNewGame();
         } else if (choice == "2") {
-            loadGame();
+            startEngineGame();
         } else if (choice == "3") {
+            loadGame();
+        } else if (choice == "4") {
             std::cout << "\n  Thanks for playing!" << std::endl;
             return;
         } else {
@@ -72,10 +86,323 @@ void ChessCLI::startNewGame() {
     
     game = new Game();
     timer = new Timer(10);
+    engineColor.reset();
+    lastEngineMove.clear();
+    timer->start();
+    gameLoop();
+}
+
+/**
+ * Starts a new game against the engine after asking for the player's color.
+ */
+void ChessCLI::startEngineGame() {
+    clearScreen();
+    printBox("PLAY VS COMPUTER", 50);
+    std::cout << std::endl;
+    std::cout << "  Play as [W]hite or [B]lack? ";
+    std::string colorChoice = readLine();
+    std::cout << "  Minutes per player (default 5): ";
+    std::string minutesChoice = readLine();
+    std::cout << "  Increment in seconds (default 2): ";
+    std::string incrementChoice = readLine();
+    std::cout << "  Let the computer think on your time? (Y/n): ";
+    std::string ponderChoice = readLine();
+
+    int minutes = 5;
+    int increment = 2;
+    try {
+        if (!minutesChoice.empty()) minutes = std::max(1, std::stoi(minutesChoice));
+        if (!incrementChoice.empty()) increment = std::max(0, std::stoi(incrementChoice));
+    } catch (const std::exception&) {
+        std::cout << "\n  Invalid number, using 5+2." << std::endl;
+        minutes = 5;
+        increment = 2;
+        pause();
+    }
+
+    bool playsBlack = !colorChoice.empty() && std::tolower(colorChoice[0]) == 'b';
+
+    delete game;
+    delete timer;
+
+    game = new Game();
+    timer = new Timer(minutes, increment);
+    engineColor = playsBlack ? Color::WHITE : Color::BLACK;
+    ponderEnabled = ponderChoice.empty() || std::tolower(ponderChoice[0]) != 'n';
+    ponderMove.reset();
+    lastEngineMove.clear();
+    table.clear();
     timer->start();
     gameLoop();
 }
 
+/**
+ * Lets the engine search the current position and play its move.
+ */
+void ChessCLI::playEngineMove() {
+    Color side = game->getCurrentPlayer();
+    if (game->isDrawOffered()) {
+        game->declineDraw();
+    }
+    std::optional<Move> bookMove = OpeningBook::pickMove(game->getBoard(), side, bookRng);
+    if (bookMove.has_value()) {
+        stopPondering();
+        if (!game->makeMove(bookMove.value())) return;
+        timer->switchTurn();
+        ponderMove.reset();
+        lastEngineMove = "Computer played " + bookMove->toString() + " (book)";
+        return;
+    }
+
+    std::cout << "\n  Computer is thinking..." << std::endl;
+
+    SearchResult result;
+    bool fromPonder = false;
+    if (ponderHit) {
+        // The ponder search already has the engine's budget; wait for it.
+        ponderThread.join();
+        result = ponderResult;
+        delete ponderSearch;
+        ponderSearch = nullptr;
+        ponderHit = false;
+        fromPonder = result.bestMove.has_value();
+    }
+
+    if (!fromPonder) {
+        SearchLimits limits;
+        limits.time = TimeManager::fromTimer(*timer, side);
+
+        Search search(table);
+        result = search.run(game->getBoard(), side, limits);
+    }
+
+    if (!result.bestMove.has_value() || !game->makeMove(result.bestMove.value())) {
+        // No legal move: the game state already reports mate or stalemate.
+        return;
+    }
+    timer->switchTurn();
+
+    // The second move of the principal variation is the reply we expect.
+    if (result.pv.size() >= 2) {
+        ponderMove = result.pv[1];
+    } else {
+        ponderMove.reset();
+    }
+
+    lastEngineMove = "Computer played " + result.bestMove->toString()
+        + " (depth " + std::to_string(result.depth) + ", " + std::to_string(result.nodes)
+        + " nodes, " + std::to_string(result.timeMs) + " ms" + (fromPonder ? ", ponder hit" : "") + ")";
+    if (ponderEnabled && ponderMove.has_value()) {
+        lastEngineMove += ", pondering on " + ponderMove->toString();
+    }
+}
+
+/**
+ * Prints the engine's best lines for the current position.
+ */
+void ChessCLI::analyzePosition(int lines) {
+    stopPondering();
+    std::cout << "\n  Analyzing " << lines << " line(s)..." << std::endl;
+
+    SearchLimits limits;
+    limits.depth = 8;
+    limits.time.softMs = 1000;
+    limits.time.hardMs = 3000;
+
+    Search search(table);
+    std::vector<SearchResult> results =
+        search.runMultiPv(game->getBoard(), game->getCurrentPlayer(), limits, lines);
+
+    if (results.empty()) {
+        std::cout << "  No legal moves." << std::endl;
+    }
+    for (size_t i = 0; i < results.size(); i++) {
+        const SearchResult& line = results[i];
+        std::string score;
+        if (Search::isMateScore(line.score)) {
+            int plies = Search::MATE_SCORE - std::abs(line.score);
+            score = std::string(line.score > 0 ? "#" : "#-") + std::to_string((plies + 1) / 2);
+        } else {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%+.2f", line.score / 100.0);
+            score = buffer;
+        }
+
+        std::cout << "  " << (i + 1) << ". " << score << "  (depth " << line.depth << ")  ";
+        for (const Move& move : line.pv) {
+            std::cout << move.toString() << " ";
+        }
+        std::cout << std::endl;
+    }
+    pause();
+}
+
+/**
+ * Searches for a forced mate for the player to move.
+ */
+void ChessCLI::solveMate(int moves, bool allMoves) {
+    stopPondering();
+    std::cout << "\n  Searching for mate in " << moves << (allMoves ? " (all moves)" : " (checks only)")
+              << "..." << std::endl;
+
+    MateSolver solver;
+    MateResult result = solver.solve(game->getBoard(), game->getCurrentPlayer(), moves, !allMoves);
+    if (result.found) {
+        std::cout << "  Mate in " << result.mateIn << ": ";
+        for (const Move& move : result.line) {
+            std::cout << move.toString() << " ";
+        }
+        std::cout << std::endl;
+    } else {
+        std::cout << "  No mate in " << moves << " found." << std::endl;
+    }
+    std::cout << "  " << result.nodes << " nodes, " << result.hashHits << " hash hits, "
+              << result.timeMs << " ms" << std::endl;
+    pause();
+}
+
+/**
+ * Lists the database moves for the current position.
+ */
+void ChessCLI::explorePosition() {
+    if (!PositionDatabase::isLoaded()) {
+        std::cout << "\n  No position database loaded (build one with: chess posdb build positions.db <pgn...>)."
+                  << std::endl;
+        pause();
+        return;
+    }
+
+    const Board& board = game->getBoard();
+    Color side = game->getCurrentPlayer();
+    Color opponent = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PositionMove> moves = PositionDatabase::probe(board, side);
+
+    // One level of the tree below: the most played reply to each move.
+    std::vector<std::vector<PositionMove>> replies;
+    for (const PositionMove& entry : moves) {
+        Board next = board;
+        next.applyMove(entry.move);
+        replies.push_back(PositionDatabase::probe(next, opponent));
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t total = 0;
+    for (const PositionMove& entry : moves) total += entry.games;
+    std::cout << "\n  " << total << " game(s) from this position (" << static_cast<long>(micros) << " us)"
+              << std::endl;
+    if (moves.empty()) {
+        pause();
+        return;
+    }
+
+    std::cout << "  Move     Games   White   Draw  Black   Main reply" << std::endl;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const PositionMove& entry = moves[i];
+        double games = entry.games;
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "  %-6s %7u  %5.1f%% %5.1f%% %5.1f%%   ", entry.move.toString().c_str(),
+                      entry.games, 100.0 * entry.whiteWins / games, 100.0 * entry.draws / games,
+                      100.0 * entry.blackWins / games);
+        std::cout << buffer;
+        if (!replies[i].empty()) {
+            std::cout << replies[i].front().move.toString() << " (" << replies[i].front().games << ")";
+        }
+        std::cout << std::endl;
+    }
+    pause();
+}
+
+/**
+ * Suggests a move for the player to move.
+ */
+void ChessCLI::showHint() {
+    const Board& board = game->getBoard();
+    Color side = game->getCurrentPlayer();
+
+    std::optional<TablebaseResult> known = Tablebase::probe(board, side);
+    std::optional<Move> tableMove = Tablebase::bestMove(board, side);
+    if (known.has_value() && tableMove.has_value()) {
+        std::string verdict = "draw";
+        if (known->wdl == Wdl::WIN) verdict = "win, mate in " + std::to_string((known->pliesToMate + 1) / 2);
+        if (known->wdl == Wdl::LOSS) verdict = "loss, mated in " + std::to_string(known->pliesToMate / 2);
+        std::cout << "\n  Tablebase: " << verdict << ". Best move: " << tableMove->toString() << std::endl;
+        pause();
+        return;
+    }
+
+    stopPondering();
+    SearchLimits limits;
+    limits.time.softMs = 1000;
+    limits.time.hardMs = 2000;
+    Search search(table);
+    SearchResult result = search.run(board, side, limits);
+
+    if (result.bestMove.has_value()) {
+        std::cout << "\n  Hint: " << result.bestMove->toString() << " (depth " << result.depth << ")" << std::endl;
+    } else {
+        std::cout << "\n  No legal moves." << std::endl;
+    }
+    pause();
+}
+
+/**
+ * Starts searching the position after the expected reply on a background thread.
+ */
+void ChessCLI::startPondering() {
+    if (!ponderEnabled || ponderSearch != nullptr || !ponderMove.has_value()) return;
+
+    Color engine = engineColor.value();
+    std::vector<Move> legal = game->getLegalMoves();
+    if (std::find(legal.begin(), legal.end(), ponderMove.value()) == legal.end()) return;
+
+    Board expected = game->getBoard();
+    expected.applyMove(ponderMove.value());
+    ponderKey = expected.getHashKey(engine);
+
+    ponderSearch = new Search(table);
+    // Start the (unlimited) clock here so a ponder hit can never be
+    // overwritten by the thread starting late.
+    ponderSearch->getTimeManager().start(TimeBudget());
+    ponderHit = false;
+
+    Search* search = ponderSearch;
+    ponderThread = std::thread([this, search, expected, engine]() {
+        SearchLimits limits;
+        limits.ponder = true;
+        ponderResult = search->run(expected, engine, limits);
+    });
+}
+
+/**
+ * Checks the player's move against the ponder move.
+ */
+void ChessCLI::resolvePondering() {
+    if (ponderSearch == nullptr || ponderHit) return;
+
+    Color engine = engineColor.value();
+    bool moved = game->getCurrentPlayer() == engine;
+
+    if (moved && game->getBoard().getHashKey(engine) == ponderKey && !isGameOver()) {
+        ponderSearch->ponderHit(TimeManager::fromTimer(*timer, engine));
+        ponderHit = true;
+    } else if (moved || isGameOver()) {
+        stopPondering();
+    }
+}
+
+/**
+ * Stops and joins the ponder search.
+ */
+void ChessCLI::stopPondering() {
+    if (ponderSearch == nullptr) return;
+    ponderSearch->stop();
+    ponderThread.join();
+    delete ponderSearch;
+    ponderSearch = nullptr;
+    ponderHit = false;
+}
+
 /**
  * Loads a game from a PGN file.
  * NOTE: This function requires PGNParser implementation.
@@ -84,7 +411,7 @@ void ChessCLI::loadGame() {
     clearScreen();
     printBox("LOAD GAME", 50);
     std::cout << std::endl;
-    std::cout << "  Enter PGN filename: ";
+    std::cout << "  Enter PGN filename [game number] or FEN: ";
     std::string filename = readLine();
 
     if (filename.empty()) {
@@ -93,13 +420,38 @@ void ChessCLI::loadGame() {
         return;
     }
 
-    if (filename.find(".pgn") == std::string::npos) {
+    // A FEN always has '/' between ranks and a space before the side to move.
+    bool isFen = filename.find('/') != std::string::npos && filename.find(' ') != std::string::npos;
+
+    // "games.pgn 1234" loads the 1234th game of a multi-game file.
+    uint64_t gameNumber = 0;
+    size_t space = filename.find_last_of(' ');
+    if (!isFen && space != std::string::npos && space + 1 < filename.size() &&
+        std::all_of(filename.begin() + space + 1, filename.end(), ::isdigit)) {
+        gameNumber = std::stoull(filename.substr(space + 1));
+        filename.erase(filename.find_last_not_of(' ', space) + 1);
+    }
+    if (!isFen && filename.find(".pgn") == std::string::npos) {
         filename += ".pgn";
     }
 
     try {
         Game newGame;
-        PGNHandler::loadFromFile(newGame, filename);
+        if (isFen) {
+            if (!newGame.loadFen(filename)) {
+                std::cout << "\n  Invalid FEN." << std::endl;
+                pause();
+                return;
+            }
+        } else if (gameNumber > 0) {
+            if (!PGNHandler::loadFromFile(newGame, filename, gameNumber - 1)) {
+                std::cout << "\n  Could not load game " << gameNumber << " of " << filename << "." << std::endl;
+                pause();
+                return;
+            }
+        } else {
+            PGNHandler::loadFromFile(newGame, filename);
+        }
 
         // Check if anything was loaded (e.g. at least one piece on board or history exists)
         if (newGame.getMoveHistory().empty() && newGame.getBoard().isEmpty(4,0) && newGame.getBoard().isEmpty(4,7)) {
@@ -112,6 +464,8 @@ void ChessCLI::loadGame() {
 
         delete game;
         game = new Game(newGame); // Use copy constructor or assignment
+        engineColor.reset();
+        lastEngineMove.clear();
         
         // Reset timer
         delete timer;
@@ -142,13 +496,22 @@ void ChessCLI::gameLoop() {
 
         printGameStatus();
         timer->printTime();
+        if (!lastEngineMove.empty()) {
+            std::cout << "\n  " << lastEngineMove << std::endl;
+        }
 
         if (isGameOver()) {
+            stopPondering();
             std::cout << "\n  Press Enter to return to main menu..." << std::endl;
             readLine();
             return;
         }
 
+        if (engineColor.has_value() && game->getCurrentPlayer() == engineColor.value()) {
+            playEngineMove();
+            continue;
+        }
+
         if (game->isDrawOffered() && 
             game->getDrawOfferedBy().has_value() && 
             game->getDrawOfferedBy().value() != game->getCurrentPlayer()) {
@@ -163,10 +526,18 @@ void ChessCLI::gameLoop() {
         printTurnPrompt();
         printInGameMenu();
 
+        if (engineColor.has_value()) {
+            startPondering();
+        }
+
         std::cout << "\n  Enter move: ";
         std::string input = readLine();
 
         handleCommand(input);
+
+        if (engineColor.has_value()) {
+            resolvePondering();
+        }
     }
 }
 
@@ -185,6 +556,49 @@ void ChessCLI::handleCommand(const std::string& input) {
         return;
     }
 
+    if (lowerInput == "analyze" || lowerInput.rfind("analyze ", 0) == 0) {
+        int lines = 3;
+        try {
+            if (lowerInput.size() > 8) lines = std::max(1, std::min(10, std::stoi(lowerInput.substr(8))));
+        } catch (const std::exception&) {
+            lines = 3;
+        }
+        analyzePosition(lines);
+        return;
+    }
+
+    if (lowerInput == "hint") {
+        showHint();
+        return;
+    }
+
+    if (lowerInput == "explore") {
+        explorePosition();
+        return;
+    }
+
+    if (lowerInput == "fen") {
+        std::cout << "\n  " << game->toFen() << std::endl;
+        pause();
+        return;
+    }
+
+    if (lowerInput.rfind("mate ", 0) == 0) {
+        int moves = 0;
+        try {
+            moves = std::stoi(lowerInput.substr(5));
+        } catch (const std::exception&) {
+            moves = 0;
+        }
+        if (moves < 1 || moves > MateSolver::MAX_MOVES) {
+            std::cout << "\n  Usage: mate <n> [all]  (n = 1-" << MateSolver::MAX_MOVES << ")" << std::endl;
+            pause();
+            return;
+        }
+        solveMate(moves, lowerInput.find(" all") != std::string::npos);
+        return;
+    }
+
     if (lowerInput == "resign") {
         game->resign();
         return;
@@ -326,7 +740,7 @@ bool ChessCLI::isGameOver() {
 void ChessCLI::printInGameMenu() {
     std::cout << std::endl;
     printSeparator(60);
-    std::cout << "  Commands: [save] [resign]";
+    std::cout << "  Commands: [save] [resign] [hint] [analyze [n]] [mate <n>] [explore] [fen]";
     if (!game->isDrawOffered()) {
         std::cout << " [draw]";
     }
@@ -336,7 +750,6 @@ void ChessCLI::printInGameMenu() {
 
 /**
  * Saves the current game to a PGN file.
- * NOTE: This function requires PGNExporter implementation.
  */
 void ChessCLI::saveGame() {
     std::cout << "\n  Enter filename to save (e.g., mygame.pgn): ";
@@ -352,57 +765,31 @@ void ChessCLI::saveGame() {
         filename += ".pgn";
     }
 
-    // TODO: Implement when PGNExporter is available
-    std::cout << "\n  PGN export not yet implemented." << std::endl;
-    std::cout << "  This feature requires PGNExporter class." << std::endl;
-    pause();
-    
-    /*
-    // Uncomment when PGNExporter is implemented:
-    
-    try {
-        std::map<std::string, std::string> tags;
-        tags["Event"] = "Console Chess Game";
-        tags["Site"] = "Local";
-        
-        // Get current date in YYYY.MM.DD format
-        std::time_t now = std::time(nullptr);
-        std::tm* localTime = std::localtime(&now);
-        std::ostringstream dateStream;
-        dateStream << (localTime->tm_year + 1900) << "."
-                   << std::setfill('0') << std::setw(2) << (localTime->tm_mon + 1) << "."
-                   << std::setfill('0') << std::setw(2) << localTime->tm_mday;
-        tags["Date"] = dateStream.str();
-        
-        tags["Round"] = "1";
-        tags["White"] = "Player1";
-        tags["Black"] = "Player2";
-
-        std::string result;
-        switch (game->getState()) {
-            case GameState::CHECKMATE:
-                result = game->getCurrentPlayer() == Color::WHITE ? "0-1" : "1-0";
-                break;
-            case GameState::DRAW:
-            case GameState::STALEMATE:
-                result = "1/2-1/2";
-                break;
-            case GameState::RESIGNED:
-                result = game->getCurrentPlayer() == Color::WHITE ? "0-1" : "1-0";
-                break;
-            default:
-                result = "*";
-                break;
-        }
-        tags["Result"] = result;
+    PGNHeader header;
+    header.site = "Local";
+    header.round = "1";
+
+    // Current date in YYYY.MM.DD format
+    std::time_t now = std::time(nullptr);
+    char date[16];
+    if (std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now)) > 0) {
+        header.date = date;
+    }
 
-        PGNExporter::saveToFile(filename, tags, game->getMoveHistory(), result);
+    if (engineColor.has_value()) {
+        header.white = engineColor.value() == Color::WHITE ? "Computer" : "Player";
+        header.black = engineColor.value() == Color::BLACK ? "Computer" : "Player";
+    } else {
+        header.white = "Player1";
+        header.black = "Player2";
+    }
+
+    if (PGNHandler::saveToFile(*game, filename, header)) {
         std::cout << "\n  Game saved to: " << filename << std::endl;
-    } catch (const std::exception& e) {
-        std::cout << "\n  Error saving game: " << e.what() << std::endl;
+    } else {
+        std::cout << "\n  Error saving game to: " << filename << std::endl;
     }
     pause();
-    */
 }
 
 /* ================== UI HELPERS ================== */
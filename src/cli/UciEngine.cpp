@@ -0,0 +1,336 @@
+#include "cli/UciEngine.h"
+#include "game/Game.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+const int UciEngine::DEFAULT_HASH_MB;
+const int UciEngine::MAX_HASH_MB;
+const int UciEngine::MAX_THREADS;
+
+namespace {
+
+/**
+ * Gets the other color.
+ */
+Color opponent(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+/**
+ * Reads the next word as an integer, or returns 0 if it is missing or not a number.
+ */
+long long readNumber(std::istringstream& args) {
+    std::string word;
+    args >> word;
+    return std::strtoll(word.c_str(), nullptr, 10);
+}
+
+/**
+ * Clamps a number from a "go" command to a millisecond count.
+ */
+int toMs(long long value) {
+    return static_cast<int>(std::max(0LL, std::min<long long>(value, 1000000000LL)));
+}
+
+} // namespace
+
+/**
+ * Creates an engine at the start position with default options.
+ */
+UciEngine::UciEngine()
+    : table(DEFAULT_HASH_MB), threads(1), sideToMove(Color::WHITE), holdBestMove(false) {
+    int halfmoves = 0;
+    int fullmoves = 1;
+    board.loadFen(Game::START_FEN, sideToMove, halfmoves, fullmoves);
+}
+
+/**
+ * Stops a running search.
+ */
+UciEngine::~UciEngine() {
+    finishSearch();
+}
+
+/**
+ * Writes one line to stdout and flushes it.
+ */
+void UciEngine::send(const std::string& line) {
+    std::lock_guard<std::mutex> guard(outputLock);
+    std::cout << line << std::endl;
+}
+
+/**
+ * Reads and executes commands until "quit" or end of input.
+ */
+int UciEngine::run(std::istream& input) {
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream args(line);
+        std::string command;
+        args >> command;
+
+        if (command.empty()) continue;
+        if (command == "quit") {
+            finishSearch();
+            return 0;
+        }
+
+        if (command == "uci") {
+            send("id name Console Chess");
+            send("id author PCHS OOP 11A");
+            send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) +
+                 " min 1 max " + std::to_string(MAX_HASH_MB));
+            send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+            send("option name Ponder type check default false");
+            send("option name Clear Hash type button");
+            send("uciok");
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "stop") {
+            stop();
+        } else if (command == "ponderhit") {
+            ponderHit();
+        } else if (command == "ucinewgame") {
+            finishSearch();
+            table.clear();
+        } else if (command == "position") {
+            finishSearch();
+            setPosition(args);
+        } else if (command == "go") {
+            finishSearch();
+            go(args);
+        } else if (command == "setoption") {
+            finishSearch();
+            setOption(args);
+        } else if (command != "debug" && command != "register") {
+            send("info string Unknown command: " + command);
+        }
+    }
+
+    // End of input (e.g. commands piped from a file): let a timed search
+    // finish, but end one that would only stop on command.
+    {
+        std::lock_guard<std::mutex> guard(searchLock);
+        if (holdBestMove) {
+            holdBestMove = false;
+            for (std::unique_ptr<Search>& search : searches) search->stop();
+            released.notify_all();
+        }
+    }
+    if (searchThread.joinable()) searchThread.join();
+    return 0;
+}
+
+/**
+ * Sets the position from a FEN or the start position and plays the listed moves.
+ */
+void UciEngine::setPosition(std::istringstream& args) {
+    std::string word;
+    std::string fen;
+    args >> word;
+    if (word == "startpos") {
+        fen = Game::START_FEN;
+        args >> word;
+    } else if (word == "fen") {
+        while (args >> word && word != "moves") fen += (fen.empty() ? "" : " ") + word;
+    } else {
+        send("info string Expected startpos or fen");
+        return;
+    }
+
+    Board position;
+    Color side = Color::WHITE;
+    int halfmoves = 0;
+    int fullmoves = 1;
+    if (!position.loadFen(fen, side, halfmoves, fullmoves)) {
+        send("info string Invalid FEN: " + fen);
+        return;
+    }
+
+    // Moves are matched against the legal moves, so promotions must carry
+    // their piece letter ("e7e8q") as UCI requires.
+    if (word == "moves") {
+        while (args >> word) {
+            std::vector<Move> legal = Search::generateLegalMoves(position, side);
+            auto match = std::find_if(legal.begin(), legal.end(),
+                                      [&word](const Move& move) { return move.toString() == word; });
+            if (match == legal.end()) {
+                send("info string Illegal move: " + word);
+                break;
+            }
+            position.applyMove(*match);
+            side = opponent(side);
+        }
+    }
+
+    board = position;
+    sideToMove = side;
+}
+
+/**
+ * Parses the limits of a "go" command and starts the search thread.
+ */
+void UciEngine::go(std::istringstream& args) {
+    SearchLimits limits;
+    // The clocks are started and stopped here rather than inside Search::run,
+    // so a "stop" that arrives before the thread gets going is not lost.
+    limits.ponder = true;
+
+    int clock[2] = {0, 0};
+    int increment[2] = {0, 0};
+    int movesToGo = 0;
+    int moveTime = 0;
+    bool infinite = false;
+    bool ponder = false;
+
+    std::string word;
+    while (args >> word) {
+        if (word == "wtime") clock[0] = toMs(readNumber(args));
+        else if (word == "btime") clock[1] = toMs(readNumber(args));
+        else if (word == "winc") increment[0] = toMs(readNumber(args));
+        else if (word == "binc") increment[1] = toMs(readNumber(args));
+        else if (word == "movestogo") movesToGo = toMs(readNumber(args));
+        else if (word == "movetime") moveTime = toMs(readNumber(args));
+        else if (word == "depth") limits.depth = static_cast<int>(std::max(1LL, std::min<long long>(readNumber(args), Search::MAX_DEPTH)));
+        else if (word == "nodes") limits.nodes = static_cast<uint64_t>(std::max(0LL, readNumber(args)));
+        else if (word == "infinite") infinite = true;
+        else if (word == "ponder") ponder = true;
+    }
+
+    TimeBudget budget;
+    int side = sideToMove == Color::WHITE ? 0 : 1;
+    if (moveTime > 0) {
+        budget.softMs = moveTime;
+        budget.hardMs = moveTime;
+    } else if (clock[side] > 0) {
+        budget = TimeManager::allocate(clock[side], increment[side], movesToGo);
+    }
+    if (infinite) budget = TimeBudget();
+
+    std::lock_guard<std::mutex> guard(searchLock);
+    // Age the shared table once for the whole go, not once per thread.
+    table.newSearch();
+    limits.newSearch = false;
+    searches.clear();
+    for (int i = 0; i < threads; i++) {
+        searches.push_back(std::make_unique<Search>(table));
+        // A ponder search runs without deadlines until ponderhit gives it the budget.
+        searches.back()->getTimeManager().start(ponder ? TimeBudget() : budget);
+    }
+    searches[0]->setInfoCallback([this](const SearchResult& result) { send(infoLine(result)); });
+    holdBestMove = infinite || ponder;
+    ponderBudget = budget;
+    searchThread = std::thread(&UciEngine::think, this, board, sideToMove, limits);
+}
+
+/**
+ * Runs the search threads and prints the best move.
+ */
+void UciEngine::think(Board position, Color side, SearchLimits limits) {
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < searches.size(); i++) {
+        Search* helper = searches[i].get();
+        // Each thread gets its own copy of the board; every other helper starts
+        // one ply deeper so the threads fill the table with different depths.
+        SearchLimits helperLimits = limits;
+        helperLimits.startDepth = 1 + static_cast<int>(i % 2);
+        helpers.emplace_back([helper, position, side, helperLimits]() { helper->run(position, side, helperLimits); });
+    }
+    SearchResult result = searches[0]->run(position, side, limits);
+
+    // UCI forbids a best move before "stop" or "ponderhit" in these modes,
+    // even if the search ended on its own (depth limit or forced mate).
+    {
+        std::unique_lock<std::mutex> guard(searchLock);
+        released.wait(guard, [this]() { return !holdBestMove; });
+        for (std::unique_ptr<Search>& search : searches) search->stop();
+    }
+    for (std::thread& helper : helpers) helper.join();
+
+    std::string line = "bestmove " + (result.bestMove.has_value() ? result.bestMove->toString() : "0000");
+    if (result.bestMove.has_value() && result.pv.size() >= 2 && result.pv[0] == result.bestMove.value()) {
+        line += " ponder " + result.pv[1].toString();
+    }
+    send(line);
+}
+
+/**
+ * Stops all search threads and releases a held best move.
+ */
+void UciEngine::stop() {
+    std::lock_guard<std::mutex> guard(searchLock);
+    for (std::unique_ptr<Search>& search : searches) search->stop();
+    holdBestMove = false;
+    released.notify_all();
+}
+
+/**
+ * Switches a ponder search to the budget of its "go" command.
+ */
+void UciEngine::ponderHit() {
+    std::lock_guard<std::mutex> guard(searchLock);
+    for (std::unique_ptr<Search>& search : searches) search->ponderHit(ponderBudget);
+    holdBestMove = false;
+    released.notify_all();
+}
+
+/**
+ * Stops the current search (if any) and waits for its best move.
+ */
+void UciEngine::finishSearch() {
+    if (!searchThread.joinable()) return;
+    stop();
+    searchThread.join();
+}
+
+/**
+ * Handles "setoption name <name> [value <value>]".
+ */
+void UciEngine::setOption(std::istringstream& args) {
+    std::string word;
+    std::string name;
+    std::string value;
+    args >> word;
+    if (word != "name") return;
+    while (args >> word && word != "value") name += (name.empty() ? "" : " ") + word;
+    while (args >> word) value += (value.empty() ? "" : " ") + word;
+
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    long long number = std::strtoll(value.c_str(), nullptr, 10);
+
+    if (key == "hash") {
+        table.resize(static_cast<size_t>(std::max(1LL, std::min<long long>(number, MAX_HASH_MB))));
+    } else if (key == "threads") {
+        threads = static_cast<int>(std::max(1LL, std::min<long long>(number, MAX_THREADS)));
+    } else if (key == "clear hash") {
+        table.clear();
+    } else if (key != "ponder") {
+        send("info string Unknown option: " + name);
+    }
+}
+
+/**
+ * Formats an "info" line for a completed iteration.
+ */
+std::string UciEngine::infoLine(const SearchResult& result) const {
+    std::string line = "info depth " + std::to_string(result.depth);
+    if (Search::isMateScore(result.score)) {
+        int plies = Search::MATE_SCORE - std::abs(result.score);
+        int moves = (plies + 1) / 2;
+        line += " score mate " + std::to_string(result.score > 0 ? moves : -moves);
+    } else {
+        line += " score cp " + std::to_string(result.score);
+    }
+    int64_t time = std::max<int64_t>(result.timeMs, 0);
+    uint64_t nps = result.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(time, 1));
+    line += " nodes " + std::to_string(result.nodes) + " nps " + std::to_string(nps) +
+            " time " + std::to_string(time) + " hashfull " + std::to_string(table.hashfull());
+    if (!result.pv.empty()) {
+        line += " pv";
+        for (const Move& move : result.pv) line += " " + move.toString();
+    }
+    return line;
+}
@@ -0,0 +1,144 @@
+#include "db/PositionDatabase.h"
+#include <algorithm>
+#include <cstring>
+
+MappedFile PositionDatabase::file;
+size_t PositionDatabase::recordCount = 0;
+
+const uint32_t PositionDatabase::VERSION;
+const size_t PositionDatabase::HEADER_SIZE;
+const size_t PositionDatabase::ENTRY_SIZE;
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'P', 'D'};
+
+/**
+ * Reads a little-endian integer.
+ */
+template <typename T>
+T readInt(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+/**
+ * Writes a little-endian integer.
+ */
+template <typename T>
+void writeInt(char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+} // namespace
+
+/**
+ * Maps a database file and checks its header.
+ */
+bool PositionDatabase::load(const std::string& filename) {
+    unload();
+    if (!file.open(filename)) return false;
+
+    const char* data = file.data();
+    if (file.size() < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || readInt<uint32_t>(data + 4) != VERSION) {
+        file.close();
+        return false;
+    }
+    uint64_t count = readInt<uint64_t>(data + 8);
+    if ((file.size() - HEADER_SIZE) / ENTRY_SIZE < count) {
+        file.close();
+        return false;
+    }
+    recordCount = static_cast<size_t>(count);
+    return true;
+}
+
+/**
+ * Unmaps the database.
+ */
+void PositionDatabase::unload() {
+    file.close();
+    recordCount = 0;
+}
+
+/**
+ * Checks whether a database is loaded.
+ */
+bool PositionDatabase::isLoaded() {
+    return recordCount > 0;
+}
+
+/**
+ * Gets the number of records.
+ */
+size_t PositionDatabase::size() {
+    return recordCount;
+}
+
+/**
+ * Reads the key of the record at an index.
+ */
+uint64_t PositionDatabase::keyAt(size_t index) {
+    return readInt<uint64_t>(file.data() + HEADER_SIZE + index * ENTRY_SIZE);
+}
+
+/**
+ * Finds the moves played from a position by binary search on the key.
+ */
+std::vector<PositionMove> PositionDatabase::probe(const Board& board, Color sideToMove) {
+    std::vector<PositionMove> moves;
+    if (!isLoaded()) return moves;
+
+    uint64_t key = board.getHashKey(sideToMove);
+    size_t low = 0, high = recordCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (keyAt(mid) < key) low = mid + 1;
+        else high = mid;
+    }
+
+    for (size_t i = low; i < recordCount && keyAt(i) == key; i++) {
+        PositionRecord record = readRecord(file.data() + HEADER_SIZE + i * ENTRY_SIZE);
+        moves.push_back({ Move::decode(record.move), record.games, record.whiteWins, record.draws, record.blackWins });
+    }
+    std::stable_sort(moves.begin(), moves.end(),
+                     [](const PositionMove& a, const PositionMove& b) { return a.games > b.games; });
+    return moves;
+}
+
+/**
+ * Serializes a record in the file layout.
+ */
+void PositionDatabase::writeRecord(const PositionRecord& record, char* out) {
+    writeInt<uint64_t>(out, record.key);
+    writeInt<uint16_t>(out + 8, record.move);
+    writeInt<uint16_t>(out + 10, 0);
+    writeInt<uint32_t>(out + 12, record.games);
+    writeInt<uint32_t>(out + 16, record.whiteWins);
+    writeInt<uint32_t>(out + 20, record.draws);
+    writeInt<uint32_t>(out + 24, record.blackWins);
+}
+
+/**
+ * Deserializes a record.
+ */
+PositionRecord PositionDatabase::readRecord(const char* data) {
+    PositionRecord record;
+    record.key = readInt<uint64_t>(data);
+    record.move = readInt<uint16_t>(data + 8);
+    record.games = readInt<uint32_t>(data + 12);
+    record.whiteWins = readInt<uint32_t>(data + 16);
+    record.draws = readInt<uint32_t>(data + 20);
+    record.blackWins = readInt<uint32_t>(data + 24);
+    return record;
+}
+
+/**
+ * Builds the file header.
+ */
+void PositionDatabase::writeHeader(uint64_t count, char* out) {
+    std::memcpy(out, MAGIC, 4);
+    writeInt<uint32_t>(out + 4, VERSION);
+    writeInt<uint64_t>(out + 8, count);
+}
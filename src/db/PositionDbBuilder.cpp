@@ -0,0 +1,309 @@
+#include "db/PositionDbBuilder.h"
+#include "db/PositionDatabase.h"
+#include "input/PGNPipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+const size_t PositionDbBuilder::MERGE_WAYS;
+
+namespace {
+
+// Records read from each run per refill during a merge.
+const size_t READ_BATCH = 1 << 15;
+
+/**
+ * Orders records by key, then move.
+ */
+bool recordLess(const PositionRecord& a, const PositionRecord& b) {
+    return a.key != b.key ? a.key < b.key : a.move < b.move;
+}
+
+/**
+ * Checks whether two records are for the same position and move.
+ */
+bool sameEntry(const PositionRecord& a, const PositionRecord& b) {
+    return a.key == b.key && a.move == b.move;
+}
+
+/**
+ * Adds the counters of one record to another.
+ */
+void addCounts(PositionRecord& into, const PositionRecord& from) {
+    into.games += from.games;
+    into.whiteWins += from.whiteWins;
+    into.draws += from.draws;
+    into.blackWins += from.blackWins;
+}
+
+/**
+ * Buffered writer of records in the database layout.
+ */
+class RecordWriter {
+private:
+    std::ofstream file;
+    std::vector<char> buffer;
+    size_t used = 0;
+    uint64_t written = 0;
+
+public:
+    /**
+     * Creates (truncates) a file, reserving room for a header if asked.
+     */
+    RecordWriter(const std::string& filename, bool withHeader)
+        : file(filename, std::ios::binary | std::ios::trunc), buffer(READ_BATCH * PositionDatabase::ENTRY_SIZE) {
+        if (withHeader && file.is_open()) {
+            char header[PositionDatabase::HEADER_SIZE] = {};
+            file.write(header, sizeof(header));
+        }
+    }
+
+    /**
+     * Checks whether the file was created.
+     */
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    /**
+     * Appends a record.
+     */
+    void add(const PositionRecord& record) {
+        if (used + PositionDatabase::ENTRY_SIZE > buffer.size()) flush();
+        PositionDatabase::writeRecord(record, buffer.data() + used);
+        used += PositionDatabase::ENTRY_SIZE;
+        written++;
+    }
+
+    /**
+     * Writes out the buffered records.
+     */
+    void flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+    /**
+     * Flushes, writes the header if one was reserved, and closes the file.
+     */
+    bool close(bool withHeader) {
+        flush();
+        if (withHeader) {
+            char header[PositionDatabase::HEADER_SIZE];
+            PositionDatabase::writeHeader(written, header);
+            file.seekp(0);
+            file.write(header, sizeof(header));
+        }
+        file.close();
+        return !file.fail();
+    }
+
+    /**
+     * Gets the number of records added.
+     */
+    uint64_t count() const {
+        return written;
+    }
+};
+
+/**
+ * Sequential reader of a run file.
+ */
+class RunReader {
+private:
+    std::ifstream file;
+    std::vector<char> buffer;
+    size_t used = 0;
+    size_t position = 0;
+
+public:
+    /**
+     * Opens a run file.
+     */
+    explicit RunReader(const std::string& filename)
+        : file(filename, std::ios::binary), buffer(READ_BATCH * PositionDatabase::ENTRY_SIZE) {}
+
+    /**
+     * Reads the next record; false at the end of the run.
+     */
+    bool next(PositionRecord& record) {
+        if (position == used) {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            used = static_cast<size_t>(file.gcount()) / PositionDatabase::ENTRY_SIZE * PositionDatabase::ENTRY_SIZE;
+            position = 0;
+            if (used == 0) return false;
+        }
+        record = PositionDatabase::readRecord(buffer.data() + position);
+        position += PositionDatabase::ENTRY_SIZE;
+        return true;
+    }
+};
+
+/**
+ * Merges sorted run files into one output, summing equal records.
+ * Counts the distinct positions and the records written.
+ */
+bool mergeRuns(const std::vector<std::string>& inputs, const std::string& output, bool withHeader,
+               uint64_t& positions, uint64_t& records) {
+    RecordWriter writer(output, withHeader);
+    if (!writer.isOpen()) return false;
+
+    std::vector<std::unique_ptr<RunReader>> readers;
+    typedef std::pair<PositionRecord, size_t> Head;
+    auto greater = [](const Head& a, const Head& b) { return recordLess(b.first, a.first); };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+    for (const std::string& input : inputs) {
+        readers.push_back(std::make_unique<RunReader>(input));
+        PositionRecord record;
+        if (readers.back()->next(record)) heads.push({ record, readers.size() - 1 });
+    }
+
+    positions = 0;
+    bool pending = false;
+    PositionRecord current{};
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        if (pending && sameEntry(current, head.first)) {
+            addCounts(current, head.first);
+        } else {
+            if (pending) writer.add(current);
+            if (!pending || current.key != head.first.key) positions++;
+            current = head.first;
+            pending = true;
+        }
+        PositionRecord record;
+        if (readers[head.second]->next(record)) heads.push({ record, head.second });
+    }
+    if (pending) writer.add(current);
+    records = writer.count();
+    return writer.close(withHeader);
+}
+
+/**
+ * Gets the white/draw/black outcome of a game from its result token.
+ */
+void countResult(std::string_view result, PositionRecord& record) {
+    record.whiteWins = result == "1-0" ? 1 : 0;
+    record.draws = result == "1/2-1/2" ? 1 : 0;
+    record.blackWins = result == "0-1" ? 1 : 0;
+}
+
+} // namespace
+
+/**
+ * Builds a database from PGN files.
+ */
+int PositionDbBuilder::build(const std::vector<std::string>& pgnFiles, const std::string& dbFile, int threads,
+                             int maxPlies, size_t memoryMb) {
+    auto begin = std::chrono::steady_clock::now();
+    PipelineOptions options;
+    options.threads = threads;
+    int workers = PGNPipeline::workerCount(options);
+
+    // Each worker gets an equal share of the memory for its record buffer.
+    size_t capacity = std::max<size_t>(1024, (memoryMb << 20) / workers / sizeof(PositionRecord));
+    std::vector<std::vector<PositionRecord>> buffers(workers);
+
+    std::vector<std::string> runs;
+    std::mutex runsMutex;
+    std::atomic<int> nextRun{0};
+    std::atomic<bool> writeFailed{false};
+
+    // Sorts a buffer, sums equal records and writes it out as a run.
+    auto spill = [&](std::vector<PositionRecord>& buffer) {
+        if (buffer.empty()) return;
+        std::sort(buffer.begin(), buffer.end(), recordLess);
+        std::string name = dbFile + ".run" + std::to_string(nextRun++);
+        {
+            std::lock_guard<std::mutex> lock(runsMutex);
+            runs.push_back(name);
+        }
+        RecordWriter writer(name, false);
+        size_t i = 0;
+        while (i < buffer.size()) {
+            PositionRecord sum = buffer[i++];
+            while (i < buffer.size() && sameEntry(sum, buffer[i])) addCounts(sum, buffer[i++]);
+            writer.add(sum);
+        }
+        if (!writer.isOpen() || !writer.close(false)) writeFailed = true;
+        buffer.clear();
+    };
+
+    // A game's records wait in pending until its replay has succeeded, so
+    // games that fail part-way add nothing.
+    std::vector<std::vector<PositionRecord>> pending(workers);
+    auto onMove = [&](int worker, const PGNGame& pgn, const Game& position, const Move& move) {
+        if (maxPlies > 0 && position.getMoveHistory().size() >= static_cast<size_t>(maxPlies)) return;
+        PositionRecord record;
+        record.key = position.getBoard().getHashKey(position.getCurrentPlayer());
+        record.move = move.encode();
+        record.games = 1;
+        countResult(pgn.result.empty() ? pgn.tag("Result") : pgn.result, record);
+        pending[worker].push_back(record);
+    };
+
+    auto onGame = [&](int worker, const PGNGame&, const Game&, bool replayed) {
+        std::vector<PositionRecord>& game = pending[worker];
+        if (replayed) {
+            std::vector<PositionRecord>& buffer = buffers[worker];
+            if (buffer.capacity() < capacity) buffer.reserve(capacity);
+            for (const PositionRecord& record : game) {
+                buffer.push_back(record);
+                if (buffer.size() >= capacity) spill(buffer);
+            }
+        }
+        game.clear();
+    };
+
+    uint64_t games = 0, moves = 0, failed = 0;
+    for (const std::string& filename : pgnFiles) {
+        PipelineStats stats = PGNPipeline::run(filename, options, onGame, onMove);
+        if (!stats.opened) {
+            std::cerr << "Cannot read " << filename << std::endl;
+            for (const std::string& run : runs) std::remove(run.c_str());
+            return 1;
+        }
+        games += stats.games;
+        moves += stats.moves;
+        failed += stats.failed;
+    }
+    for (std::vector<PositionRecord>& buffer : buffers) spill(buffer);
+    size_t runCount = runs.size();
+
+    // Merge in passes of at most MERGE_WAYS runs until one pass can write the database.
+    uint64_t positions = 0, records = 0;
+    bool ok = !writeFailed;
+    while (ok && runs.size() > MERGE_WAYS) {
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runs.size() && ok; first += MERGE_WAYS) {
+            std::vector<std::string> group(runs.begin() + first,
+                                           runs.begin() + std::min(runs.size(), first + MERGE_WAYS));
+            std::string name = dbFile + ".run" + std::to_string(nextRun++);
+            merged.push_back(name);
+            ok = mergeRuns(group, name, false, positions, records);
+            for (const std::string& run : group) std::remove(run.c_str());
+        }
+        runs = merged;
+    }
+    if (ok) ok = mergeRuns(runs, dbFile, true, positions, records);
+    for (const std::string& run : runs) std::remove(run.c_str());
+
+    if (!ok) {
+        std::cerr << "Cannot write " << dbFile << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Read " << games << " game(s)" << (failed ? " (" + std::to_string(failed) + " with bad moves)" : "")
+              << ", " << moves << " move(s) with " << workers << " thread(s)" << std::endl;
+    std::cout << "Wrote " << positions << " position(s), " << records << " record(s) to " << dbFile << " from "
+              << runCount << " run(s) in " << seconds << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "engine/MateSolver.h"
+#include "engine/Search.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+const int MateSolver::MAX_MOVES;
+
+namespace {
+
+/**
+ * Gets the opponent's color.
+ */
+Color opposite(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+} // namespace
+
+/**
+ * Creates a solver with a hash table of roughly the given size.
+ */
+MateSolver::MateSolver(size_t megabytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) count *= 2;
+    table.resize(count);
+}
+
+/**
+ * Gets the hash slot for a position.
+ */
+MateSolver::Entry& MateSolver::slot(uint64_t key) {
+    return table[key & (table.size() - 1)];
+}
+
+/**
+ * Gets the attacker's candidate moves, checks first.
+ */
+std::vector<Move> MateSolver::attackerMoves(const Board& board, Color attacker) {
+    std::vector<Move> checks, quiet;
+    for (const Move& move : Search::generateLegalMoves(board, attacker)) {
+        Board child = board;
+        child.applyMove(move);
+        if (Search::isInCheck(child, opposite(attacker))) {
+            checks.push_back(move);
+        } else if (!checksOnly) {
+            quiet.push_back(move);
+        }
+    }
+    checks.insert(checks.end(), quiet.begin(), quiet.end());
+    return checks;
+}
+
+/**
+ * Checks whether the attacker to move mates within the given moves.
+ */
+bool MateSolver::attack(const Board& board, Color attacker, int moves) {
+    nodes++;
+    uint64_t key = board.getHashKey(attacker);
+    Entry& entry = slot(key);
+    if (entry.key == key) {
+        if (entry.proven != 0 && entry.proven <= moves) { hashHits++; return true; }
+        if (entry.refuted >= moves) { hashHits++; return false; }
+    }
+
+    bool mates = false;
+    for (const Move& move : attackerMoves(board, attacker)) {
+        Board child = board;
+        child.applyMove(move);
+        if (defend(child, opposite(attacker), moves)) {
+            mates = true;
+            break;
+        }
+    }
+
+    Entry& stored = slot(key);
+    if (stored.key != key) stored = Entry{ key, 0, 0 };
+    if (mates) {
+        stored.proven = static_cast<int8_t>(stored.proven == 0 ? moves : std::min<int>(stored.proven, moves));
+    } else {
+        stored.refuted = static_cast<int8_t>(std::max<int>(stored.refuted, moves));
+    }
+    return mates;
+}
+
+/**
+ * Checks whether every defence allows mate within the given attacker moves
+ * (counting the move just played as the first of them).
+ */
+bool MateSolver::defend(const Board& board, Color defender, int moves) {
+    nodes++;
+    std::vector<Move> defences = Search::generateLegalMoves(board, defender);
+    if (defences.empty()) return Search::isInCheck(board, defender);  // mate, or stalemate
+    if (moves <= 1) return false;
+
+    for (const Move& move : defences) {
+        Board child = board;
+        child.applyMove(move);
+        if (!attack(child, opposite(defender), moves - 1)) return false;
+    }
+    return true;
+}
+
+/**
+ * Searches for the shortest mate up to a number of moves.
+ */
+MateResult MateSolver::solve(const Board& board, Color attacker, int maxMoves, bool onlyChecks) {
+    auto start = std::chrono::steady_clock::now();
+    checksOnly = onlyChecks;
+    nodes = 0;
+    hashHits = 0;
+    std::fill(table.begin(), table.end(), Entry());
+
+    // Table entries count moves in an int8_t.
+    maxMoves = std::min<int>(maxMoves, INT8_MAX);
+    MateResult result;
+    for (int n = 1; n <= maxMoves && !result.found; n++) {
+        if (!attack(board, attacker, n)) continue;
+        result.found = true;
+        result.mateIn = n;
+
+        // Walk the main line: a mating move at each attacker turn and the
+        // defence that holds out longest at each defender turn.
+        Board current = board;
+        for (int left = n; left >= 1; left--) {
+            std::optional<Move> key;
+            for (const Move& move : attackerMoves(current, attacker)) {
+                Board child = current;
+                child.applyMove(move);
+                if (defend(child, opposite(attacker), left)) {
+                    key = move;
+                    break;
+                }
+            }
+            if (!key.has_value()) break;
+            current.applyMove(key.value());
+            result.line.push_back(key.value());
+            if (left == 1) break;
+
+            std::optional<Move> longest;
+            int longestMoves = 0;
+            for (const Move& move : Search::generateLegalMoves(current, opposite(attacker))) {
+                Board child = current;
+                child.applyMove(move);
+                int needed = 1;
+                while (needed < left - 1 && !attack(child, attacker, needed)) needed++;
+                if (!longest.has_value() || needed > longestMoves) {
+                    longest = move;
+                    longestMoves = needed;
+                }
+            }
+            if (!longest.has_value()) break;  // mated already
+            current.applyMove(longest.value());
+            result.line.push_back(longest.value());
+            left = longestMoves + 1;
+        }
+    }
+
+    result.nodes = nodes;
+    result.hashHits = hashHits;
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,504 @@
+#include "engine/Search.h"
+#include "eval/Evaluator.h"
+#include "pieces/Piece.h"
+#include "tablebase/Tablebase.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Indexed by PieceType: KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN
+const int ORDER_VALUE[6] = { 1000, 900, 500, 330, 320, 100 };
+
+// Scores this close to MATE_SCORE are mates; wide enough for tablebase
+// distances found deep in the tree.
+const int MATE_WINDOW = 512;
+
+Color opponent(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+int squareIndex(const Square& square) {
+    return square.getRank() * 8 + square.getFile();
+}
+
+/**
+ * Converts a mate score from "plies from root" to "plies from this node".
+ */
+int scoreToTable(int score, int ply) {
+    if (score >= Search::MATE_SCORE - MATE_WINDOW) return score + ply;
+    if (score <= -Search::MATE_SCORE + MATE_WINDOW) return score - ply;
+    return score;
+}
+
+int scoreFromTable(int score, int ply) {
+    if (score >= Search::MATE_SCORE - MATE_WINDOW) return score - ply;
+    if (score <= -Search::MATE_SCORE + MATE_WINDOW) return score + ply;
+    return score;
+}
+
+/**
+ * Gets the piece captured by a move, including en passant.
+ */
+const Piece* capturedBy(const Board& board, const Move& move, const Piece* moving) {
+    const Piece* target = board.getPieceAt(move.getTo());
+    if (target != nullptr) return target;
+    if (moving->getType() == PieceType::PAWN && move.getFrom().getFile() != move.getTo().getFile()) {
+        return board.getPieceAt(move.getTo().getFile(), move.getFrom().getRank());
+    }
+    return nullptr;
+}
+
+} // namespace
+
+const int Search::MAX_DEPTH;
+const int Search::INFINITE_SCORE;
+const int Search::MATE_SCORE;
+
+/**
+ * Creates a search that uses the given transposition table.
+ */
+Search::Search(TranspositionTable& table) : table(table) {}
+
+/**
+ * Asks a running search to stop as soon as possible.
+ */
+void Search::stop() {
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * Gives a ponder search its real deadlines.
+ */
+void Search::ponderHit(const TimeBudget& budget) {
+    timeManager.restart(budget);
+}
+
+/**
+ * Sets a function called after every completed iteration.
+ */
+void Search::setInfoCallback(std::function<void(const SearchResult&)> callback) {
+    infoCallback = std::move(callback);
+}
+
+/**
+ * Gets the time manager of this search.
+ */
+TimeManager& Search::getTimeManager() {
+    return timeManager;
+}
+
+/**
+ * Checks the stop flag every node and the clock/node limits every 1024 nodes.
+ */
+bool Search::shouldStop() {
+    if (stopRequested.load(std::memory_order_relaxed)) return true;
+    if ((nodes & 1023) == 0) {
+        if (timeManager.hardLimitReached() || (limits.nodes != 0 && nodes >= limits.nodes)) {
+            stopRequested.store(true, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Searches a position until a limit is reached or stop() is called.
+ */
+SearchResult Search::run(const Board& board, Color sideToMove, const SearchLimits& searchLimits) {
+    limits = searchLimits;
+    nodes = 0;
+    keyStack.clear();
+    std::fill(&killers[0][0], &killers[0][0] + 64 * 2, static_cast<uint16_t>(0));
+    for (auto& side : history)
+        for (auto& from : side)
+            std::fill(std::begin(from), std::end(from), 0);
+    if (limits.newSearch) table.newSearch();
+    if (!limits.ponder) {
+        stopRequested.store(false, std::memory_order_relaxed);
+        timeManager.start(limits.time);
+    }
+
+    SearchResult result;
+    std::vector<Move> legal = generateLegalMoves(board, sideToMove);
+    if (legal.empty()) {
+        result.score = isInCheck(board, sideToMove) ? -MATE_SCORE : 0;
+        return result;
+    }
+    for (const Move& move : legal) {
+        if (!isExcluded(move)) {
+            result.bestMove = move;
+            break;
+        }
+    }
+    if (!result.bestMove.has_value()) return result;
+
+    int maxDepth = std::min(std::max(limits.depth, 1), MAX_DEPTH);
+    int firstDepth = std::min(std::max(limits.startDepth, 1), maxDepth);
+    for (int depth = firstDepth; depth <= maxDepth; depth++) {
+        std::optional<Move> iterationBest;
+        int score = searchRoot(board, sideToMove, depth, -INFINITE_SCORE, INFINITE_SCORE, iterationBest);
+
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            // Keep a move from the aborted iteration only if it beat the previous best.
+            if (iterationBest.has_value() && score > result.score && result.depth > 0) {
+                result.bestMove = iterationBest;
+                result.score = score;
+            }
+            break;
+        }
+
+        result.bestMove = iterationBest;
+        result.score = score;
+        result.depth = depth;
+        result.nodes = nodes;
+        result.timeMs = timeManager.elapsedMs();
+        // Start the PV below the root: with excluded moves the root entry is not stored.
+        Board child = board;
+        child.applyMove(iterationBest.value());
+        result.pv.assign(1, iterationBest.value());
+        std::vector<Move> rest = extractPv(child, sideToMove == Color::WHITE ? Color::BLACK : Color::WHITE, depth - 1);
+        result.pv.insert(result.pv.end(), rest.begin(), rest.end());
+
+        if (infoCallback) infoCallback(result);
+
+        if (!timeManager.nextIterationFits()) break;
+        if (isMateScore(score) && MATE_SCORE - std::abs(score) <= depth) break;
+    }
+
+    result.nodes = nodes;
+    result.timeMs = timeManager.elapsedMs();
+    return result;
+}
+
+/**
+ * Searches the best lines one by one, excluding moves already reported.
+ */
+std::vector<SearchResult> Search::runMultiPv(const Board& board, Color sideToMove,
+                                             const SearchLimits& searchLimits, int lines) {
+    std::vector<SearchResult> results;
+    SearchLimits lineLimits = searchLimits;
+
+    for (int line = 0; line < lines; line++) {
+        SearchResult result = run(board, sideToMove, lineLimits);
+        if (!result.bestMove.has_value() || result.depth == 0) break;
+        results.push_back(result);
+        lineLimits.excludedRootMoves.push_back(result.bestMove.value());
+
+        // A line ending on its own limits is normal; an outside stop() ends the analysis.
+        bool limitReached = timeManager.hardLimitReached() ||
+                            (lineLimits.nodes != 0 && nodes >= lineLimits.nodes);
+        if (stopRequested.load(std::memory_order_relaxed) && !limitReached) break;
+    }
+
+    // Later lines can search deeper thanks to the shared table, so order by score.
+    std::stable_sort(results.begin(), results.end(),
+                     [](const SearchResult& a, const SearchResult& b) { return a.score > b.score; });
+    return results;
+}
+
+/**
+ * Checks whether a root move is excluded by the current limits.
+ */
+bool Search::isExcluded(const Move& move) const {
+    return std::find(limits.excludedRootMoves.begin(), limits.excludedRootMoves.end(), move)
+        != limits.excludedRootMoves.end();
+}
+
+/**
+ * Searches the root moves and reports the best one.
+ */
+int Search::searchRoot(const Board& board, Color side, int depth, int alpha, int beta,
+                       std::optional<Move>& bestMove) {
+    uint64_t key = board.getHashKey(side);
+    TTEntry entry;
+    uint16_t ttMove = table.probe(key, entry) ? entry.move : 0;
+
+    keyStack.push_back(key);
+    int bestScore = -INFINITE_SCORE;
+    bool first = true;
+
+    for (const Move& move : orderedMoves(board, side, ttMove, 0, false)) {
+        if (isExcluded(move)) continue;
+        Board child = board;
+        child.applyMove(move);
+        if (isInCheck(child, side)) continue;
+
+        int score;
+        if (first) {
+            score = -negamax(child, opponent(side), depth - 1, -beta, -alpha, 1);
+        } else {
+            score = -negamax(child, opponent(side), depth - 1, -alpha - 1, -alpha, 1);
+            if (score > alpha && score < beta) {
+                score = -negamax(child, opponent(side), depth - 1, -beta, -alpha, 1);
+            }
+        }
+        first = false;
+
+        if (stopRequested.load(std::memory_order_relaxed)) break;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha) alpha = score;
+    }
+    keyStack.pop_back();
+
+    // A root searched with excluded moves is not a real result for this position.
+    if (!stopRequested.load(std::memory_order_relaxed) && bestMove.has_value() &&
+        limits.excludedRootMoves.empty()) {
+        TTEntry store;
+        store.move = bestMove->encode();
+        store.score = static_cast<int16_t>(scoreToTable(bestScore, 0));
+        store.depth = static_cast<int8_t>(depth);
+        store.bound = Bound::EXACT;
+        table.store(key, store);
+    }
+    return bestScore;
+}
+
+/**
+ * Principal variation search below the root.
+ */
+int Search::negamax(const Board& board, Color side, int depth, int alpha, int beta, int ply) {
+    if (shouldStop()) return 0;
+    nodes++;
+
+    uint64_t key = board.getHashKey(side);
+    if (isRepetition(key)) return 0;
+
+    // Perfect play from the endgame tables.
+    size_t men = board.getPieces(Color::WHITE).size() + board.getPieces(Color::BLACK).size();
+    if (men <= static_cast<size_t>(Tablebase::maxPieces())) {
+        std::optional<TablebaseResult> known = Tablebase::probe(board, side);
+        if (known.has_value()) {
+            if (known->wdl == Wdl::WIN) return MATE_SCORE - ply - known->pliesToMate;
+            if (known->wdl == Wdl::LOSS) return -MATE_SCORE + ply + known->pliesToMate;
+            return 0;
+        }
+    }
+
+    bool inCheck = isInCheck(board, side);
+    if (inCheck) depth++;
+    if (depth <= 0) return quiescence(board, side, alpha, beta, ply);
+    if (ply >= MAX_DEPTH - 1) return Evaluator::evaluate(board, side);
+
+    TTEntry entry;
+    uint16_t ttMove = 0;
+    if (table.probe(key, entry)) {
+        ttMove = entry.move;
+        int ttScore = scoreFromTable(entry.score, ply);
+        if (entry.depth >= depth) {
+            if (entry.bound == Bound::EXACT) return ttScore;
+            if (entry.bound == Bound::LOWER && ttScore >= beta) return ttScore;
+            if (entry.bound == Bound::UPPER && ttScore <= alpha) return ttScore;
+        }
+    }
+
+    int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    uint16_t bestMove = 0;
+    int legalMoves = 0;
+    int us = static_cast<int>(side);
+
+    keyStack.push_back(key);
+    for (const Move& move : orderedMoves(board, side, ttMove, ply, false)) {
+        const Piece* moving = board.getPieceAt(move.getFrom());
+        bool quiet = capturedBy(board, move, moving) == nullptr && !move.isPromotion();
+
+        Board child = board;
+        child.applyMove(move);
+        if (isInCheck(child, side)) continue;
+        legalMoves++;
+
+        int score;
+        if (legalMoves == 1) {
+            score = -negamax(child, opponent(side), depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            score = -negamax(child, opponent(side), depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta) {
+                score = -negamax(child, opponent(side), depth - 1, -beta, -alpha, ply + 1);
+            }
+        }
+
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            keyStack.pop_back();
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move.encode();
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            if (quiet) {
+                if (killers[ply][0] != move.encode()) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = move.encode();
+                }
+                history[us][squareIndex(move.getFrom())][squareIndex(move.getTo())] += depth * depth;
+            }
+            break;
+        }
+    }
+    keyStack.pop_back();
+
+    if (legalMoves == 0) {
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    TTEntry store;
+    store.move = bestMove;
+    store.score = static_cast<int16_t>(scoreToTable(bestScore, ply));
+    store.depth = static_cast<int8_t>(depth);
+    store.bound = bestScore >= beta ? Bound::LOWER
+                : bestScore > originalAlpha ? Bound::EXACT : Bound::UPPER;
+    table.store(key, store);
+    return bestScore;
+}
+
+/**
+ * Captures-only search to settle tactical sequences before evaluating.
+ */
+int Search::quiescence(const Board& board, Color side, int alpha, int beta, int ply) {
+    if (shouldStop()) return 0;
+    nodes++;
+
+    int standPat = Evaluator::evaluate(board, side);
+    if (standPat >= beta) return standPat;
+    if (standPat > alpha) alpha = standPat;
+    if (ply >= MAX_DEPTH * 2) return standPat;
+
+    for (const Move& move : orderedMoves(board, side, 0, ply, true)) {
+        Board child = board;
+        child.applyMove(move);
+        if (isInCheck(child, side)) continue;
+
+        int score = -quiescence(child, opponent(side), -beta, -alpha, ply + 1);
+        if (stopRequested.load(std::memory_order_relaxed)) return 0;
+
+        if (score >= beta) return score;
+        if (score > alpha) alpha = score;
+    }
+    return alpha;
+}
+
+/**
+ * Generates pseudo-legal moves ordered best-first.
+ */
+std::vector<Move> Search::orderedMoves(const Board& board, Color side, uint16_t ttMove, int ply,
+                                       bool capturesOnly) const {
+    std::vector<std::pair<int, Move>> scored;
+    int us = static_cast<int>(side);
+
+    // Copy the list: pieces are only read here, but keep iteration independent of the board.
+    std::vector<Piece*> pieces = board.getPieces(side);
+    for (const Piece* piece : pieces) {
+        for (const Move& move : piece->getLegalMoves(board)) {
+            const Piece* victim = capturedBy(board, move, piece);
+            if (capturesOnly && victim == nullptr && !move.isPromotion()) continue;
+
+            uint16_t code = move.encode();
+            int score;
+            if (code == ttMove) {
+                score = 1000000;
+            } else if (victim != nullptr) {
+                score = 100000 + 10 * ORDER_VALUE[static_cast<int>(victim->getType())]
+                      - ORDER_VALUE[static_cast<int>(piece->getType())];
+            } else if (move.isPromotion()) {
+                score = move.getPromotion() == PieceType::QUEEN ? 95000 : 0;
+            } else if (ply < MAX_DEPTH && code == killers[ply][0]) {
+                score = 90000;
+            } else if (ply < MAX_DEPTH && code == killers[ply][1]) {
+                score = 89000;
+            } else {
+                score = std::min(history[us][squareIndex(move.getFrom())][squareIndex(move.getTo())], 80000);
+            }
+            scored.emplace_back(score, move);
+        }
+    }
+
+    std::stable_sort(scored.begin(), scored.end(),
+                     [](const std::pair<int, Move>& a, const std::pair<int, Move>& b) {
+                         return a.first > b.first;
+                     });
+
+    std::vector<Move> moves;
+    moves.reserve(scored.size());
+    for (const auto& entry : scored) moves.push_back(entry.second);
+    return moves;
+}
+
+/**
+ * Checks whether the position already occurred on the current search path
+ * with the same side to move.
+ */
+bool Search::isRepetition(uint64_t key) const {
+    for (int i = static_cast<int>(keyStack.size()) - 2; i >= 0; i -= 2) {
+        if (keyStack[i] == key) return true;
+    }
+    return false;
+}
+
+/**
+ * Follows best moves stored in the transposition table.
+ */
+std::vector<Move> Search::extractPv(const Board& board, Color side, int maxLength) const {
+    std::vector<Move> pv;
+    std::vector<uint64_t> seen;
+    Board current = board;
+    Color turn = side;
+
+    while (static_cast<int>(pv.size()) < maxLength) {
+        uint64_t key = current.getHashKey(turn);
+        if (std::find(seen.begin(), seen.end(), key) != seen.end()) break;
+        seen.push_back(key);
+
+        TTEntry entry;
+        if (!table.probe(key, entry) || entry.move == 0) break;
+        Move move = Move::decode(entry.move);
+
+        std::vector<Move> legal = generateLegalMoves(current, turn);
+        if (std::find(legal.begin(), legal.end(), move) == legal.end()) break;
+
+        pv.push_back(move);
+        current.applyMove(move);
+        turn = opponent(turn);
+    }
+    return pv;
+}
+
+/**
+ * Generates all legal moves for a side.
+ */
+std::vector<Move> Search::generateLegalMoves(const Board& board, Color side) {
+    std::vector<Move> legal;
+    std::vector<Piece*> pieces = board.getPieces(side);
+    for (const Piece* piece : pieces) {
+        for (const Move& move : piece->getLegalMoves(board)) {
+            if (board.leavesKingSafe(move, side)) legal.push_back(move);
+        }
+    }
+    return legal;
+}
+
+/**
+ * Checks whether a side's king is attacked.
+ */
+bool Search::isInCheck(const Board& board, Color side) {
+    for (const Piece* piece : board.getPieces(side)) {
+        if (piece->getType() == PieceType::KING) {
+            return board.isSquareAttacked(piece->getFile(), piece->getRank(), opponent(side));
+        }
+    }
+    return false;
+}
+
+/**
+ * Checks whether a score means forced mate.
+ */
+bool Search::isMateScore(int score) {
+    return std::abs(score) >= MATE_SCORE - MATE_WINDOW;
+}
@@ -0,0 +1,90 @@
+#include "engine/TimeManager.h"
+#include "timer/Timer.h"
+#include <algorithm>
+#include <chrono>
+
+const int64_t TimeManager::NO_DEADLINE;
+const int TimeManager::MOVE_OVERHEAD_MS;
+
+/**
+ * Computes soft and hard budgets from the remaining clock time.
+ */
+TimeBudget TimeManager::allocate(int remainingMs, int incrementMs, int movesToGo) {
+    TimeBudget budget;
+    int usable = std::max(1, remainingMs - MOVE_OVERHEAD_MS);
+    int moves = movesToGo > 0 ? std::min(movesToGo, 50) : 30;
+
+    // Soft: an even share of the clock plus most of the increment.
+    int soft = usable / moves + incrementMs * 3 / 4;
+    // Hard: room to finish an unstable iteration, never more than a third of the clock.
+    int hard = std::min(soft * 4, usable / 3 + incrementMs);
+
+    budget.softMs = std::max(1, std::min(soft, usable));
+    budget.hardMs = std::max(budget.softMs, std::min(hard, usable));
+    return budget;
+}
+
+/**
+ * Computes the budget for a side from a running game Timer.
+ */
+TimeBudget TimeManager::fromTimer(const Timer& timer, Color side) {
+    return allocate(timer.getRemainingSeconds(side) * 1000, timer.getIncrementSeconds() * 1000);
+}
+
+/**
+ * Gets a monotonic timestamp.
+ */
+int64_t TimeManager::nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Starts the clock for a search with the given budget.
+ */
+void TimeManager::start(const TimeBudget& budget) {
+    restart(budget);
+}
+
+/**
+ * Replaces the deadlines, measured from now.
+ */
+void TimeManager::restart(const TimeBudget& budget) {
+    int64_t now = nowMs();
+    startTime.store(now, std::memory_order_relaxed);
+    softDeadline.store(budget.softMs > 0 ? now + budget.softMs : NO_DEADLINE, std::memory_order_relaxed);
+    hardDeadline.store(budget.hardMs > 0 ? now + budget.hardMs : NO_DEADLINE, std::memory_order_relaxed);
+}
+
+/**
+ * Checks whether the hard deadline has passed.
+ */
+bool TimeManager::hardLimitReached() const {
+    int64_t deadline = hardDeadline.load(std::memory_order_relaxed);
+    return deadline != NO_DEADLINE && nowMs() >= deadline;
+}
+
+/**
+ * Checks whether the soft deadline has passed.
+ */
+bool TimeManager::softLimitReached() const {
+    int64_t deadline = softDeadline.load(std::memory_order_relaxed);
+    return deadline != NO_DEADLINE && nowMs() >= deadline;
+}
+
+/**
+ * Predicts whether another iteration can finish before the soft deadline.
+ */
+bool TimeManager::nextIterationFits() const {
+    int64_t deadline = softDeadline.load(std::memory_order_relaxed);
+    if (deadline == NO_DEADLINE) return true;
+    int64_t now = nowMs();
+    return now + (now - startTime.load(std::memory_order_relaxed)) < deadline;
+}
+
+/**
+ * Gets the time since start() or restart().
+ */
+int64_t TimeManager::elapsedMs() const {
+    return nowMs() - startTime.load(std::memory_order_relaxed);
+}
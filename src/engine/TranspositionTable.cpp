@@ -0,0 +1,119 @@
+#include "engine/TranspositionTable.h"
+
+namespace {
+
+uint64_t pack(const TTEntry& entry, uint8_t generation) {
+    return static_cast<uint64_t>(entry.move)
+        | static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 16
+        | static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 32
+        | static_cast<uint64_t>(entry.bound) << 40
+        | static_cast<uint64_t>(generation) << 48;
+}
+
+TTEntry unpack(uint64_t data) {
+    TTEntry entry;
+    entry.move = static_cast<uint16_t>(data);
+    entry.score = static_cast<int16_t>(static_cast<uint16_t>(data >> 16));
+    entry.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 32));
+    entry.bound = static_cast<Bound>((data >> 40) & 0xFF);
+    return entry;
+}
+
+uint8_t generationOf(uint64_t data) {
+    return static_cast<uint8_t>(data >> 48);
+}
+
+} // namespace
+
+/**
+ * Creates a table of roughly the given size.
+ */
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+/**
+ * Reallocates the table, discarding its contents.
+ */
+void TranspositionTable::resize(size_t megabytes) {
+    size_t bytes = (megabytes == 0 ? 1 : megabytes) * 1024 * 1024;
+    slotCount = bytes / sizeof(Slot);
+    slots.reset(new Slot[slotCount]);
+    generation.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Empties every slot.
+ */
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < slotCount; i++) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Marks the start of a new search.
+ */
+void TranspositionTable::newSearch() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Looks up a position.
+ */
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Slot& slot = slots[key % slotCount];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if (data == 0 || (check ^ data) != key) return false;
+    entry = unpack(data);
+    return true;
+}
+
+/**
+ * Stores a search result, keeping deeper entries from the current search.
+ */
+void TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    uint8_t current = generation.load(std::memory_order_relaxed);
+    Slot& slot = slots[key % slotCount];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    uint64_t oldKey = slot.check.load(std::memory_order_relaxed) ^ oldData;
+
+    if (oldData != 0 && oldKey == key) {
+        TTEntry old = unpack(oldData);
+        // Keep a deeper result for the same position unless this one is exact.
+        if (entry.bound != Bound::EXACT && entry.depth < old.depth - 2) return;
+        if (entry.move == 0 && old.move != 0) {
+            TTEntry merged = entry;
+            merged.move = old.move;
+            uint64_t data = pack(merged, current);
+            slot.data.store(data, std::memory_order_relaxed);
+            slot.check.store(key ^ data, std::memory_order_relaxed);
+            return;
+        }
+    } else if (oldData != 0 && generationOf(oldData) == current &&
+               unpack(oldData).depth > entry.depth) {
+        // Different position searched deeper during this search: keep it.
+        return;
+    }
+
+    uint64_t data = pack(entry, current);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+/**
+ * Estimates how full the table is from a sample of slots.
+ */
+int TranspositionTable::hashfull() const {
+    size_t sample = slotCount < 1000 ? slotCount : 1000;
+    int used = 0;
+    uint8_t current = generation.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < sample; i++) {
+        uint64_t data = slots[i].data.load(std::memory_order_relaxed);
+        if (data != 0 && generationOf(data) == current) used++;
+    }
+    return sample == 0 ? 0 : static_cast<int>(used * 1000 / sample);
+}
@@ -0,0 +1,408 @@
+#include "eval/Evaluator.h"
+#include "board/Board.h"
+#include "board/Zobrist.h"
+#include "eval/Nnue.h"
+#include "pieces/Piece.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Indexed by PieceType: KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN
+const int MG_MATERIAL[6] = { 0, 1025, 477, 365, 337, 82 };
+const int EG_MATERIAL[6] = { 0,  936, 512, 297, 281, 94 };
+const int PHASE_WEIGHT[6] = { 0, 4, 2, 1, 1, 0 };
+
+// Tables are laid out from White's point of view with rank 8 first,
+// so a1 is index 56 and h8 is index 7.
+const int MG_KING[64] = {
+    -65,  23,  16, -15, -56, -34,   2,  13,
+     29,  -1, -20,  -7,  -8,  -4, -38, -29,
+     -9,  24,   2, -16, -20,   6,  22, -22,
+    -17, -20, -12, -27, -30, -25, -14, -36,
+    -49,  -1, -27, -39, -46, -44, -33, -51,
+    -14, -14, -22, -46, -44, -30, -15, -27,
+      1,   7,  -8, -64, -43, -16,   9,   8,
+    -15,  36,  12, -54,   8, -28,  24,  14
+};
+
+const int EG_KING[64] = {
+    -74, -35, -18, -18, -11,  15,   4, -17,
+    -12,  17,  14,  17,  17,  38,  23,  11,
+     10,  17,  23,  15,  20,  45,  44,  13,
+     -8,  22,  24,  27,  26,  33,  26,   3,
+    -18,  -4,  21,  24,  27,  23,   9, -11,
+    -19,  -3,  11,  21,  23,  16,   7,  -9,
+    -27, -11,   4,  13,  14,   4,  -5, -17,
+    -53, -34, -21, -11, -28, -14, -24, -43
+};
+
+const int MG_QUEEN[64] = {
+    -28,   0,  29,  12,  59,  44,  43,  45,
+    -24, -39,  -5,   1, -16,  57,  28,  54,
+    -13, -17,   7,   8,  29,  56,  47,  57,
+    -27, -27, -16, -16,  -1,  17,  -2,   1,
+     -9, -26,  -9, -10,  -2,  -4,   3,  -3,
+    -14,   2, -11,  -2,  -5,   2,  14,   5,
+    -35,  -8,  11,   2,   8,  15,  -3,   1,
+     -1, -18,  -9,  10, -15, -25, -31, -50
+};
+
+const int EG_QUEEN[64] = {
+     -9,  22,  22,  27,  27,  19,  10,  20,
+    -17,  20,  32,  41,  58,  25,  30,   0,
+    -20,   6,   9,  49,  47,  35,  19,   9,
+      3,  22,  24,  45,  57,  40,  57,  36,
+    -18,  28,  19,  47,  31,  34,  39,  23,
+    -16, -27,  15,   6,   9,  17,  10,   5,
+    -22, -23, -30, -16, -16, -23, -36, -32,
+    -33, -28, -22, -43,  -5, -32, -20, -41
+};
+
+const int MG_ROOK[64] = {
+     32,  42,  32,  51,  63,   9,  31,  43,
+     27,  32,  58,  62,  80,  67,  26,  44,
+     -5,  19,  26,  36,  17,  45,  61,  16,
+    -24, -11,   7,  26,  24,  35,  -8, -20,
+    -36, -26, -12,  -1,   9,  -7,   6, -23,
+    -45, -25, -16, -17,   3,   0,  -5, -33,
+    -44, -16, -20,  -9,  -1,  11,  -6, -71,
+    -19, -13,   1,  17,  16,   7, -37, -26
+};
+
+const int EG_ROOK[64] = {
+     13,  10,  18,  15,  12,  12,   8,   5,
+     11,  13,  13,  11,  -3,   3,   8,   3,
+      7,   7,   7,   5,   4,  -3,  -5,  -3,
+      4,   3,  13,   1,   2,   1,  -1,   2,
+      3,   5,   8,   4,  -5,  -6,  -8, -11,
+     -4,   0,  -5,  -1,  -7, -12,  -8, -16,
+     -6,  -6,   0,   2,  -9,  -9, -11,  -3,
+     -9,   2,   3,  -1,  -5, -13,   4, -20
+};
+
+const int MG_BISHOP[64] = {
+    -29,   4, -82, -37, -25, -42,   7,  -8,
+    -26,  16, -18, -13,  30,  59,  18, -47,
+    -16,  37,  43,  40,  35,  50,  37,  -2,
+     -4,   5,  19,  50,  37,  37,   7,  -2,
+     -6,  13,  13,  26,  34,  12,  10,   4,
+      0,  15,  15,  15,  14,  27,  18,  10,
+      4,  15,  16,   0,   7,  21,  33,   1,
+    -33,  -3, -14, -21, -13, -12, -39, -21
+};
+
+const int EG_BISHOP[64] = {
+    -14, -21, -11,  -8,  -7,  -9, -17, -24,
+     -8,  -4,   7, -12,  -3, -13,  -4, -14,
+      2,  -8,   0,  -1,  -2,   6,   0,   4,
+     -3,   9,  12,   9,  14,  10,   3,   2,
+     -6,   3,  13,  19,   7,  10,  -3,  -9,
+    -12,  -3,   8,  10,  13,   3,  -7, -15,
+    -14, -18,  -7,  -1,   4,  -9, -15, -27,
+    -23,  -9, -23,  -5,  -9, -16,  -5, -17
+};
+
+const int MG_KNIGHT[64] = {
+   -167, -89, -34, -49,  61, -97, -15,-107,
+    -73, -41,  72,  36,  23,  62,   7, -17,
+    -47,  60,  37,  65,  84, 129,  73,  44,
+     -9,  17,  19,  53,  37,  69,  18,  22,
+    -13,   4,  16,  13,  28,  19,  21,  -8,
+    -23,  -9,  12,  10,  19,  17,  25, -16,
+    -29, -53, -12,  -3,  -1,  18, -14, -19,
+   -105, -21, -58, -33, -17, -28, -19, -23
+};
+
+const int EG_KNIGHT[64] = {
+    -58, -38, -13, -28, -31, -27, -63, -99,
+    -25,  -8, -25,  -2,  -9, -25, -24, -52,
+    -24, -20,  10,   9,  -1,  -9, -19, -41,
+    -17,   3,  22,  22,  22,  11,   8, -18,
+    -18,  -6,  16,  25,  16,  17,   4, -18,
+    -23,  -3,  -1,  15,  10,  -3, -20, -22,
+    -42, -20, -10,  -5,  -2, -20, -23, -44,
+    -29, -51, -23, -15, -22, -18, -50, -64
+};
+
+const int MG_PAWN[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     98, 134,  61,  95,  68, 126,  34, -11,
+     -6,   7,  26,  31,  65,  56,  25, -20,
+    -14,  13,   6,  21,  23,  12,  17, -23,
+    -27,  -2,  -5,  12,  17,   6,  10, -25,
+    -26,  -4,  -4, -10,   3,   3,  33, -12,
+    -35,  -1, -20, -23, -15,  24,  38, -22,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int EG_PAWN[64] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+    178, 173, 158, 134, 147, 132, 165, 187,
+     94, 100,  85,  67,  56,  53,  82,  84,
+     32,  24,  13,   5,  -2,   4,  17,  17,
+     13,   9,  -3,  -7,  -7,  -8,   3,  -1,
+      4,   7,  -6,   1,   0,  -5,  -1,  -8,
+     13,   8,   8,  10,  13,   0,   2,  -7,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+// Pawn-structure terms, indexed by relative rank where relevant
+const int DOUBLED_MG = -11, DOUBLED_EG = -56;
+const int ISOLATED_MG = -5, ISOLATED_EG = -15;
+const int BACKWARD_MG = -9, BACKWARD_EG = -24;
+const int PASSED_MG[8] = { 0,  5, 10, 15, 30,  50,  90, 0 };
+const int PASSED_EG[8] = { 0, 10, 20, 35, 60, 100, 150, 0 };
+
+const uint64_t FILE_A = 0x0101010101010101ULL;
+
+const int* const MG_TABLES[6] = { MG_KING, MG_QUEEN, MG_ROOK, MG_BISHOP, MG_KNIGHT, MG_PAWN };
+const int* const EG_TABLES[6] = { EG_KING, EG_QUEEN, EG_ROOK, EG_BISHOP, EG_KNIGHT, EG_PAWN };
+
+/**
+ * Maps a square to its table index, mirroring ranks for Black.
+ */
+int tableIndex(Color color, int file, int rank) {
+    int row = (color == Color::WHITE) ? 7 - rank : rank;
+    return row * 8 + file;
+}
+
+/**
+ * Blends midgame and endgame totals (White's point of view) by phase.
+ */
+int taper(int mg, int eg, int phase, Color sideToMove) {
+    int mgPhase = std::min(phase, Evaluator::MAX_PHASE);
+    int score = (mg * mgPhase + eg * (Evaluator::MAX_PHASE - mgPhase)) / Evaluator::MAX_PHASE;
+    return sideToMove == Color::WHITE ? score : -score;
+}
+
+/**
+ * Sums material, PST, phase and the pawn key over every square of the board.
+ */
+void computeTotals(const Board& board, int& mg, int& eg, int& phase, uint64_t& pawnKey) {
+    mg = 0;
+    eg = 0;
+    phase = 0;
+    pawnKey = 0;
+    for (int file = 0; file < 8; file++) {
+        for (int rank = 0; rank < 8; rank++) {
+            const Piece* p = board.getPieceAt(file, rank);
+            if (p == nullptr) continue;
+            int sign = p->getColor() == Color::WHITE ? 1 : -1;
+            mg += sign * Evaluator::midgameValue(p->getType(), p->getColor(), file, rank);
+            eg += sign * Evaluator::endgameValue(p->getType(), p->getColor(), file, rank);
+            phase += Evaluator::phaseWeight(p->getType());
+            if (p->getType() == PieceType::PAWN) {
+                pawnKey ^= Zobrist::pieceKey(p->getType(), p->getColor(), file, rank);
+            }
+        }
+    }
+}
+
+uint64_t fileMask(int file) {
+    return FILE_A << file;
+}
+
+uint64_t adjacentFilesMask(int file) {
+    uint64_t mask = 0;
+    if (file > 0) mask |= fileMask(file - 1);
+    if (file < 7) mask |= fileMask(file + 1);
+    return mask;
+}
+
+/**
+ * All squares on ranks strictly ahead of the given rank for a color.
+ */
+uint64_t ranksAhead(Color color, int rank) {
+    if (color == Color::WHITE) return rank >= 7 ? 0 : ~0ULL << (8 * (rank + 1));
+    return rank <= 0 ? 0 : ~0ULL >> (8 * (8 - rank));
+}
+
+uint64_t bit(int file, int rank) {
+    return 1ULL << (rank * 8 + file);
+}
+
+} // namespace
+
+const int Evaluator::MAX_PHASE;
+bool Evaluator::verification = false;
+
+/**
+ * Gets the middlegame value (material + PST) of a piece on a square.
+ */
+int Evaluator::midgameValue(PieceType type, Color color, int file, int rank) {
+    int t = static_cast<int>(type);
+    return MG_MATERIAL[t] + MG_TABLES[t][tableIndex(color, file, rank)];
+}
+
+/**
+ * Gets the endgame value (material + PST) of a piece on a square.
+ */
+int Evaluator::endgameValue(PieceType type, Color color, int file, int rank) {
+    int t = static_cast<int>(type);
+    return EG_MATERIAL[t] + EG_TABLES[t][tableIndex(color, file, rank)];
+}
+
+/**
+ * Gets the phase weight a piece type contributes.
+ */
+int Evaluator::phaseWeight(PieceType type) {
+    return PHASE_WEIGHT[static_cast<int>(type)];
+}
+
+/**
+ * Evaluates the position from the incrementally maintained board sums.
+ */
+int Evaluator::evaluate(const Board& board, Color sideToMove) {
+    if (verification && !verify(board)) {
+        throw std::logic_error("Incremental evaluation out of sync with board");
+    }
+    if (Nnue::isLoaded()) return Nnue::evaluate(board, sideToMove);
+    return evaluatePst(board, sideToMove);
+}
+
+/**
+ * Evaluates the position from the incremental PST sums and pawn terms.
+ */
+int Evaluator::evaluatePst(const Board& board, Color sideToMove) {
+    PawnEntry pawns = probePawns(board);
+    return taper(board.getMidgameScore() + pawns.midgame,
+                 board.getEndgameScore() + pawns.endgame,
+                 board.getGamePhase(), sideToMove);
+}
+
+/**
+ * Evaluates the position by scanning every square.
+ */
+int Evaluator::evaluateFull(const Board& board, Color sideToMove) {
+    int mg, eg, phase;
+    uint64_t pawnKey;
+    computeTotals(board, mg, eg, phase, pawnKey);
+    PawnEntry pawns = evaluatePawns(board);
+    return taper(mg + pawns.midgame, eg + pawns.endgame, phase, sideToMove);
+}
+
+/**
+ * Computes the pawn-structure terms and passed-pawn masks from scratch.
+ */
+PawnEntry Evaluator::evaluatePawns(const Board& board) {
+    uint64_t pawns[2] = {0, 0};
+    for (int file = 0; file < 8; file++) {
+        for (int rank = 0; rank < 8; rank++) {
+            const Piece* p = board.getPieceAt(file, rank);
+            if (p != nullptr && p->getType() == PieceType::PAWN) {
+                pawns[static_cast<int>(p->getColor())] |= bit(file, rank);
+            }
+        }
+    }
+
+    PawnEntry entry;
+    entry.key = board.getPawnKey();
+    int mg = 0;
+    int eg = 0;
+
+    for (Color color : {Color::WHITE, Color::BLACK}) {
+        int us = static_cast<int>(color);
+        int sign = (color == Color::WHITE) ? 1 : -1;
+        int dir = (color == Color::WHITE) ? 1 : -1;
+        uint64_t own = pawns[us];
+        uint64_t enemy = pawns[1 - us];
+
+        for (int sq = 0; sq < 64; sq++) {
+            if (!(own & (1ULL << sq))) continue;
+            int file = sq & 7;
+            int rank = sq >> 3;
+            int relRank = (color == Color::WHITE) ? rank : 7 - rank;
+            uint64_t ahead = ranksAhead(color, rank);
+            uint64_t adjacent = adjacentFilesMask(file);
+
+            // Count each extra pawn once: penalise pawns with a friend in front.
+            if (own & fileMask(file) & ahead) {
+                mg += sign * DOUBLED_MG;
+                eg += sign * DOUBLED_EG;
+            }
+
+            bool isolated = (own & adjacent) == 0;
+            if (isolated) {
+                mg += sign * ISOLATED_MG;
+                eg += sign * ISOLATED_EG;
+            }
+
+            bool passed = (enemy & ahead & (fileMask(file) | adjacent)) == 0;
+            if (passed) {
+                entry.passedPawns[us] |= 1ULL << sq;
+                mg += sign * PASSED_MG[relRank];
+                eg += sign * PASSED_EG[relRank];
+            }
+
+            // Backward: no friendly pawn beside or behind, and the stop square
+            // is covered by an enemy pawn.
+            if (!isolated && !passed && (own & adjacent & ~ahead) == 0) {
+                int stopAttackerRank = rank + 2 * dir;
+                bool stopAttacked = false;
+                if (stopAttackerRank >= 0 && stopAttackerRank < 8) {
+                    if (file > 0 && (enemy & bit(file - 1, stopAttackerRank))) stopAttacked = true;
+                    if (file < 7 && (enemy & bit(file + 1, stopAttackerRank))) stopAttacked = true;
+                }
+                if (stopAttacked) {
+                    mg += sign * BACKWARD_MG;
+                    eg += sign * BACKWARD_EG;
+                }
+            }
+        }
+    }
+
+    entry.midgame = static_cast<int16_t>(mg);
+    entry.endgame = static_cast<int16_t>(eg);
+    entry.valid = true;
+    return entry;
+}
+
+/**
+ * Gets the pawn-structure entry for a board via the thread's pawn hash table.
+ */
+PawnEntry Evaluator::probePawns(const Board& board) {
+    PawnHashTable& table = pawnTable();
+    const PawnEntry* cached = table.probe(board.getPawnKey());
+    if (cached != nullptr) return *cached;
+
+    PawnEntry entry = evaluatePawns(board);
+    table.store(entry);
+    return entry;
+}
+
+/**
+ * Gets the calling thread's pawn hash table.
+ */
+PawnHashTable& Evaluator::pawnTable() {
+    thread_local PawnHashTable table;
+    return table;
+}
+
+/**
+ * Checks that the board's incremental sums match a full recompute.
+ */
+bool Evaluator::verify(const Board& board) {
+    int mg, eg, phase;
+    uint64_t pawnKey;
+    computeTotals(board, mg, eg, phase, pawnKey);
+    return mg == board.getMidgameScore() &&
+           eg == board.getEndgameScore() &&
+           phase == board.getGamePhase() &&
+           pawnKey == board.getPawnKey() &&
+           (!Nnue::isLoaded() || Nnue::verify(board));
+}
+
+/**
+ * Enables or disables full-recompute verification inside evaluate().
+ */
+void Evaluator::setVerification(bool enabled) {
+    verification = enabled;
+}
+
+/**
+ * Checks whether verification mode is enabled.
+ */
+bool Evaluator::isVerificationEnabled() {
+    return verification;
+}
@@ -0,0 +1,251 @@
+#include "eval/Nnue.h"
+#include "board/Board.h"
+#include "pieces/Piece.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NNUE_VECTOR_EXTENSIONS 1
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'N', 'N'};
+const size_t HEADER_SIZE = 16;
+
+#ifdef NNUE_VECTOR_EXTENSIONS
+// 16 x int16 lanes: one AVX2 register, or two SSE2/NEON registers.
+typedef int16_t Vec16 __attribute__((vector_size(32)));
+typedef int32_t Vec32 __attribute__((vector_size(64)));
+const int LANES = 16;
+
+// Unaligned loads/stores; vectors go by reference to keep the ABI stable
+// when the target has no AVX.
+void loadVec(Vec16& v, const int16_t* p) {
+    std::memcpy(&v, p, sizeof(v));
+}
+
+void storeVec(int16_t* p, const Vec16& v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+#endif
+
+/**
+ * Maps a piece to its feature index from one perspective.
+ */
+int featureIndex(Color perspective, PieceType type, Color color, int file, int rank) {
+    int square = rank * 8 + file;
+    if (perspective == Color::BLACK) square ^= 56;
+    int relColor = (color == perspective) ? 0 : 1;
+    return (relColor * 6 + static_cast<int>(type)) * 64 + square;
+}
+
+/**
+ * Adds or subtracts one weight column into an accumulator row.
+ */
+void applyColumn(int16_t* row, const int16_t* column, int sign) {
+#ifdef NNUE_VECTOR_EXTENSIONS
+    for (int i = 0; i < Nnue::HIDDEN; i += LANES) {
+        Vec16 acc, w;
+        loadVec(acc, row + i);
+        loadVec(w, column + i);
+        acc = sign > 0 ? acc + w : acc - w;
+        storeVec(row + i, acc);
+    }
+#else
+    for (int i = 0; i < Nnue::HIDDEN; i++) {
+        row[i] = static_cast<int16_t>(row[i] + sign * column[i]);
+    }
+#endif
+}
+
+/**
+ * Dot product of clipped-ReLU(row + bias) with one half of the output weights.
+ */
+int32_t clippedDot(const int16_t* row, const int16_t* bias, const int16_t* weights) {
+    int32_t sum = 0;
+#ifdef NNUE_VECTOR_EXTENSIONS
+    const Vec16 zero = {};
+    const Vec16 ceiling = zero + static_cast<int16_t>(127);
+    Vec32 total = {};
+    for (int i = 0; i < Nnue::HIDDEN; i += LANES) {
+        Vec16 v, b, w;
+        loadVec(v, row + i);
+        loadVec(b, bias + i);
+        loadVec(w, weights + i);
+        v += b;
+        v = v < zero ? zero : v;
+        v = v > ceiling ? ceiling : v;
+        // Products can exceed 16 bits, so widen before multiplying.
+        total += __builtin_convertvector(v, Vec32) * __builtin_convertvector(w, Vec32);
+    }
+    for (int lane = 0; lane < LANES; lane++) {
+        sum += total[lane];
+    }
+#else
+    for (int i = 0; i < Nnue::HIDDEN; i++) {
+        int v = std::min(127, std::max(0, row[i] + bias[i]));
+        sum += v * weights[i];
+    }
+#endif
+    return sum;
+}
+
+/**
+ * Runs the output layer on an accumulator.
+ */
+int runOutput(const NnueAccumulator& acc, Color sideToMove,
+              const int16_t* bias, const int16_t* weights, int32_t outBias, int32_t scale) {
+    int us = static_cast<int>(sideToMove);
+    int32_t raw = outBias
+        + clippedDot(acc.values[us], bias, weights)
+        + clippedDot(acc.values[1 - us], bias, weights + Nnue::HIDDEN);
+    return raw / scale;
+}
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+const int Nnue::HIDDEN;
+const int Nnue::FEATURES;
+const uint32_t Nnue::VERSION;
+
+const int16_t* Nnue::featureWeights = nullptr;
+const int16_t* Nnue::featureBias = nullptr;
+const int16_t* Nnue::outputWeights = nullptr;
+int32_t Nnue::outputBias = 0;
+int32_t Nnue::outputScale = 1;
+MappedFile Nnue::weightsFile;
+
+/**
+ * Memory-maps a weights file and makes it the active network.
+ */
+bool Nnue::load(const std::string& filename) {
+    unload();
+    if (!weightsFile.open(filename)) return false;
+
+    const char* data = weightsFile.data();
+    size_t expected = HEADER_SIZE
+        + sizeof(int16_t) * (FEATURES * HIDDEN + HIDDEN + 2 * HIDDEN)
+        + sizeof(int32_t);
+    if (weightsFile.size() != expected) {
+        weightsFile.close();
+        return false;
+    }
+
+    uint32_t version, hidden, scale;
+    std::memcpy(&version, data + 4, 4);
+    std::memcpy(&hidden, data + 8, 4);
+    std::memcpy(&scale, data + 12, 4);
+
+    if (std::memcmp(data, MAGIC, 4) != 0 ||
+        version != VERSION || hidden != HIDDEN || scale == 0) {
+        weightsFile.close();
+        return false;
+    }
+
+    const char* cursor = data + HEADER_SIZE;
+    featureWeights = reinterpret_cast<const int16_t*>(cursor);
+    cursor += sizeof(int16_t) * FEATURES * HIDDEN;
+    featureBias = reinterpret_cast<const int16_t*>(cursor);
+    cursor += sizeof(int16_t) * HIDDEN;
+    outputWeights = reinterpret_cast<const int16_t*>(cursor);
+    cursor += sizeof(int16_t) * 2 * HIDDEN;
+    std::memcpy(&outputBias, cursor, sizeof(int32_t));
+    outputScale = static_cast<int32_t>(scale);
+    return true;
+}
+
+/**
+ * Unmaps the active network.
+ */
+void Nnue::unload() {
+    featureWeights = nullptr;
+    featureBias = nullptr;
+    outputWeights = nullptr;
+    outputBias = 0;
+    outputScale = 1;
+    weightsFile.close();
+}
+
+/**
+ * Checks whether a network is loaded.
+ */
+bool Nnue::isLoaded() {
+    return featureWeights != nullptr;
+}
+
+/**
+ * Writes a weights file with small deterministic pseudo-random weights.
+ */
+bool Nnue::writeRandomWeights(const std::string& filename, unsigned seed) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature(-8, 8);
+    std::uniform_int_distribution<int> output(-32, 32);
+
+    out.write(MAGIC, 4);
+    writeRaw(out, VERSION);
+    writeRaw(out, static_cast<uint32_t>(HIDDEN));
+    writeRaw(out, static_cast<uint32_t>(64));
+    for (int i = 0; i < FEATURES * HIDDEN; i++) writeRaw(out, static_cast<int16_t>(feature(rng)));
+    for (int i = 0; i < HIDDEN; i++) writeRaw(out, static_cast<int16_t>(32));
+    for (int i = 0; i < 2 * HIDDEN; i++) writeRaw(out, static_cast<int16_t>(output(rng)));
+    writeRaw(out, static_cast<int32_t>(0));
+    return out.good();
+}
+
+/**
+ * Adds or subtracts a piece's feature columns from both perspectives.
+ */
+void Nnue::update(NnueAccumulator& acc, PieceType type, Color color, int file, int rank, int sign) {
+    for (Color perspective : {Color::WHITE, Color::BLACK}) {
+        int index = featureIndex(perspective, type, color, file, rank);
+        applyColumn(acc.values[static_cast<int>(perspective)], featureWeights + index * HIDDEN, sign);
+    }
+}
+
+/**
+ * Builds an accumulator from scratch by scanning the board.
+ */
+NnueAccumulator Nnue::computeAccumulator(const Board& board) {
+    NnueAccumulator acc{};
+    if (!isLoaded()) return acc;
+    for (int file = 0; file < 8; file++) {
+        for (int rank = 0; rank < 8; rank++) {
+            const Piece* p = board.getPieceAt(file, rank);
+            if (p != nullptr) update(acc, p->getType(), p->getColor(), file, rank, 1);
+        }
+    }
+    return acc;
+}
+
+/**
+ * Runs the output layer on the board's incremental accumulator.
+ */
+int Nnue::evaluate(const Board& board, Color sideToMove) {
+    return runOutput(board.getAccumulator(), sideToMove, featureBias, outputWeights, outputBias, outputScale);
+}
+
+/**
+ * Runs the output layer on an accumulator recomputed from scratch.
+ */
+int Nnue::evaluateFull(const Board& board, Color sideToMove) {
+    return runOutput(computeAccumulator(board), sideToMove, featureBias, outputWeights, outputBias, outputScale);
+}
+
+/**
+ * Checks that the board's accumulator matches a full recompute.
+ */
+bool Nnue::verify(const Board& board) {
+    NnueAccumulator fresh = computeAccumulator(board);
+    return std::memcmp(&fresh, &board.getAccumulator(), sizeof(NnueAccumulator)) == 0;
+}
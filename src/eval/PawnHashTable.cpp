@@ -0,0 +1,63 @@
+#include "eval/PawnHashTable.h"
+
+/**
+ * Creates a table with the given number of entries.
+ */
+PawnHashTable::PawnHashTable(size_t size) {
+    size_t capacity = 1;
+    while (capacity * 2 <= size) capacity *= 2;
+    entries.resize(capacity);
+    mask = capacity - 1;
+}
+
+/**
+ * Looks up a pawn configuration.
+ */
+const PawnEntry* PawnHashTable::probe(uint64_t key) {
+    probes++;
+    const PawnEntry& entry = entries[key & mask];
+    if (entry.valid && entry.key == key) {
+        hits++;
+        return &entry;
+    }
+    return nullptr;
+}
+
+/**
+ * Stores an entry, replacing whatever occupied its slot.
+ */
+void PawnHashTable::store(const PawnEntry& entry) {
+    PawnEntry& slot = entries[entry.key & mask];
+    slot = entry;
+    slot.valid = true;
+}
+
+/**
+ * Empties the table and resets the statistics.
+ */
+void PawnHashTable::clear() {
+    for (PawnEntry& entry : entries) entry = PawnEntry();
+    probes = 0;
+    hits = 0;
+}
+
+/**
+ * Gets the number of probes since the last clear.
+ */
+uint64_t PawnHashTable::getProbes() const {
+    return probes;
+}
+
+/**
+ * Gets the number of successful probes since the last clear.
+ */
+uint64_t PawnHashTable::getHits() const {
+    return hits;
+}
+
+/**
+ * Gets the fraction of probes that hit.
+ */
+double PawnHashTable::getHitRate() const {
+    return probes == 0 ? 0.0 : static_cast<double>(hits) / probes;
+}
@@ -17,10 +17,50 @@ Game::Game()
       state(GameState::ONGOING),
       drawOffered(false),
       drawOfferedBy(std::nullopt),
-      moveHistory() {
+      moveHistory(),
+      halfmoveClock(0),
+      fullmoveNumber(1) {
     initializeBoard();
 }
 
+const char* const Game::START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/**
+ * Sets up a position from Forsyth-Edwards Notation.
+ */
+bool Game::loadFen(const std::string& fen) {
+    Color side;
+    int halfmoves, fullmoves;
+    if (!board.loadFen(fen, side, halfmoves, fullmoves)) {
+        return false;
+    }
+
+    currentPlayer = side;
+    halfmoveClock = halfmoves;
+    fullmoveNumber = fullmoves;
+    drawOffered = false;
+    drawOfferedBy = std::nullopt;
+    moveHistory.clear();
+    startFen = toFen();
+    if (startFen == START_FEN) startFen.clear();
+    updateGameState();
+    return true;
+}
+
+/**
+ * Writes the current position in Forsyth-Edwards Notation.
+ */
+std::string Game::toFen() const {
+    return board.toFen(currentPlayer, halfmoveClock, fullmoveNumber);
+}
+
+/**
+ * Gets the FEN the game was set up from.
+ */
+const std::string& Game::getStartFen() const {
+    return startFen;
+}
+
 /**
  * Initializes the chess board with pieces in starting positions.
  */
@@ -170,11 +210,7 @@ bool Game::makeMove(const Move& move) {
     }
 
     // Check if move would leave king in check
-    Board testBoard = board.clone();
-    testBoard.applyMove(move);
-    std::optional<Square> kingSquare = findKing(testBoard, currentPlayer);
-    if (kingSquare.has_value() &&
-        testBoard.isSquareAttacked(kingSquare.value(), getOpponentColor(currentPlayer))) {
+    if (!board.leavesKingSafe(move, currentPlayer)) {
         return false;
     }
 
@@ -182,8 +218,11 @@ bool Game::makeMove(const Move& move) {
     std::string san = moveToSAN(move, piece);
 
     // Apply the move
+    bool resetsClock = piece->getType() == PieceType::PAWN || !board.isEmpty(to.getFile(), to.getRank());
     board.applyMove(move);
     moveHistory.push_back(san);
+    halfmoveClock = resetsClock ? 0 : halfmoveClock + 1;
+    if (currentPlayer == Color::BLACK) fullmoveNumber++;
 
     // Auto-decline draw offer if one was made by opponent
     if (drawOffered && drawOfferedBy.has_value() && drawOfferedBy.value() != currentPlayer) {
@@ -243,11 +282,7 @@ bool Game::hasAnyLegalMoves(Color color) {
             if (piece != nullptr && piece->getColor() == color) {
                 std::vector<Move> moves = piece->getLegalMoves(board);
                 for (const Move& move : moves) {
-                    Board testBoard = board.clone();
-                    testBoard.applyMove(move);
-                    std::optional<Square> kingSquare = findKing(testBoard, color);
-                    if (kingSquare.has_value() && 
-                        !testBoard.isSquareAttacked(kingSquare.value(), getOpponentColor(color))) {
+                    if (board.leavesKingSafe(move, color)) {
                         return true;
                     }
                 }
@@ -257,6 +292,25 @@ bool Game::hasAnyLegalMoves(Color color) {
     return false;
 }
 
+/**
+ * Generates every legal move for the current player.
+ */
+std::vector<Move> Game::getLegalMoves() const {
+    std::vector<Move> legal;
+    for (int rank = 0; rank < 8; rank++) {
+        for (int file = 0; file < 8; file++) {
+            Piece* piece = board.getPieceAt(file, rank);
+            if (piece == nullptr || piece->getColor() != currentPlayer) continue;
+            for (const Move& move : piece->getLegalMoves(board)) {
+                if (board.leavesKingSafe(move, currentPlayer)) {
+                    legal.push_back(move);
+                }
+            }
+        }
+    }
+    return legal;
+}
+
 /**
  * Finds the king's square for the specified color.
  */
@@ -295,7 +349,7 @@ std::string Game::getWinner() const {
 /**
  * Gets the move history in SAN notation.
  */
-std::vector<std::string> Game::getMoveHistory() const {
+const std::vector<std::string>& Game::getMoveHistory() const {
     return moveHistory;
 }
 
@@ -330,6 +384,27 @@ std::string Game::moveToSAN(const Move& move, const Piece* piece) {
             case PieceType::KNIGHT: sb << 'N'; break;
             default: sb << '?'; break;
         }
+
+        // Disambiguate when another piece of the same type can reach the square.
+        bool sameFile = false, sameRank = false, ambiguous = false;
+        for (const Move& other : getLegalMoves()) {
+            Square otherFrom = other.getFrom();
+            if (other.getTo() != to || otherFrom == from) continue;
+            const Piece* otherPiece = board.getPieceAt(otherFrom);
+            if (otherPiece == nullptr || otherPiece->getType() != piece->getType()) continue;
+            ambiguous = true;
+            if (otherFrom.getFile() == from.getFile()) sameFile = true;
+            if (otherFrom.getRank() == from.getRank()) sameRank = true;
+        }
+        if (ambiguous) {
+            if (!sameFile) {
+                sb << static_cast<char>('a' + from.getFile());
+            } else if (!sameRank) {
+                sb << static_cast<char>('1' + from.getRank());
+            } else {
+                sb << static_cast<char>('a' + from.getFile()) << static_cast<char>('1' + from.getRank());
+            }
+        }
     }
 
     // Check if it's a capture
@@ -367,6 +442,8 @@ std::string Game::moveToSAN(const Move& move, const Piece* piece) {
             case PieceType::KNIGHT: sb << 'N'; break;
             default: sb << 'Q'; break;
         }
+    } else if (piece->getType() == PieceType::PAWN && (to.getRank() == 0 || to.getRank() == 7)) {
+        sb << "=Q";  // Board::applyMove promotes to a queen by default
     }
 
     return sb.str();
@@ -1,5 +1,31 @@
+#include <chrono>
 #include <iostream>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include "archive/ArchiveConverter.h"
+#include "book/BookBuilder.h"
+#include "book/OpeningBook.h"
+#include "cli/BatchSession.h"
 #include "cli/ChessCLI.h"
+#include "cli/UciEngine.h"
+#include "db/PositionDatabase.h"
+#include "db/PositionDbBuilder.h"
+#include "engine/MateSolver.h"
+#include "eval/Nnue.h"
+#include "input/MoveParser.h"
+#include "input/PGNIndex.h"
+#include "input/PGNPipeline.h"
+#include "server/GameServer.h"
+#include "server/LoadGenerator.h"
+#include "tablebase/Tablebase.h"
+#include "tablebase/TablebaseGenerator.h"
+#include "tools/Benchmark.h"
+#include "tools/EpdRunner.h"
+#include "tools/PgnChecker.h"
+#include "tools/SelfPlay.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -8,7 +34,383 @@
 // Declaration of Darian's test function
 int runDarianTests();
 
-int main() {
+// Assertion tests in tests_darian.cpp ("chess test", run by ctest)
+int runTests();
+
+/**
+ * Runs a non-interactive command-line mode (e.g. "chess bench eval").
+ * @return Process exit code
+ */
+int runCommand(int argc, char* argv[]) {
+    std::string mode = argv[1];
+
+    if (mode == "test") {
+        return runTests() == 0 ? 0 : 1;
+    }
+
+    if (mode == "--uci") {
+        UciEngine engine;
+        return engine.run(std::cin);
+    }
+
+    if (mode == "--batch") {
+        BatchSession session;
+        return session.run();
+    }
+
+    if (mode == "bench" && argc >= 3 && std::string(argv[2]) == "eval") {
+        long iterations = argc >= 4 ? std::stol(argv[3]) : 5000000;
+        return Benchmark::runEval(iterations);
+    }
+
+    if (mode == "bench" && argc >= 4 && std::string(argv[2]) == "nnue") {
+        long iterations = argc >= 5 ? std::stol(argv[4]) : 5000000;
+        return Benchmark::runNnue(argv[3], iterations);
+    }
+
+    if (mode == "bench" && argc >= 3 && std::string(argv[2]) == "search") {
+        int depth = argc >= 4 ? std::stoi(argv[3]) : 5;
+        return Benchmark::runSearch(depth);
+    }
+
+    if (mode == "bench" && argc >= 3 && std::string(argv[2]) == "tb") {
+        std::string directory = argc >= 4 ? argv[3] : "tablebases";
+        long probes = argc >= 5 ? std::stol(argv[4]) : 1000000;
+        int threads = argc >= 6 ? std::stoi(argv[5]) : 4;
+        return Benchmark::runTablebase(directory, probes, threads);
+    }
+
+    if (mode == "bench" && argc >= 4 && std::string(argv[2]) == "pgnwrite") {
+        long games = argc >= 5 ? std::stol(argv[4]) : 100000;
+        return Benchmark::runPgnWrite(argv[3], games);
+    }
+
+    if (mode == "bench" && argc >= 4 && std::string(argv[2]) == "san") {
+        return Benchmark::runSan(argv[3]);
+    }
+
+    if (mode == "bench" && argc >= 4 && std::string(argv[2]) == "tokenize") {
+        int passes = argc >= 5 ? std::stoi(argv[4]) : 3;
+        return Benchmark::runTokenize(argv[3], passes);
+    }
+
+    if (mode == "nnue" && argc >= 4 && std::string(argv[2]) == "init") {
+        bool ok = Nnue::writeRandomWeights(argv[3], 2025);
+        std::cout << (ok ? "Wrote " : "Failed to write ") << argv[3] << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    if (mode == "tb" && argc >= 4 && std::string(argv[2]) == "gen") {
+        int threads = argc >= 5 ? std::stoi(argv[4]) : 0;
+        std::vector<std::string> materials(argv + std::min(argc, 5), argv + argc);
+        return TablebaseGenerator::generateAll(argv[3], threads, materials);
+    }
+
+    if (mode == "book" && argc >= 5 && std::string(argv[2]) == "build") {
+        std::vector<std::string> pgnFiles(argv + 4, argv + argc);
+        int maxPlies = 20;
+        auto plies = std::find(pgnFiles.begin(), pgnFiles.end(), "--plies");
+        if (plies != pgnFiles.end() && plies + 1 != pgnFiles.end()) {
+            maxPlies = std::stoi(*(plies + 1));
+            pgnFiles.erase(plies, plies + 2);
+        }
+        return BookBuilder::build(pgnFiles, argv[3], maxPlies);
+    }
+
+    if (mode == "book" && argc >= 4 && std::string(argv[2]) == "show") {
+        if (!OpeningBook::load(argv[3])) {
+            std::cerr << "Cannot load book " << argv[3] << std::endl;
+            return 1;
+        }
+        // Follow the given moves from the start, then list the book moves.
+        Game game;
+        for (int i = 4; i < argc; i++) {
+            ParsedMove parsed = MoveParser::parse(argv[i], game.getBoard(), game.getCurrentPlayer());
+            if (!parsed.isValid || !game.makeMove(parsed.move.value())) {
+                std::cerr << "Illegal move: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        std::vector<BookEntry> entries = OpeningBook::probe(game.getBoard(), game.getCurrentPlayer());
+        std::cout << OpeningBook::size() << " entries, " << entries.size() << " move(s) here" << std::endl;
+        for (const BookEntry& entry : entries) {
+            std::cout << "  " << entry.move.toString() << "  weight " << entry.weight << std::endl;
+        }
+        return 0;
+    }
+
+    if (mode == "posdb" && argc >= 5 && std::string(argv[2]) == "build") {
+        std::vector<std::string> pgnFiles;
+        int threads = 0;
+        int maxPlies = 0;
+        size_t memoryMb = 256;
+        for (int i = 4; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+            else if (option == "--plies" && i + 1 < argc) maxPlies = std::stoi(argv[++i]);
+            else if (option == "--memory" && i + 1 < argc) memoryMb = std::stoul(argv[++i]);
+            else pgnFiles.push_back(option);
+        }
+        return PositionDbBuilder::build(pgnFiles, argv[3], threads, maxPlies, memoryMb);
+    }
+
+    if (mode == "explore" && argc >= 3) {
+        if (!PositionDatabase::load(argv[2])) {
+            std::cerr << "Cannot load position database " << argv[2] << std::endl;
+            return 1;
+        }
+        // Follow the given moves from the start, then list the moves played from there.
+        Game game;
+        for (int i = 3; i < argc; i++) {
+            ParsedMove parsed = MoveParser::parse(argv[i], game.getBoard(), game.getCurrentPlayer());
+            if (!parsed.isValid || !game.makeMove(parsed.move.value())) {
+                std::cerr << "Illegal move: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<PositionMove> moves = PositionDatabase::probe(game.getBoard(), game.getCurrentPlayer());
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        uint64_t games = 0;
+        for (const PositionMove& entry : moves) games += entry.games;
+        std::cout << PositionDatabase::size() << " records, " << games << " game(s) and " << moves.size()
+                  << " move(s) here (" << micros << " us)" << std::endl;
+        for (const PositionMove& entry : moves) {
+            std::cout << "  " << entry.move.toString() << "  " << entry.games << " game(s)  +" << entry.whiteWins
+                      << " =" << entry.draws << " -" << entry.blackWins << std::endl;
+        }
+        return 0;
+    }
+
+    if (mode == "mate" && argc >= 3) {
+        // "chess mate <fen> <n> [--all]" or "chess mate <n> [--all] [moves...]",
+        // where the moves lead from the start position to the problem.
+        Game game;
+        int moves = 0;
+        bool allMoves = false;
+        int next = 3;
+        if (std::string(argv[2]).find('/') != std::string::npos) {
+            if (argc < 4 || !game.loadFen(argv[2])) {
+                std::cerr << "Invalid FEN: " << argv[2] << std::endl;
+                return 2;
+            }
+            moves = std::stoi(argv[3]);
+            next = 4;
+        } else {
+            moves = std::stoi(argv[2]);
+        }
+        if (moves < 1 || moves > MateSolver::MAX_MOVES) {
+            std::cerr << "Mate depth must be 1-" << MateSolver::MAX_MOVES << ": " << moves << std::endl;
+            return 2;
+        }
+        for (int i = next; i < argc; i++) {
+            if (std::string(argv[i]) == "--all") {
+                allMoves = true;
+                continue;
+            }
+            ParsedMove parsed = MoveParser::parse(argv[i], game.getBoard(), game.getCurrentPlayer());
+            if (!parsed.isValid || !game.makeMove(parsed.move.value())) {
+                std::cerr << "Illegal move: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+
+        MateSolver solver;
+        MateResult result = solver.solve(game.getBoard(), game.getCurrentPlayer(), moves, !allMoves);
+        if (result.found) {
+            std::cout << "Mate in " << result.mateIn << ":";
+            for (const Move& move : result.line) std::cout << " " << move.toString();
+            std::cout << std::endl;
+        } else {
+            std::cout << "No mate in " << moves << std::endl;
+        }
+        std::cout << "Nodes " << result.nodes << ", hash hits " << result.hashHits << ", "
+                  << result.timeMs << " ms" << std::endl;
+        return result.found ? 0 : 1;
+    }
+
+    if (mode == "epd" && argc >= 3) {
+        int timeMs = 1000;
+        int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        bool csv = false;
+        for (int i = 3; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--time" && i + 1 < argc) timeMs = std::stoi(argv[++i]);
+            else if (option == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+            else if (option == "--csv") csv = true;
+        }
+        return EpdRunner::run(argv[2], timeMs, threads, csv);
+    }
+
+    if (mode == "pgn" && argc >= 4 && std::string(argv[2]) == "scan") {
+        bool replay = argc >= 5 && std::string(argv[4]) == "--replay";
+        return Benchmark::runPgnScan(argv[3], replay);
+    }
+
+    if (mode == "pgn" && argc >= 4 && std::string(argv[2]) == "ingest") {
+        PipelineOptions options;
+        for (int i = 4; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--threads" && i + 1 < argc) options.threads = std::stoi(argv[++i]);
+            else if (option == "--queue" && i + 1 < argc) options.queueBatches = std::stoul(argv[++i]);
+            else if (option == "--batch" && i + 1 < argc) options.batchSize = std::stoul(argv[++i]);
+            else if (option == "--no-replay") options.replay = false;
+        }
+        PipelineStats stats = PGNPipeline::run(argv[3], options);
+        if (!stats.opened) {
+            std::cerr << "Cannot open " << argv[3] << std::endl;
+            return 1;
+        }
+        PGNPipeline::printStats(stats, std::cout);
+        return 0;
+    }
+
+    if (mode == "pgn-check" && argc >= 3) {
+        PgnCheckOptions options;
+        for (int i = 3; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--out" && i + 1 < argc) options.output = argv[++i];
+            else if (option == "--threads" && i + 1 < argc) options.threads = std::stoi(argv[++i]);
+            else if (option == "--memory" && i + 1 < argc) options.memoryMb = std::stoul(argv[++i]);
+        }
+        return PgnChecker::run(argv[2], options);
+    }
+
+    if (mode == "serve") {
+        ServerOptions options;
+        for (int i = 2; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--socket" && i + 1 < argc) options.socketPath = argv[++i];
+            else if (option == "--port" && i + 1 < argc) options.port = std::stoi(argv[++i]);
+            else if (option == "--workers" && i + 1 < argc) options.workers = std::stoi(argv[++i]);
+            else if (option == "--depth" && i + 1 < argc) options.depth = std::stoi(argv[++i]);
+            else if (option == "--hash" && i + 1 < argc) options.hashMb = std::stoul(argv[++i]);
+        }
+        return GameServer::run(options);
+    }
+
+    if (mode == "loadgen") {
+        LoadOptions options;
+        for (int i = 2; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--socket" && i + 1 < argc) options.socketPath = argv[++i];
+            else if (option == "--port" && i + 1 < argc) options.port = std::stoi(argv[++i]);
+            else if (option == "--games" && i + 1 < argc) options.games = std::stoi(argv[++i]);
+            else if (option == "--seconds" && i + 1 < argc) options.seconds = std::stoi(argv[++i]);
+            else if (option == "--think" && i + 1 < argc) options.thinkMs = std::stoi(argv[++i]);
+            else if (option == "--plies" && i + 1 < argc) options.maxPlies = std::stoi(argv[++i]);
+            else if (option == "--engine") options.engine = true;
+        }
+        return LoadGenerator::run(options);
+    }
+
+    if (mode == "selfplay") {
+        SelfPlayOptions options;
+        int first = 2;
+        if (argc >= 3 && std::string(argv[2]).rfind("--", 0) != 0) options.openings = argv[first++];
+        for (int i = first; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--games" && i + 1 < argc) options.games = std::stoi(argv[++i]);
+            else if (option == "--threads" && i + 1 < argc) options.threads = std::stoi(argv[++i]);
+            else if (option == "--tc" && i + 1 < argc) {
+                // Seconds per side plus increment, e.g. 10+0.1
+                std::string control = argv[++i];
+                size_t plus = control.find('+');
+                options.baseMs = static_cast<int>(std::stod(control.substr(0, plus)) * 1000);
+                options.incrementMs = plus == std::string::npos ? 0 : static_cast<int>(std::stod(control.substr(plus + 1)) * 1000);
+            }
+            else if (option == "--depth" && i + 1 < argc) options.depth = std::stoi(argv[++i]);
+            else if (option == "--nodes" && i + 1 < argc) options.nodes = std::stoull(argv[++i]);
+            else if (option == "--plies" && i + 1 < argc) options.maxPlies = std::stoi(argv[++i]);
+            else if (option == "--random" && i + 1 < argc) options.randomPlies = std::stoi(argv[++i]);
+            else if (option == "--hash" && i + 1 < argc) options.hashMb = std::stoul(argv[++i]);
+            else if (option == "--out" && i + 1 < argc) options.output = argv[++i];
+        }
+        return SelfPlay::run(options);
+    }
+
+    if (mode == "pgn" && argc >= 4 && std::string(argv[2]) == "index") {
+        std::string indexFile = argc >= 5 ? argv[4] : PGNIndex::indexPath(argv[3]);
+        PGNIndexStats stats = PGNIndex::build(argv[3], indexFile);
+        if (!stats.ok) {
+            std::cerr << "Cannot index " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << "Indexed " << stats.games << " game(s), " << stats.bytes / 1048576.0 << " MB in "
+                  << stats.seconds << " s (" << stats.bytes / 1048576.0 / std::max(stats.seconds, 1e-9)
+                  << " MB/s) -> " << indexFile << std::endl;
+        return 0;
+    }
+
+    if (mode == "pgn" && argc >= 5 && (std::string(argv[2]) == "game" || std::string(argv[2]) == "find")) {
+        bool showGame = std::string(argv[2]) == "game";
+        if (!showGame && argc < 6) {
+            std::cerr << "Usage: chess pgn find <file> <White|Black|Date|Result> <text> [--index path]" << std::endl;
+            return 2;
+        }
+        std::string indexFile = PGNIndex::indexPath(argv[3]);
+        for (int i = showGame ? 5 : 6; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--index" && i + 1 < argc) indexFile = argv[++i];
+        }
+
+        PGNIndex index;
+        if (!index.open(argv[3], indexFile)) {
+            std::cerr << "No up-to-date index " << indexFile << " for " << argv[3] << " (run: chess pgn index "
+                      << argv[3] << " " << indexFile << ")" << std::endl;
+            return 1;
+        }
+        if (showGame) {
+            uint64_t number = std::stoull(argv[4]);
+            if (number >= index.size()) {
+                std::cerr << argv[3] << " has " << index.size() << " game(s)" << std::endl;
+                return 1;
+            }
+            std::cout << index.text(number);
+            return 0;
+        }
+        std::vector<uint64_t> matches = index.find(argv[4], argv[5]);
+        for (uint64_t number : matches) {
+            PGNIndexEntry entry = index.entry(number);
+            std::cout << number << "  " << entry.white << " - " << entry.black << "  " << entry.date << "  "
+                      << entry.result << std::endl;
+        }
+        std::cout << matches.size() << " of " << index.size() << " game(s) match" << std::endl;
+        return 0;
+    }
+
+    if (mode == "archive" && argc >= 5 && std::string(argv[2]) == "pack") {
+        return ArchiveConverter::pack(argv[3], argv[4]);
+    }
+
+    if (mode == "archive" && argc >= 5 && std::string(argv[2]) == "unpack") {
+        return ArchiveConverter::unpack(argv[3], argv[4]);
+    }
+
+    if (mode == "archive" && argc >= 5 && std::string(argv[2]) == "show") {
+        return ArchiveConverter::show(argv[3], std::stoull(argv[4]));
+    }
+
+    if (mode == "perft" && argc >= 3) {
+        Game game;
+        if (argc >= 4 && !game.loadFen(argv[3])) {
+            std::cerr << "Invalid FEN: " << argv[3] << std::endl;
+            return 2;
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = Benchmark::perft(game.getBoard(), game.getCurrentPlayer(), std::stoi(argv[2]));
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Nodes: " << nodes << " (" << seconds << " s)" << std::endl;
+        return 0;
+    }
+
+    std::cerr << "Unknown command: " << mode << std::endl;
+    std::cerr << "Usage: chess [--uci | --batch | test | bench eval [iterations] | bench nnue <weights> [iterations] | bench search [depth] | bench tb [dir] [probes] [threads] | bench san <pgn> | bench tokenize <pgn> [passes] | bench pgnwrite <out> [games] | nnue init <weights> | tb gen <dir> [threads] [materials...] | book build <book> <pgn...> [--plies n] | book show <book> [moves...] | posdb build <db> <pgn...> [--threads n] [--plies n] [--memory mb] | explore <db> [moves...] | mate <fen> <n> [--all] | mate <n> [--all] [moves...] | perft <depth> [fen] | epd <file> [--time ms] [--threads n] [--csv] | pgn scan <file> [--replay] | pgn ingest <file> [--threads n] [--queue n] [--batch n] [--no-replay] | pgn-check <file> [--out clean.pgn] [--threads n] [--memory mb] | serve [--socket path] [--port n] [--workers n] [--depth n] [--hash mb] | loadgen [--socket path] [--port n] [--games n] [--seconds n] [--think ms] [--plies n] [--engine] | selfplay [openings] [--games n] [--threads n] [--tc base+inc] [--depth n] [--nodes n] [--plies n] [--random n] [--hash mb] [--out file] | pgn index <file> [index] | pgn game <file> <n> [--index path] | pgn find <file> <tag> <text> [--index path] | archive pack <pgn> <archive> | archive unpack <archive> <pgn> | archive show <archive> <n>]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char* argv[]) {
     // Enable UTF-8 support on Windows
     #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
@@ -20,7 +422,27 @@ int main() {
     // runDarianTests();
     // std::cout << "Tests finished. Starting CLI..." << std::endl << std::endl;
 
+    // Use NNUE evaluation when a weights file is present (mapped, not copied).
+    const char* weights = std::getenv("CHESS_NNUE");
+    Nnue::load(weights != nullptr ? weights : "chess.nnue");
+
+    // Endgame tables are mapped from $CHESS_TB or ./tablebases if present.
+    const char* tablebases = std::getenv("CHESS_TB");
+    Tablebase::init(tablebases != nullptr ? tablebases : "tablebases");
+
+    // The computer plays from $CHESS_BOOK or ./book.bin while the position is in it.
+    const char* book = std::getenv("CHESS_BOOK");
+    OpeningBook::load(book != nullptr ? book : "book.bin");
+
+    // The explore command reads $CHESS_POSITIONS or ./positions.db if present.
+    const char* positions = std::getenv("CHESS_POSITIONS");
+    PositionDatabase::load(positions != nullptr ? positions : "positions.db");
+
     try {
+        if (argc > 1) {
+            return runCommand(argc, argv);
+        }
+
         // Create and start the chess CLI
         ChessCLI cli;
         cli.start();
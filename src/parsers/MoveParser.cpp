@@ -1,23 +1,26 @@
 #include "input/MoveParser.h"
-#include <vector>
 #include <cctype>
+#include <cstdlib>
 
-ParsedMove MoveParser::parse(const std::string& input, const Board& board, Color turn) {
+ParsedMove MoveParser::parse(std::string_view input, const Board& board, Color turn) {
+    // Trim surrounding whitespace; inner whitespace ("e2 e4") is squeezed out
+    // into a small stack buffer, so nothing is allocated either way.
+    while (!input.empty() && std::isspace(static_cast<unsigned char>(input.front()))) input.remove_prefix(1);
+    while (!input.empty() && std::isspace(static_cast<unsigned char>(input.back()))) input.remove_suffix(1);
     if (input.empty()) return ParsedMove(std::nullopt, false, false, false, false);
 
-    // Remove whitespace from input for easier parsing
-    std::string cleanInput;
+    char packed[16];
+    size_t packedLength = 0;
     for (char c : input) {
-        if (!std::isspace(c)) {
-            cleanInput.push_back(c);
-        }
+        if (std::isspace(static_cast<unsigned char>(c))) continue;
+        if (packedLength == sizeof(packed)) return ParsedMove(std::nullopt, false, false, false, false);
+        packed[packedLength++] = c;
     }
+    std::string_view cleanInput(packed, packedLength);
 
     // If input is exactly 4 or 5 characters and looks like coordinate notation (e.g. e2e4 or e7e8q)
     // and starts with file-rank-file-rank, treat as Simple.
     // Otherwise treat as Algebraic.
-    // ...
-    
     bool looksLikeCoordinate = false;
     if (cleanInput.length() == 4 || cleanInput.length() == 5) {
         if (cleanInput[0] >= 'a' && cleanInput[0] <= 'h' &&
@@ -31,170 +34,148 @@ ParsedMove MoveParser::parse(const std::string& input, const Board& board, Color
     if (looksLikeCoordinate) {
          return parseSimple(cleanInput, board, turn);
     }
-    
+
     return parseAlgebraic(cleanInput, board, turn);
 }
 
-ParsedMove MoveParser::parseSimple(const std::string& input, const Board& board, Color turn) {
+ParsedMove MoveParser::parseSimple(std::string_view input, const Board& board, Color turn) {
     if (input.size() < 4) return ParsedMove(std::nullopt, false, false, false, false);
+    if (input[0] < 'a' || input[0] > 'h' || input[1] < '1' || input[1] > '8' ||
+        input[2] < 'a' || input[2] > 'h' || input[3] < '1' || input[3] > '8') {
+        return ParsedMove(std::nullopt, false, false, false, false);
+    }
+
+    Square from(input[0] - 'a', input[1] - '1');
+    Square to(input[2] - 'a', input[3] - '1');
 
-    Square from(0,0), to(0,0);
-    if (!Square::fromString(input.substr(0,2), from)) return ParsedMove(std::nullopt, false, false, false, false);
-    if (!Square::fromString(input.substr(2,2), to)) return ParsedMove(std::nullopt, false, false, false, false);
+    // A fifth letter picks the promotion piece ("e7e8n"); without it the
+    // board promotes to a queen.
+    std::optional<PieceType> promotion;
+    if (input.size() == 5) {
+        promotion = charToPieceType(static_cast<char>(std::toupper(static_cast<unsigned char>(input[4]))));
+        if (promotion == PieceType::KING || promotion == PieceType::PAWN) promotion.reset();
+        if (!promotion.has_value()) return ParsedMove(std::nullopt, false, false, false, false);
+    }
 
-    Move move(from, to);
-    bool valid = board.isLegalMove(move, turn);
+    Move move(from, to, promotion);
+    bool valid = board.leavesKingSafe(move, turn);
     return ParsedMove(valid ? std::optional<Move>(move) : std::nullopt, valid, !board.isEmpty(to.getFile(), to.getRank()), false, false);
 }
 
-ParsedMove MoveParser::parseAlgebraic(const std::string& input, const Board& board, Color turn) {
-    bool isCapture = false;
-    bool isCheck = false;
-    bool isCastling = false;
-    std::optional<PieceType> promotion = std::nullopt;
+ParsedMove MoveParser::parseAlgebraic(std::string_view input, const Board& board, Color turn) {
+    bool isCapture = input.find('x') != std::string_view::npos;
+    bool isCheck = input.find_first_of("+#") != std::string_view::npos;
+    bool isCastling = !input.empty() && (input[0] == 'O' || input[0] == '0');
 
-    std::string token;
-    for (char c : input) {
-        if (c == '+' || c == '#') { isCheck = true; continue; }
-        if (c == 'x') { isCapture = true; continue; }
-        token.push_back(c);
-    }
+    std::optional<Move> move = resolveSan(input, board, turn);
+    if (!move.has_value()) return ParsedMove(std::nullopt, false, false, false, false);
 
-    if (token == "O-O" || token == "0-0") {
-        isCastling = true;
-        Move m = board.getCastlingMove(turn, true);
-        bool valid = board.isLegalMove(m, turn);
-        return ParsedMove(valid ? std::optional<Move>(m) : std::nullopt, valid, false, isCheck, true);
-    }
-    if (token == "O-O-O" || token == "0-0-0") {
-        isCastling = true;
-        Move m = board.getCastlingMove(turn, false);
-        bool valid = board.isLegalMove(m, turn);
-        return ParsedMove(valid ? std::optional<Move>(m) : std::nullopt, valid, false, isCheck, true);
-    }
+    isCapture = isCapture || !board.isEmpty(move->getTo().getFile(), move->getTo().getRank());
+    return ParsedMove(move, true, isCapture, isCheck, isCastling);
+}
 
-    if (token.size() >= 4 && token[token.size()-2] == '=') {
-        char prom = token.back();
-        promotion = charToPieceType(prom);
-        token = token.substr(0, token.size() - 2);
+std::optional<Move> MoveParser::resolveSan(std::string_view san, const Board& board, Color turn) {
+    // Check and annotation marks carry no information for resolving.
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
     }
 
-    auto optMove = resolveAlgebraic(token, board, turn, isCapture, isCheck, isCastling, promotion);
-    if (!optMove.has_value()) return ParsedMove(std::nullopt, false, false, false, false);
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        bool kingSide = san.size() == 3;
+        bool possible = kingSide ? board.canCastleKingSide(turn) : board.canCastleQueenSide(turn);
+        if (!possible) return std::nullopt;
+        return board.getCastlingMove(turn, kingSide);
+    }
 
-    Move m = optMove.value();
-    bool valid = board.isLegalMove(m, turn);
-    return ParsedMove(valid ? std::optional<Move>(m) : std::nullopt, valid, isCapture, isCheck, isCastling);
-}
+    // Promotion suffix: "e8=Q", also accepted without the '='.
+    std::optional<PieceType> promotion = std::nullopt;
+    if (san.size() >= 3 && !std::isdigit(static_cast<unsigned char>(san.back()))) {
+        promotion = charToPieceType(static_cast<char>(std::toupper(static_cast<unsigned char>(san.back()))));
+        if (!promotion.has_value() || promotion == PieceType::KING || promotion == PieceType::PAWN) return std::nullopt;
+        san.remove_suffix(1);
+        if (san.back() == '=') san.remove_suffix(1);
+    }
 
-std::optional<Move> MoveParser::resolveAlgebraic(
-    const std::string& token,
-    const Board& board,
-    Color turn,
-    bool& isCapture,
-    bool& isCheck,
-    bool& isCastling,
-    std::optional<PieceType>& promotion
-) {
-    if (token.empty()) return std::nullopt;
+    // The target square is always the last two characters.
+    if (san.size() < 2) return std::nullopt;
+    char targetFile = san[san.size() - 2];
+    char targetRank = san.back();
+    if (targetFile < 'a' || targetFile > 'h' || targetRank < '1' || targetRank > '8') return std::nullopt;
+    Square target(targetFile - 'a', targetRank - '1');
+    san.remove_suffix(2);
 
     PieceType type = PieceType::PAWN;
-    int idx = 0;
-
-    if (std::isupper(token[0]) && token[0] != 'O') {
-        auto optType = charToPieceType(token[0]);
-        if (optType) {
-            type = *optType;
-        }
-        idx++;
+    if (!san.empty() && std::isupper(static_cast<unsigned char>(san.front()))) {
+        auto optType = charToPieceType(san.front());
+        if (!optType.has_value()) return std::nullopt;
+        type = *optType;
+        san.remove_prefix(1);
     }
 
-    std::string disamb;
-    std::string targetStr;
-
-    // A better approach: 
-    // The target square is ALWAYS the last 2 characters of the token (e.g. "e4", "f6", "h8").
-    // Anything before that (after the piece letter) is disambiguation.
-    // CAUTION: This assumes the token is stripped of 'x', '+', '#', '='.
-    // "exf6" -> token is "ef6". Target "f6". Disamb "e".
-    // "Nbd7" -> token "Nbd7". Piece 'N'. Disamb "b". Target "d7".
-    // "R1e2" -> token "R1e2". Piece 'R'. Disamb "1". Target "e2".
-    
-    if (token.size() >= 2 + idx) {
-        // Check if the last two chars form a square
-        if (std::isdigit(token.back()) && 
-            token[token.size()-2] >= 'a' && token[token.size()-2] <= 'h') {
-            
-            targetStr = token.substr(token.size()-2);
-            if (token.size() > 2 + idx) {
-                // There is disambiguation info in between
-                disamb = token.substr(idx, token.size() - 2 - idx);
-            }
-        }
-    } else {
-        // Fallback or error
-        return std::nullopt;
+    // What remains is disambiguation ("b", "1", "b1") and the capture mark.
+    int fromFile = -1;
+    int fromRank = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+        else if (c != 'x' && c != ':' && c != '-') return std::nullopt;
     }
 
-    if (targetStr.empty()) return std::nullopt;
+    if (promotion.has_value()) {
+        int lastRank = turn == Color::WHITE ? 7 : 0;
+        if (type != PieceType::PAWN || target.getRank() != lastRank) return std::nullopt;
+    }
+    if (board.isOwnPiece(target, turn)) return std::nullopt;
 
-    Square target(0,0);
-    if (!Square::fromString(targetStr, target)) return std::nullopt;
+    std::optional<Move> found = std::nullopt;
+    for (const Piece* p : board.getPieces(turn)) {
+        if (p->getType() != type) continue;
+        if (fromFile >= 0 && p->getFile() != fromFile) continue;
+        if (fromRank >= 0 && p->getRank() != fromRank) continue;
 
-    std::vector<Piece*> candidates = getCandidates(type, board, turn, target);
-    if (candidates.empty()) return std::nullopt;
+        if (!reaches(board, p, target)) continue;
 
-    std::vector<Piece*> filtered;
-    for (Piece* p : candidates) {
         Square from(p->getFile(), p->getRank());
-        Move m(from, target, promotion);
-        
-        bool isLegal = board.isLegalMove(m, turn);
-        if (!isLegal) {
-             // std::cout << "DEBUG: Candidate " << (char)('a'+from.getFile()) << from.getRank()+1 
-             //           << " -> " << (char)('a'+target.getFile()) << target.getRank()+1 
-             //           << " is NOT legal." << std::endl;
-             continue;
-        }
+        Move move(from, target, promotion);
+        if (!board.leavesKingSafe(move, turn)) continue;
 
-        if (!disamb.empty()) {
-            bool match = false;
-            // ...
-            if (disamb.size() == 1) {
-                if (disamb[0] >= 'a' && disamb[0] <= 'h') match = (from.getFile() == disamb[0] - 'a');
-                if (disamb[0] >= '1' && disamb[0] <= '8') match = (from.getRank() == disamb[0] - '1');
-            } else if (disamb.size() == 2) {
-                Square s(0,0);
-                if (Square::fromString(disamb, s)) match = (from == s);
-            }
-            if (!match) continue;
-        }
-
-        filtered.push_back(p);
+        if (found.has_value()) return std::nullopt;  // ambiguous
+        found = move;
     }
-
-    if (filtered.size() != 1) return std::nullopt;
-
-    Piece* p = filtered[0];
-    Square from(p->getFile(), p->getRank());
-    return Move(from, target, promotion);
+    return found;
 }
 
-std::vector<Piece*> MoveParser::getCandidates(
-    PieceType type,
-    const Board& board,
-    Color turn,
-    const Square& target
-) {
-    std::vector<Piece*> candidates;
-    for (Piece* p : board.getPieces(turn)) {
-        if (p->getType() != type) continue;
-        for (const Move& m : p->getLegalMoves(board)) {
-            if (m.getTo() == target) {
-                candidates.push_back(p);
-                break;
+bool MoveParser::reaches(const Board& board, const Piece* piece, const Square& target) {
+    int df = target.getFile() - piece->getFile();
+    int dr = target.getRank() - piece->getRank();
+    int adf = std::abs(df);
+    int adr = std::abs(dr);
+    Square from(piece->getFile(), piece->getRank());
+
+    switch (piece->getType()) {
+        case PieceType::KNIGHT:
+            return (adf == 1 && adr == 2) || (adf == 2 && adr == 1);
+        case PieceType::KING:
+            return adf <= 1 && adr <= 1 && (adf | adr) != 0;
+        case PieceType::BISHOP:
+            return adf == adr && adf != 0 && board.isPathClear(from, target);
+        case PieceType::ROOK:
+            return (df == 0) != (dr == 0) && board.isPathClear(from, target);
+        case PieceType::QUEEN:
+            return (adf == adr || df == 0 || dr == 0) && (adf | adr) != 0 && board.isPathClear(from, target);
+        case PieceType::PAWN: {
+            int direction = piece->getColor() == Color::WHITE ? 1 : -1;
+            int startRank = piece->getColor() == Color::WHITE ? 1 : 6;
+            if (df == 0) {
+                if (board.getPieceAt(target) != nullptr) return false;
+                if (dr == direction) return true;
+                return dr == 2 * direction && piece->getRank() == startRank &&
+                       board.isEmpty(piece->getFile(), piece->getRank() + direction);
             }
+            if (adf != 1 || dr != direction) return false;
+            if (board.isEnemy(target.getFile(), target.getRank(), piece->getColor())) return true;
+            return board.isEnPassantAvailable() && board.getEnPassantTarget() == target;
         }
     }
-    return candidates;
-}
\ No newline at end of file
+    return false;
+}
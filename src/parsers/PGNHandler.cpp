@@ -1,50 +1,93 @@
 #include "input/PGNHandler.h"
 #include "input/MoveParser.h"
+#include "input/PGNIndex.h"
+#include "input/PGNWriter.h"
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <iostream>
 #include <cctype>
 
-void PGNHandler::saveToFile(const Game& game, const std::string& filename) {
-    std::ofstream outfile(filename);
-    if (outfile.is_open()) {
-        outfile << generatePGN(game);
-        outfile.close();
-    } else {
+bool PGNHandler::saveToFile(const Game& game, const std::string& filename, const PGNHeader& header) {
+    PGNWriter writer(filename);
+    if (!writer.isOpen()) {
         std::cerr << "Unable to open file for saving: " << filename << std::endl;
+        return false;
     }
+    writer.write(game, header);
+    return writer.close();
 }
 
-std::string PGNHandler::generatePGN(const Game& game) {
-    std::stringstream ss;
-    ss << "[Event \"Console Chess Game\"]\n";
-    ss << "[Date \"????.??.??\"]\n"; 
-    ss << "\n";
+void PGNHandler::loadFromFile(Game& game, const std::string& filename) {
+    PGNReader reader(filename);
+    if (!reader.isOpen()) {
+        std::cerr << "Unable to open file for loading: " << filename << std::endl;
+        return;
+    }
 
-    std::vector<std::string> history = game.getMoveHistory();
-    for (size_t i = 0; i < history.size(); ++i) {
-        if (i % 2 == 0) {
-            ss << (i / 2 + 1) << ". ";
-        }
-        ss << history[i] << " ";
+    // Only the first game of the file is loaded.
+    PGNGame pgn;
+    game = Game();
+    if (reader.next(pgn)) {
+        replay(game, pgn);
     }
-    return ss.str();
 }
 
-void PGNHandler::loadFromFile(Game& game, const std::string& filename) {
-    std::ifstream infile(filename);
-    if (!infile.is_open()) {
-        std::cerr << "Unable to open file for loading: " << filename << std::endl;
-        return;
+bool PGNHandler::loadFromFile(Game& game, const std::string& filename, uint64_t gameNumber) {
+    std::string indexFile = PGNIndex::indexPath(filename);
+    PGNIndex index;
+    if (!index.open(filename, indexFile)) {
+        if (!PGNIndex::build(filename, indexFile).ok || !index.open(filename, indexFile)) {
+            std::cerr << "Unable to index file for loading: " << filename << std::endl;
+            return false;
+        }
+    }
+    if (gameNumber >= index.size()) {
+        std::cerr << filename << " has only " << index.size() << " game(s)" << std::endl;
+        return false;
     }
+    return index.load(gameNumber, game);
+}
 
-    // Reset game
+bool PGNHandler::replay(Game& game, const PGNGame& pgn,
+                        const std::function<void(const Game&, const Move&)>& onMove) {
     game = Game();
+    std::string_view fen = pgn.tag("FEN");
+    if (!fen.empty() && !game.loadFen(std::string(fen))) {
+        std::cerr << "Invalid FEN tag in PGN" << std::endl;
+        return false;
+    }
 
-    std::string content((std::istreambuf_iterator<char>(infile)),
-                        (std::istreambuf_iterator<char>()));
-    infile.close();
+    std::string token;
+    for (std::string_view san : pgn.moves) {
+        token.assign(san.data(), san.size());
+        ParsedMove parsed = MoveParser::parse(token, game.getBoard(), game.getCurrentPlayer());
+        if (!parsed.isValid || !parsed.move.has_value()) {
+            std::cerr << "Invalid move detected in PGN: " << token << std::endl;
+            return false;
+        }
+        if (onMove) onMove(game, parsed.move.value());
+        if (!game.makeMove(parsed.move.value())) {
+            std::cerr << "Failed to apply move from PGN: " << token << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PGNHandler::loadFromString(Game& game, const std::string& content,
+                                const std::function<void(const Game&, const Move&)>& onMove) {
+    // Reset game, starting from the FEN tag if there is one
+    game = Game();
+    size_t fenTag = content.find("[FEN \"");
+    if (fenTag != std::string::npos) {
+        size_t start = fenTag + 6;
+        size_t end = content.find('"', start);
+        if (end == std::string::npos || !game.loadFen(content.substr(start, end - start))) {
+            std::cerr << "Invalid FEN tag in PGN" << std::endl;
+            return false;
+        }
+    }
 
     std::string cleanContent;
     bool inTag = false;
@@ -84,6 +127,7 @@ void PGNHandler::loadFromFile(Game& game, const std::string& filename) {
     
     std::stringstream ss(cleanContent);
     std::string token;
+    bool allApplied = true;
     while (ss >> token) {
         // Skip junk
         if (token.empty()) continue;
@@ -101,22 +145,25 @@ void PGNHandler::loadFromFile(Game& game, const std::string& filename) {
             // Checking if it's just digits (unlikely in PGN unless "1")
         }
 
-        // Handle results like 1-0, 0-1, 1/2-1/2
-        if (token == "1-0" || token == "0-1" || token == "1/2-1/2") {
+        // Handle results like 1-0, 0-1, 1/2-1/2 (or * for unfinished games)
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
             break;
         }
         
         // Parse move
         ParsedMove parsed = MoveParser::parse(token, game.getBoard(), game.getCurrentPlayer());
         if (parsed.isValid && parsed.move.has_value()) {
+            if (onMove) onMove(game, parsed.move.value());
             if (!game.makeMove(parsed.move.value())) {
                  std::cerr << "Failed to apply move from PGN: " << token << std::endl;
                  // Don't break, maybe try next? Usually PGN is strict.
-                 break;
+                 return false;
             }
         } else {
              std::cerr << "Invalid move detected in PGN: " << token << std::endl;
              // Might happen for result tokens if missed above
+             allApplied = false;
         }
     }
+    return allApplied;
 }
@@ -0,0 +1,326 @@
+#include "input/PGNIndex.h"
+#include "input/PGNHandler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PGN_VECTOR_EXTENSIONS 1
+#endif
+
+const uint32_t PGNIndex::VERSION;
+const size_t PGNIndex::HEADER_SIZE;
+const size_t PGNIndex::RECORD_SIZE;
+
+namespace {
+
+const char MAGIC[4] = {'C', 'C', 'P', 'I'};
+
+// Indexed tags, in the order they are stored.
+const char* const TAGS[] = { "White", "Black", "Date", "Result" };
+const int TAG_COUNT = 4;
+
+#ifdef PGN_VECTOR_EXTENSIONS
+// 16 byte lanes: one SSE2/NEON register. Wider types are split into memory
+// operations by GCC unless AVX is enabled, so blocks use several of these.
+typedef uint8_t Bytes __attribute__((vector_size(16)));
+const size_t LANES = 16;
+const size_t BLOCK = 4 * LANES;
+#endif
+
+/**
+ * Reads a little-endian integer.
+ */
+template <typename T>
+T readInt(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+/**
+ * Appends a little-endian integer.
+ */
+template <typename T>
+void appendInt(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Finds the next tag line start ('[' right after a newline) at or after pos,
+ * which must be at least 1. Returns size if there is none.
+ */
+size_t nextTagLine(const char* data, size_t pos, size_t size) {
+#ifdef PGN_VECTOR_EXTENSIONS
+    // Compare each block with itself shifted back by one byte, so a lane is
+    // set only where '[' follows '\n'. Blocks without a hit (all movetext)
+    // cost a handful of instructions per 64 bytes.
+    while (pos + BLOCK <= size) {
+        Bytes hits[4];
+        Bytes any = {};
+        for (int k = 0; k < 4; k++) {
+            Bytes current, previous;
+            std::memcpy(&current, data + pos + k * LANES, LANES);
+            std::memcpy(&previous, data + pos + k * LANES - 1, LANES);
+            hits[k] = reinterpret_cast<Bytes>((current == '[') & (previous == '\n'));
+            any |= hits[k];
+        }
+
+        uint64_t words[2];
+        std::memcpy(words, &any, sizeof(words));
+        if ((words[0] | words[1]) != 0) {
+            for (size_t i = 0; i < BLOCK; i++) {
+                if (hits[i / LANES][i % LANES] != 0) return pos + i;
+            }
+        }
+        pos += BLOCK;
+    }
+#endif
+    for (; pos < size; pos++) {
+        if (data[pos] == '[' && data[pos - 1] == '\n') return pos;
+    }
+    return size;
+}
+
+/**
+ * Gets the end of the line containing pos (the position of its newline, or size).
+ */
+size_t lineEnd(const char* data, size_t pos, size_t size) {
+    const void* newline = std::memchr(data + pos, '\n', size - pos);
+    return newline == nullptr ? size : static_cast<size_t>(static_cast<const char*>(newline) - data);
+}
+
+/**
+ * Checks whether a stretch of text has movetext, i.e. a line that is neither
+ * blank, a tag line nor a '%' escape line.
+ */
+bool hasMovetext(const char* data, size_t from, size_t to) {
+    size_t pos = from;
+    while (pos < to) {
+        char c = data[pos];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            pos++;
+            continue;
+        }
+        if (c != '[' && c != '%') return true;
+        pos = lineEnd(data, pos, to);
+    }
+    return false;
+}
+
+/**
+ * Stores the value of a tag line if it is one of the indexed tags.
+ */
+void readTag(const char* data, size_t start, size_t end, std::string_view* values) {
+    std::string_view line(data + start + 1, end - start - 1);
+    size_t nameEnd = line.find_first_of(" \t");
+    if (nameEnd == std::string_view::npos) return;
+    std::string_view name = line.substr(0, nameEnd);
+    for (int i = 0; i < TAG_COUNT; i++) {
+        if (name != TAGS[i]) continue;
+        size_t open = line.find('"', nameEnd);
+        size_t close = open == std::string_view::npos ? open : line.find('"', open + 1);
+        if (close != std::string_view::npos) values[i] = line.substr(open + 1, close - open - 1);
+        return;
+    }
+}
+
+/**
+ * Appends a string with a one-byte length (longer strings are cut at 255 bytes).
+ */
+void appendString(std::string& out, std::string_view value) {
+    size_t length = std::min<size_t>(value.size(), 255);
+    out += static_cast<char>(length);
+    out.append(value.data(), length);
+}
+
+} // namespace
+
+/**
+ * Gets the default sidecar path of a PGN file.
+ */
+std::string PGNIndex::indexPath(const std::string& pgnFilename) {
+    return pgnFilename + ".idx";
+}
+
+/**
+ * Indexes a PGN file in one pass over its mapping.
+ */
+PGNIndexStats PGNIndex::build(const std::string& pgnFilename, const std::string& indexFilename) {
+    PGNIndexStats stats;
+    auto begin = std::chrono::steady_clock::now();
+    MappedFile pgn;
+    if (!pgn.open(pgnFilename)) return stats;
+    const char* data = pgn.data();
+    size_t size = pgn.size();
+
+    std::string records;
+    std::string strings;
+    std::string_view values[TAG_COUNT];
+    size_t gameStart = 0;
+    size_t lastTagEnd = 0;
+    bool hasTags = false;
+
+    // Closes the current game at the given end.
+    auto finishGame = [&](size_t end) {
+        appendInt<uint64_t>(records, gameStart);
+        appendInt<uint64_t>(records, end - gameStart);
+        appendInt<uint64_t>(records, strings.size());
+        for (std::string_view& value : values) {
+            appendString(strings, value);
+            value = std::string_view();
+        }
+        stats.games++;
+    };
+
+    size_t pos = size > 0 && data[0] == '[' ? 0 : nextTagLine(data, 1, size);
+    while (pos < size) {
+        // A tag line after movetext starts the next game.
+        if (hasMovetext(data, lastTagEnd, pos)) {
+            finishGame(pos);
+            gameStart = pos;
+        }
+        size_t end = lineEnd(data, pos, size);
+        readTag(data, pos, end, values);
+        hasTags = true;
+        lastTagEnd = end;
+        pos = end + 1 < size ? nextTagLine(data, end + 1, size) : size;
+    }
+    if (hasTags || hasMovetext(data, lastTagEnd, size)) finishGame(size);
+
+    std::string header(MAGIC, 4);
+    appendInt<uint32_t>(header, VERSION);
+    appendInt<uint64_t>(header, stats.games);
+    appendInt<uint64_t>(header, size);
+    appendInt<uint64_t>(header, HEADER_SIZE + records.size());
+
+    std::ofstream out(indexFilename, std::ios::binary | std::ios::trunc);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(records.data(), static_cast<std::streamsize>(records.size()));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    out.close();
+
+    stats.ok = !out.fail();
+    stats.bytes = size;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return stats;
+}
+
+/**
+ * Maps a PGN file and its index, checking that they belong together.
+ */
+bool PGNIndex::open(const std::string& pgnFilename, const std::string& indexFilename) {
+    close();
+    if (!pgnFile.open(pgnFilename) || !indexFile.open(indexFilename)) {
+        close();
+        return false;
+    }
+
+    const char* data = indexFile.data();
+    size_t size = indexFile.size();
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || readInt<uint32_t>(data + 4) != VERSION ||
+        readInt<uint64_t>(data + 16) != pgnFile.size()) {
+        close();
+        return false;
+    }
+    gameCount = readInt<uint64_t>(data + 8);
+    stringsOffset = readInt<uint64_t>(data + 24);
+    if (stringsOffset > size || (stringsOffset - HEADER_SIZE) / RECORD_SIZE < gameCount) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Unmaps both files.
+ */
+void PGNIndex::close() {
+    pgnFile.close();
+    indexFile.close();
+    gameCount = 0;
+    stringsOffset = 0;
+}
+
+/**
+ * Checks whether an index is open.
+ */
+bool PGNIndex::isOpen() const {
+    return indexFile.isOpen();
+}
+
+/**
+ * Gets the number of indexed games.
+ */
+uint64_t PGNIndex::size() const {
+    return gameCount;
+}
+
+/**
+ * Gets the location and tags of a game.
+ */
+PGNIndexEntry PGNIndex::entry(uint64_t index) const {
+    PGNIndexEntry entry;
+    const char* record = indexFile.data() + HEADER_SIZE + index * RECORD_SIZE;
+    entry.offset = readInt<uint64_t>(record);
+    entry.length = readInt<uint64_t>(record + 8);
+
+    // The strings are checked against the end of the file in case the index is damaged.
+    uint64_t strings = std::min<uint64_t>(readInt<uint64_t>(record + 16), indexFile.size() - stringsOffset);
+    const char* cursor = indexFile.data() + stringsOffset + strings;
+    const char* end = indexFile.data() + indexFile.size();
+    for (std::string_view* field : {&entry.white, &entry.black, &entry.date, &entry.result}) {
+        if (cursor >= end) break;
+        size_t length = std::min<size_t>(static_cast<uint8_t>(*cursor), end - cursor - 1);
+        *field = std::string_view(cursor + 1, length);
+        cursor += 1 + length;
+    }
+    if (entry.offset > pgnFile.size()) entry.offset = pgnFile.size();
+    entry.length = std::min<uint64_t>(entry.length, pgnFile.size() - entry.offset);
+    return entry;
+}
+
+/**
+ * Gets the raw text of a game.
+ */
+std::string_view PGNIndex::text(uint64_t index) const {
+    PGNIndexEntry game = entry(index);
+    return std::string_view(pgnFile.data() + game.offset, game.length);
+}
+
+/**
+ * Tokenizes a game.
+ */
+void PGNIndex::read(uint64_t index, PGNGame& game) const {
+    PGNReader::tokenize(text(index), game);
+}
+
+/**
+ * Replays a game into a Game.
+ */
+bool PGNIndex::load(uint64_t index, Game& game) const {
+    if (index >= gameCount) return false;
+    PGNGame pgn;
+    read(index, pgn);
+    return PGNHandler::replay(game, pgn);
+}
+
+/**
+ * Finds the games whose tag contains a value.
+ */
+std::vector<uint64_t> PGNIndex::find(std::string_view tag, std::string_view value) const {
+    std::vector<uint64_t> matches;
+    int field = -1;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        if (tag == TAGS[i]) field = i;
+    }
+    if (field < 0) return matches;
+
+    for (uint64_t i = 0; i < gameCount; i++) {
+        PGNIndexEntry game = entry(i);
+        std::string_view values[TAG_COUNT] = { game.white, game.black, game.date, game.result };
+        if (values[field].find(value) != std::string_view::npos) matches.push_back(i);
+    }
+    return matches;
+}
@@ -0,0 +1,153 @@
+#include "input/PGNPipeline.h"
+#include "input/PGNHandler.h"
+#include "util/BoundedQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Seconds elapsed since a time point.
+ */
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * Per-worker counters, merged after the run.
+ */
+struct WorkerStats {
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    uint64_t failed = 0;
+    double parseSeconds = 0;
+    double replaySeconds = 0;
+    double idleSeconds = 0;
+};
+
+} // namespace
+
+/**
+ * Resolves the number of worker threads.
+ */
+int PGNPipeline::workerCount(const PipelineOptions& options) {
+    if (options.threads > 0) return options.threads;
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+/**
+ * Ingests a PGN file with one reader and a pool of workers.
+ */
+PipelineStats PGNPipeline::run(const std::string& filename, const PipelineOptions& options,
+                               const GameHandler& onGame, const MoveHandler& onMove) {
+    PipelineStats stats;
+    PGNReader reader(filename);
+    if (!reader.isOpen()) return stats;
+    stats.opened = true;
+    stats.threads = workerCount(options);
+
+    // A run of consecutive games and the number of the first one.
+    struct Batch {
+        uint64_t first = 0;
+        std::vector<std::string> texts;
+    };
+    size_t batchSize = std::max<size_t>(1, options.batchSize);
+    BoundedQueue<Batch> queue(options.queueBatches > 0 ? options.queueBatches : 4 * stats.threads);
+    std::vector<WorkerStats> workerStats(stats.threads);
+    auto begin = Clock::now();
+
+    auto work = [&](int index) {
+        WorkerStats& mine = workerStats[index];
+        PGNGame pgn;
+        Game game;
+        while (true) {
+            auto waitStart = Clock::now();
+            std::optional<Batch> batch = queue.pop();
+            mine.idleSeconds += secondsSince(waitStart);
+            if (!batch.has_value()) break;
+
+            for (size_t i = 0; i < batch->texts.size(); i++) {
+                auto parseStart = Clock::now();
+                PGNReader::tokenize(batch->texts[i], pgn);
+                pgn.number = batch->first + i;
+                mine.parseSeconds += secondsSince(parseStart);
+                mine.games++;
+                mine.moves += pgn.moves.size();
+
+                bool replayed = true;
+                if (options.replay) {
+                    auto replayStart = Clock::now();
+                    std::function<void(const Game&, const Move&)> callback = nullptr;
+                    if (onMove) {
+                        callback = [&](const Game& position, const Move& move) { onMove(index, pgn, position, move); };
+                    }
+                    replayed = PGNHandler::replay(game, pgn, callback);
+                    if (!replayed) mine.failed++;
+                    mine.replaySeconds += secondsSince(replayStart);
+                }
+                if (onGame) onGame(index, pgn, game, replayed);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < stats.threads; i++) workers.emplace_back(work, i);
+
+    // Reader: this thread splits games and fills the queue.
+    Batch batch;
+    batch.texts.reserve(batchSize);
+    std::string text;
+    while (true) {
+        auto readStart = Clock::now();
+        bool more = reader.nextText(text);
+        if (more) batch.texts.push_back(std::move(text));
+        stats.readSeconds += secondsSince(readStart);
+
+        if (batch.texts.size() == batchSize || (!more && !batch.texts.empty())) {
+            auto pushStart = Clock::now();
+            uint64_t next = batch.first + batch.texts.size();
+            queue.push(std::move(batch));
+            stats.blockedSeconds += secondsSince(pushStart);
+            batch = Batch();
+            batch.first = next;
+            batch.texts.reserve(batchSize);
+        }
+        if (!more) break;
+    }
+    queue.close();
+    for (std::thread& worker : workers) worker.join();
+
+    stats.wallSeconds = secondsSince(begin);
+    stats.bytes = reader.getBytesRead();
+    for (const WorkerStats& worker : workerStats) {
+        stats.games += worker.games;
+        stats.moves += worker.moves;
+        stats.failed += worker.failed;
+        stats.parseSeconds += worker.parseSeconds;
+        stats.replaySeconds += worker.replaySeconds;
+        stats.idleSeconds += worker.idleSeconds;
+    }
+    return stats;
+}
+
+/**
+ * Prints throughput and the per-stage breakdown.
+ */
+void PGNPipeline::printStats(const PipelineStats& stats, std::ostream& out) {
+    double wall = stats.wallSeconds > 0 ? stats.wallSeconds : 1e-9;
+    out << "Games:    " << stats.games << " (" << stats.failed << " failed to replay)" << std::endl;
+    out << "Moves:    " << stats.moves << std::endl;
+    out << "Threads:  " << stats.threads << " workers + 1 reader" << std::endl;
+    out << "Wall:     " << stats.wallSeconds << " s, " << static_cast<long long>(stats.games / wall)
+        << " games/s, " << static_cast<long long>(stats.moves / wall) << " moves/s, "
+        << stats.bytes / wall / (1 << 20) << " MB/s" << std::endl;
+    out << "Reader:   " << stats.readSeconds << " s reading, " << stats.blockedSeconds
+        << " s blocked on a full queue" << std::endl;
+    out << "Workers:  " << stats.parseSeconds << " s tokenizing, " << stats.replaySeconds << " s replaying, "
+        << stats.idleSeconds << " s idle (summed over workers)" << std::endl;
+}
@@ -0,0 +1,365 @@
+#include "input/PGNReader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PGN_VECTOR_EXTENSIONS 1
+#endif
+
+namespace {
+
+#ifdef PGN_VECTOR_EXTENSIONS
+// 16 byte lanes: one SSE2/NEON register (wider types are split into memory
+// operations by GCC unless AVX is enabled).
+typedef uint8_t Bytes __attribute__((vector_size(16)));
+
+/**
+ * Packs the top bit of each byte lane into a 16-bit mask (lane i -> bit i).
+ */
+uint64_t laneBits(const Bytes& lanes) {
+    uint64_t words[2];
+    std::memcpy(words, &lanes, sizeof(words));
+    const uint64_t top = 0x8080808080808080ULL;
+    const uint64_t gather = 0x0002040810204081ULL;  // moves bit 8i+7 to bit 56+i
+    return (((words[0] & top) * gather) >> 56) | ((((words[1] & top) * gather) >> 56) << 8);
+}
+#endif
+
+/**
+ * Gets the index of the lowest set bit of a non-zero mask.
+ */
+int lowestBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * Finds whitespace and token ends in a text 64 bytes at a time. Each block
+ * is classified once into two bit masks, so skipping blanks and finding the
+ * end of a token are bit scans instead of per-character tests.
+ */
+class DelimiterScanner {
+private:
+    const char* data;
+    size_t size;
+    size_t blockStart = SIZE_MAX;
+    uint64_t space = 0;  // bit i: byte blockStart + i is whitespace
+    uint64_t stop = 0;   // bit i: whitespace or one of { ( ) ;
+
+    /**
+     * Classifies the block starting at an offset (a multiple of 64).
+     */
+    void load(size_t block) {
+        char padded[64];
+        const char* bytes = data + block;
+        if (size - block < 64) {
+            std::memset(padded, ' ', sizeof(padded));  // past the end counts as blank
+            std::memcpy(padded, bytes, size - block);
+            bytes = padded;
+        }
+
+        blockStart = block;
+        space = 0;
+        stop = 0;
+#ifdef PGN_VECTOR_EXTENSIONS
+        for (int k = 0; k < 4; k++) {
+            Bytes v;
+            std::memcpy(&v, bytes + 16 * k, 16);
+            // isspace(): ' ' and '\t' '\n' '\v' '\f' '\r' (9 to 13).
+            Bytes blank = reinterpret_cast<Bytes>((static_cast<Bytes>(v - 9) < 5) | (v == ' '));
+            Bytes ends = blank | reinterpret_cast<Bytes>((v == '{') | (v == '(') | (v == ')') | (v == ';'));
+            space |= laneBits(blank) << (16 * k);
+            stop |= laneBits(ends) << (16 * k);
+        }
+#else
+        for (int i = 0; i < 64; i++) {
+            unsigned char c = static_cast<unsigned char>(bytes[i]);
+            bool blank = std::isspace(c) != 0;
+            if (blank) space |= 1ULL << i;
+            if (blank || c == '{' || c == '(' || c == ')' || c == ';') stop |= 1ULL << i;
+        }
+#endif
+    }
+
+    /**
+     * Gets the first position at or after pos whose bit is set in a mask of
+     * the current block, loading blocks as needed. The blank padding past the
+     * end means the result is never beyond size.
+     */
+    size_t scan(size_t pos, bool wantBlank) {
+        while (pos < size) {
+            size_t block = pos & ~static_cast<size_t>(63);
+            if (block != blockStart) load(block);
+            uint64_t bits = (wantBlank ? stop : ~space) >> (pos - block);
+            if (bits != 0) return pos + lowestBit(bits);
+            pos = block + 64;
+        }
+        return size;
+    }
+
+public:
+    /**
+     * Creates a scanner over a text.
+     */
+    DelimiterScanner(const char* data, size_t size) : data(data), size(size) {}
+
+    /**
+     * Gets the first non-whitespace position at or after pos, or size.
+     */
+    size_t skipSpace(size_t pos) {
+        return scan(pos, false);
+    }
+
+    /**
+     * Gets the first position at or after pos that ends a token, or size.
+     */
+    size_t findStop(size_t pos) {
+        return scan(pos, true);
+    }
+};
+
+} // namespace
+
+/**
+ * Looks up a tag value.
+ */
+std::string_view PGNGame::tag(std::string_view name) const {
+    for (const auto& entry : tags) {
+        if (entry.first == name) return entry.second;
+    }
+    return std::string_view();
+}
+
+/**
+ * Opens a PGN file.
+ */
+PGNReader::PGNReader(const std::string& filename, size_t bufferSize)
+    : file(filename, std::ios::binary), buffer(std::max<size_t>(bufferSize, 4096)) {}
+
+/**
+ * Checks whether the file was opened.
+ */
+bool PGNReader::isOpen() const {
+    return file.is_open();
+}
+
+/**
+ * Reads the next line; lines that fit in the buffer are returned in place.
+ */
+bool PGNReader::readLine(std::string_view& line) {
+    lineCarry.clear();
+    while (true) {
+        if (bufferPos == bufferEnd) {
+            if (endOfFile) break;
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            bufferEnd = static_cast<size_t>(file.gcount());
+            bufferPos = 0;
+            bytesRead += bufferEnd;
+            if (bufferEnd < buffer.size()) endOfFile = true;
+            if (bufferEnd == 0) break;
+        }
+
+        const char* start = buffer.data() + bufferPos;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', bufferEnd - bufferPos));
+        if (newline != nullptr) {
+            size_t length = static_cast<size_t>(newline - start);
+            bufferPos += length + 1;
+            if (lineCarry.empty()) {
+                line = std::string_view(start, length);
+            } else {
+                lineCarry.append(start, length);
+                line = lineCarry;
+            }
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            return true;
+        }
+
+        // The line continues in the next buffer fill.
+        lineCarry.append(start, bufferEnd - bufferPos);
+        bufferPos = bufferEnd;
+    }
+
+    if (lineCarry.empty()) return false;
+    line = lineCarry;
+    if (line.back() == '\r') line.remove_suffix(1);
+    return true;
+}
+
+/**
+ * Reads the next game.
+ */
+bool PGNReader::next(PGNGame& game) {
+    if (!readGame()) return false;
+    tokenize(gameText, game);
+    game.number = gamesRead - 1;
+    return true;
+}
+
+/**
+ * Reads the raw text of the next game.
+ */
+bool PGNReader::nextText(std::string& text) {
+    if (!readGame()) return false;
+    text.swap(gameText);  // hand over the buffer instead of copying it
+    return true;
+}
+
+/**
+ * Collects the lines of the next game into gameText.
+ */
+bool PGNReader::readGame() {
+    gameText.clear();
+    bool inMoves = false;
+    bool hasContent = false;
+
+    std::string_view line;
+    while (true) {
+        if (hasPendingLine) {
+            line = pendingLine;
+            hasPendingLine = false;
+        } else if (!readLine(line)) {
+            break;
+        }
+
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos) continue;
+        bool isTag = line[first] == '[';
+        if (isTag && inMoves) {
+            // First line of the next game: keep it for the next call.
+            pendingLine.assign(line.data(), line.size());
+            hasPendingLine = true;
+            break;
+        }
+        if (!isTag && line[first] != '%') inMoves = true;
+
+        gameText.append(line.data(), line.size());
+        gameText += '\n';
+        hasContent = true;
+    }
+
+    if (!hasContent) return false;
+    gamesRead++;
+    return true;
+}
+
+/**
+ * Splits the text of one game into tags, move tokens and the result.
+ */
+void PGNReader::tokenize(std::string_view text, PGNGame& game) {
+    game.tags.clear();
+    game.moves.clear();
+    game.result = std::string_view();
+    game.text = text;
+
+    const char* data = text.data();
+    size_t size = text.size();
+    DelimiterScanner scanner(data, size);
+    size_t i = 0;
+    int variationDepth = 0;
+
+    while ((i = scanner.skipSpace(i)) < size) {
+        char c = data[i];
+
+        if (c == '[' && variationDepth == 0) {
+            // [Name "Value"]
+            size_t end = text.find('\n', i);
+            if (end == std::string_view::npos) end = size;
+            size_t nameStart = i + 1;
+            size_t nameEnd = nameStart;
+            while (nameEnd < end && !std::isspace(static_cast<unsigned char>(data[nameEnd]))) nameEnd++;
+            size_t open = text.find('"', nameEnd);
+            size_t close = open == std::string_view::npos ? std::string_view::npos : text.find('"', open + 1);
+            if (open < end && close < end) {
+                game.tags.emplace_back(std::string_view(data + nameStart, nameEnd - nameStart),
+                                       std::string_view(data + open + 1, close - open - 1));
+            }
+            i = end;
+            continue;
+        }
+        if (c == '%') {
+            // Escape line, if only blanks precede it on its line.
+            size_t back = i;
+            while (back > 0 && data[back - 1] != '\n' && std::isspace(static_cast<unsigned char>(data[back - 1]))) back--;
+            if (back == 0 || data[back - 1] == '\n') {
+                size_t end = text.find('\n', i);
+                i = end == std::string_view::npos ? size : end;
+                continue;
+            }
+        }
+        if (c == '{') {
+            size_t end = text.find('}', i);
+            i = end == std::string_view::npos ? size : end + 1;
+            continue;
+        }
+        if (c == ';') {
+            size_t end = text.find('\n', i);
+            i = end == std::string_view::npos ? size : end;
+            continue;
+        }
+        if (c == '(') {
+            variationDepth++;
+            i++;
+            continue;
+        }
+        if (c == ')') {
+            if (variationDepth > 0) variationDepth--;
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        i = scanner.findStop(i);
+        if (variationDepth > 0) continue;
+        std::string_view token(data + start, i - start);
+
+        char first = token[0];
+        if ((first == '1' || first == '0' || first == '*') &&
+            (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*")) {
+            game.result = token;
+            continue;
+        }
+        if (first == '$') continue;  // NAG
+
+        // Move numbers, possibly glued to the move ("12.", "12...", "12.Nf3").
+        if (first >= '0' && first <= '9') {
+            size_t dot = token.find_last_of('.');
+            if (dot == std::string_view::npos) continue;
+            token.remove_prefix(dot + 1);
+            if (token.empty()) continue;
+        }
+        // Annotation suffixes ("e4!?", "Nf3?") are not part of SAN.
+        while (!token.empty() && (token.back() == '!' || token.back() == '?')) token.remove_suffix(1);
+        if (!token.empty()) game.moves.push_back(token);
+    }
+}
+
+/**
+ * Gets the number of bytes consumed so far.
+ */
+uint64_t PGNReader::getBytesRead() const {
+    return bytesRead;
+}
+
+/**
+ * Gets the number of games returned so far.
+ */
+uint64_t PGNReader::getGamesRead() const {
+    return gamesRead;
+}
+
+/**
+ * Gets the capacity of the game buffer.
+ */
+size_t PGNReader::getGameCapacity() const {
+    return gameText.capacity();
+}
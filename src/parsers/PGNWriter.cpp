@@ -0,0 +1,192 @@
+#include "input/PGNWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+/**
+ * Appends a tag pair, escaping quotes and backslashes in the value.
+ */
+void appendTag(std::string& out, std::string_view name, std::string_view value) {
+    out += '[';
+    out += name;
+    out += " \"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    out += "\"]\n";
+}
+
+/**
+ * Appends a movetext token, breaking the line when it would get too long.
+ */
+void appendToken(std::string& out, size_t& lineStart, std::string_view token) {
+    if (out.size() > lineStart) {
+        if (out.size() - lineStart + 1 + token.size() > PGNWriter::LINE_LENGTH) {
+            out += '\n';
+            lineStart = out.size();
+        } else {
+            out += ' ';
+        }
+    }
+    out += token;
+}
+
+} // namespace
+
+/**
+ * Opens a PGN file for writing.
+ */
+PGNWriter::PGNWriter(const std::string& filename, size_t chunkSize, bool background)
+    : file(filename, std::ios::binary | std::ios::trunc), chunkSize(std::max<size_t>(chunkSize, 4096)),
+      background(background), chunks(2) {
+    buffer.reserve(this->chunkSize + 4096);
+    if (background && file.is_open()) {
+        writerThread = std::thread([this] {
+            while (std::optional<std::string> chunk = chunks.pop()) {
+                file.write(chunk->data(), static_cast<std::streamsize>(chunk->size()));
+                if (!file) writeFailed = true;
+            }
+        });
+    }
+}
+
+/**
+ * Flushes and closes the file.
+ */
+PGNWriter::~PGNWriter() {
+    close();
+}
+
+/**
+ * Checks whether the file was opened.
+ */
+bool PGNWriter::isOpen() const {
+    return file.is_open();
+}
+
+/**
+ * Appends a game, writing a chunk once the buffer is full.
+ */
+void PGNWriter::write(const Game& game, const PGNHeader& header) {
+    if (closed || !file.is_open()) return;
+    size_t before = buffer.size();
+    append(buffer, game, header);
+    bytesWritten += buffer.size() - before;
+    gamesWritten++;
+    if (buffer.size() >= chunkSize) flushBuffer();
+}
+
+/**
+ * Writes out the buffered text, or hands it to the writer thread.
+ */
+void PGNWriter::flushBuffer() {
+    if (buffer.empty()) return;
+    if (background) {
+        std::string next;
+        next.reserve(chunkSize + 4096);
+        chunks.push(std::exchange(buffer, std::move(next)));
+    } else {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!file) writeFailed = true;
+        buffer.clear();
+    }
+}
+
+/**
+ * Writes all buffered text and closes the file.
+ */
+bool PGNWriter::close() {
+    if (closed) return !writeFailed;
+    closed = true;
+    if (!file.is_open()) return false;
+    flushBuffer();
+    if (writerThread.joinable()) {
+        chunks.close();
+        writerThread.join();
+    }
+    file.close();
+    if (!file) writeFailed = true;
+    return !writeFailed;
+}
+
+/**
+ * Gets the number of games written.
+ */
+uint64_t PGNWriter::getGamesWritten() const {
+    return gamesWritten;
+}
+
+/**
+ * Gets the number of bytes formatted so far.
+ */
+uint64_t PGNWriter::getBytesWritten() const {
+    return bytesWritten;
+}
+
+/**
+ * Formats one game in PGN export format.
+ */
+void PGNWriter::append(std::string& out, const Game& game, const PGNHeader& header) {
+    const char* gameResult = header.result.empty() ? result(game) : header.result.c_str();
+    appendTag(out, "Event", header.event);
+    appendTag(out, "Site", header.site);
+    appendTag(out, "Date", header.date);
+    appendTag(out, "Round", header.round);
+    appendTag(out, "White", header.white);
+    appendTag(out, "Black", header.black);
+    appendTag(out, "Result", gameResult);
+
+    // Move numbers continue from the set-up position, which may have Black to move.
+    int moveNumber = 1;
+    bool blackFirst = false;
+    const std::string& fen = game.getStartFen();
+    if (!fen.empty()) {
+        appendTag(out, "SetUp", "1");
+        appendTag(out, "FEN", fen);
+        blackFirst = fen.find(" b ") != std::string::npos;
+        size_t last = fen.rfind(' ');
+        if (last != std::string::npos) std::from_chars(fen.data() + last + 1, fen.data() + fen.size(), moveNumber);
+    }
+    out += '\n';
+
+    size_t lineStart = out.size();
+    char number[16];
+    const std::vector<std::string>& history = game.getMoveHistory();
+    for (size_t i = 0; i < history.size(); ++i) {
+        size_t ply = i + (blackFirst ? 1 : 0);
+        if (ply % 2 == 0 || i == 0) {
+            char* end = std::to_chars(number, number + sizeof(number) - 3, moveNumber + static_cast<int>(ply / 2)).ptr;
+            *end++ = '.';
+            if (ply % 2 == 1) {
+                *end++ = '.';
+                *end++ = '.';
+            }
+            appendToken(out, lineStart, std::string_view(number, end - number));
+        }
+        appendToken(out, lineStart, history[i]);
+    }
+    appendToken(out, lineStart, gameResult);
+    out += "\n\n";
+}
+
+/**
+ * Gets the PGN result of a game.
+ */
+const char* PGNWriter::result(const Game& game) {
+    switch (game.getState()) {
+        case GameState::CHECKMATE:
+        case GameState::RESIGNED:
+            // The side to move is the one that was mated or resigned.
+            return game.getCurrentPlayer() == Color::WHITE ? "0-1" : "1-0";
+        case GameState::DRAW:
+        case GameState::STALEMATE:
+            return "1/2-1/2";
+        default:
+            return "*";
+    }
+}
@@ -0,0 +1,486 @@
+#include "server/GameServer.h"
+#include <iostream>
+
+#ifdef __linux__
+#include "board/Board.h"
+#include "engine/Search.h"
+#include "engine/TranspositionTable.h"
+#include "game/Game.h"
+#include "input/MoveParser.h"
+#include "util/BoundedQueue.h"
+#include "util/LatencyStats.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+const size_t GameServer::MAX_LINE;
+
+#ifdef __linux__
+namespace {
+
+// Every connection has at most one search queued or running, so the job
+// queue never fills up before the process runs out of descriptors.
+const size_t JOB_CAPACITY = 1 << 20;
+const int MAX_EVENTS = 256;
+
+/**
+ * A position for the engine. The game serial tells whether the game that
+ * asked is still the one on the connection when the answer arrives.
+ */
+struct EngineJob {
+    int fd;
+    uint64_t serial;
+    Board board;
+    Color side;
+};
+
+/**
+ * The engine's answer to an EngineJob.
+ */
+struct EngineReply {
+    int fd;
+    uint64_t serial;
+    std::optional<Move> move;
+};
+
+/**
+ * One client and its game.
+ */
+struct Connection {
+    int fd = -1;
+    uint64_t serial = 0;             // unique per game, see EngineJob
+    Game game;
+    std::optional<Color> engineColor;
+    bool engineThinking = false;
+    bool closing = false;            // close once the output is sent
+    bool watchingOutput = false;     // EPOLLOUT registered
+    std::string input;
+    std::string output;
+};
+
+/**
+ * Gets the protocol name of a game state.
+ */
+const char* stateName(GameState state) {
+    switch (state) {
+        case GameState::ONGOING:   return "ongoing";
+        case GameState::CHECK:     return "check";
+        case GameState::CHECKMATE: return "checkmate";
+        case GameState::STALEMATE: return "stalemate";
+        case GameState::DRAW:      return "draw";
+        case GameState::RESIGNED:  return "resigned";
+    }
+    return "ongoing";
+}
+
+/**
+ * Checks whether moves can still be played in a state.
+ */
+bool isPlayable(GameState state) {
+    return state == GameState::ONGOING || state == GameState::CHECK;
+}
+
+/**
+ * The event loop and everything it owns.
+ */
+class Server {
+private:
+    const ServerOptions& options;
+    int epollFd = -1;
+    int listenFd = -1;
+    int wakeFd = -1;     // eventfd written by the engine threads
+    int signalFd = -1;
+    uint64_t nextSerial = 1;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+    BoundedQueue<EngineJob> jobs;
+    std::vector<std::thread> workers;
+    std::mutex repliesLock;
+    std::vector<EngineReply> replies;
+
+    uint64_t accepted = 0;
+    size_t peakConnections = 0;
+    uint64_t engineMoves = 0;
+    LatencyStats validation;
+
+    /**
+     * Registers a descriptor with the epoll set.
+     */
+    bool watch(int fd, uint32_t events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    /**
+     * Opens the listening socket.
+     */
+    bool listenOn() {
+        if (options.port > 0) {
+            listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listenFd < 0) return false;
+            int on = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(options.port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return false;
+        } else {
+            sockaddr_un address{};
+            if (options.socketPath.empty() || options.socketPath.size() >= sizeof(address.sun_path)) return false;
+            listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listenFd < 0) return false;
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+            unlink(options.socketPath.c_str());
+            if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return false;
+        }
+        return listen(listenFd, SOMAXCONN) == 0 && watch(listenFd, EPOLLIN);
+    }
+
+    /**
+     * Accepts every pending connection.
+     */
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EMFILE || errno == ENFILE) {
+                    std::cerr << "Out of file descriptors (raise ulimit -n)" << std::endl;
+                }
+                return;
+            }
+            if (options.port > 0) {
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+            if (!watch(fd, EPOLLIN | EPOLLRDHUP)) {
+                close(fd);
+                continue;
+            }
+            std::unique_ptr<Connection> connection(new Connection());
+            connection->fd = fd;
+            connection->serial = nextSerial++;
+            connections[fd] = std::move(connection);
+            accepted++;
+            peakConnections = std::max(peakConnections, connections.size());
+        }
+    }
+
+    /**
+     * Closes a connection and forgets it.
+     */
+    void drop(int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    /**
+     * Sends as much queued output as the socket takes and watches for
+     * writability while some is left. Returns false if the connection was closed.
+     */
+    bool flush(Connection& connection) {
+        size_t sent = 0;
+        while (sent < connection.output.size()) {
+            ssize_t count = send(connection.fd, connection.output.data() + sent,
+                                 connection.output.size() - sent, MSG_NOSIGNAL);
+            if (count < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                drop(connection.fd);
+                return false;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        connection.output.erase(0, sent);
+
+        if (connection.output.empty() && connection.closing) {
+            drop(connection.fd);
+            return false;
+        }
+        bool pending = !connection.output.empty();
+        if (pending != connection.watchingOutput) {
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            event.data.fd = connection.fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+            connection.watchingOutput = pending;
+        }
+        return true;
+    }
+
+    /**
+     * Queues a search for the side to move.
+     */
+    void askEngine(Connection& connection) {
+        connection.engineThinking = true;
+        jobs.push(EngineJob{connection.fd, connection.serial, connection.game.getBoard(),
+                            connection.game.getCurrentPlayer()});
+    }
+
+    /**
+     * Validates and plays a client move.
+     */
+    void playMove(Connection& connection, std::string_view text) {
+        Game& game = connection.game;
+        if (!isPlayable(game.getState())) {
+            connection.output += "error game over\n";
+            return;
+        }
+        if (connection.engineThinking || connection.engineColor == game.getCurrentPlayer()) {
+            connection.output += "error not your turn\n";
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ParsedMove parsed = MoveParser::parse(text, game.getBoard(), game.getCurrentPlayer());
+        bool played = parsed.isValid && parsed.move.has_value() && game.makeMove(parsed.move.value());
+        validation.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+        if (!played) {
+            connection.output += "illegal ";
+            connection.output.append(text.data(), text.size());
+            connection.output += '\n';
+            return;
+        }
+        connection.output += "ok " + parsed.move->toString() + " " + stateName(game.getState()) + "\n";
+        if (connection.engineColor.has_value() && isPlayable(game.getState())) askEngine(connection);
+    }
+
+    /**
+     * Executes one command line. Returns false once the connection should stop reading.
+     */
+    bool handleLine(Connection& connection, std::string_view line) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        size_t split = line.find(' ');
+        std::string_view command = line.substr(0, split);
+        std::string_view argument = split == std::string_view::npos ? std::string_view() : line.substr(split + 1);
+        while (!argument.empty() && argument.front() == ' ') argument.remove_prefix(1);
+
+        if (command == "move" && !argument.empty()) {
+            playMove(connection, argument);
+        } else if (command == "new" && (argument.empty() || argument == "white" || argument == "black")) {
+            connection.game = Game();
+            connection.serial = nextSerial++;
+            connection.engineThinking = false;
+            connection.engineColor.reset();
+            if (argument == "white") connection.engineColor = Color::BLACK;
+            if (argument == "black") connection.engineColor = Color::WHITE;
+            connection.output += "ok new\n";
+            if (connection.engineColor == Color::WHITE) askEngine(connection);
+        } else if (command == "fen") {
+            connection.output += "fen " + connection.game.toFen() + "\n";
+        } else if (command == "quit") {
+            connection.closing = true;
+            return false;
+        } else if (!command.empty()) {
+            connection.output += "error unknown command\n";
+        }
+        return true;
+    }
+
+    /**
+     * Reads from a client and answers its complete lines.
+     */
+    void readFrom(Connection& connection) {
+        char buffer[16384];
+        ssize_t count = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            drop(connection.fd);
+            return;
+        }
+        if (count < 0) return;
+        connection.input.append(buffer, static_cast<size_t>(count));
+
+        size_t start = 0;
+        size_t newline;
+        while ((newline = connection.input.find('\n', start)) != std::string::npos) {
+            std::string_view line(connection.input.data() + start, newline - start);
+            start = newline + 1;
+            if (!handleLine(connection, line)) break;
+        }
+        connection.input.erase(0, start);
+        if (connection.input.size() > GameServer::MAX_LINE) {
+            drop(connection.fd);
+            return;
+        }
+        flush(connection);
+    }
+
+    /**
+     * Plays the engine moves that finished since the last wake-up.
+     */
+    void deliverReplies() {
+        uint64_t counter;
+        while (read(wakeFd, &counter, sizeof(counter)) > 0) {}
+
+        std::vector<EngineReply> ready;
+        {
+            std::lock_guard<std::mutex> guard(repliesLock);
+            ready.swap(replies);
+        }
+        for (const EngineReply& reply : ready) {
+            auto found = connections.find(reply.fd);
+            if (found == connections.end() || found->second->serial != reply.serial) continue;
+            Connection& connection = *found->second;
+            connection.engineThinking = false;
+            if (reply.move.has_value() && connection.game.makeMove(reply.move.value())) {
+                engineMoves++;
+                connection.output += "engine " + reply.move->toString() + " " +
+                                     stateName(connection.game.getState()) + "\n";
+            } else {
+                connection.output += "error engine has no move\n";
+            }
+            flush(connection);
+        }
+    }
+
+    /**
+     * Searches queued positions until the queue is closed. Each worker owns
+     * its table: the jobs come from unrelated games, and separate tables
+     * keep one search from aging another's entries.
+     */
+    void engineWorker(size_t hashMb) {
+        TranspositionTable table(hashMb);
+        Search search(table);
+        SearchLimits limits;
+        limits.depth = options.depth;
+        while (std::optional<EngineJob> job = jobs.pop()) {
+            SearchResult result = search.run(job->board, job->side, limits);
+            {
+                std::lock_guard<std::mutex> guard(repliesLock);
+                replies.push_back(EngineReply{job->fd, job->serial, result.bestMove});
+            }
+            uint64_t one = 1;
+            ssize_t written = write(wakeFd, &one, sizeof(one));
+            (void)written;
+        }
+    }
+
+public:
+    /**
+     * Creates the server (nothing is opened yet).
+     */
+    explicit Server(const ServerOptions& options)
+        : options(options), jobs(JOB_CAPACITY) {}
+
+    /**
+     * Closes every descriptor and stops the engine threads.
+     */
+    ~Server() {
+        jobs.close();
+        for (std::thread& worker : workers) worker.join();
+        for (auto& entry : connections) close(entry.first);
+        for (int fd : {listenFd, wakeFd, signalFd, epollFd}) {
+            if (fd >= 0) close(fd);
+        }
+        if (options.port == 0 && listenFd >= 0) unlink(options.socketPath.c_str());
+    }
+
+    /**
+     * Serves until SIGINT or SIGTERM.
+     */
+    int serve() {
+        // The signals are delivered through a descriptor; blocking them
+        // before the workers start keeps them off the other threads.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0 || signalFd < 0 || !watch(wakeFd, EPOLLIN) || !watch(signalFd, EPOLLIN)) {
+            std::cerr << "Cannot set up the event loop: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        if (!listenOn()) {
+            std::cerr << "Cannot listen on "
+                      << (options.port > 0 ? "port " + std::to_string(options.port) : options.socketPath)
+                      << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        int threads = options.workers > 0 ? options.workers
+                                          : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        size_t hashMb = std::max<size_t>(1, options.hashMb / threads);
+        for (int i = 0; i < threads; i++) workers.emplace_back(&Server::engineWorker, this, hashMb);
+        std::cout << "Listening on "
+                  << (options.port > 0 ? "127.0.0.1:" + std::to_string(options.port) : options.socketPath)
+                  << " (" << threads << " engine threads, depth " << options.depth << ")" << std::endl;
+
+        epoll_event events[MAX_EVENTS];
+        bool running = true;
+        while (running) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+            if (count < 0 && errno != EINTR) break;
+            for (int i = 0; i < count; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptClients();
+                } else if (fd == wakeFd) {
+                    deliverReplies();
+                } else if (fd == signalFd) {
+                    running = false;
+                } else {
+                    auto found = connections.find(fd);
+                    if (found == connections.end()) continue;
+                    Connection& connection = *found->second;
+                    if (events[i].events & EPOLLIN) {
+                        readFrom(connection);
+                    } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                        drop(fd);
+                    } else if (events[i].events & EPOLLOUT) {
+                        flush(connection);
+                    }
+                }
+            }
+        }
+
+        std::cout << "Connections: " << accepted << " (peak " << peakConnections << "), moves validated: "
+                  << validation.count() << ", engine moves: " << engineMoves << std::endl;
+        std::cout << "Move validation: p50 " << validation.percentileUs(50) << " us, p99 "
+                  << validation.percentileUs(99) << " us, max " << validation.percentileUs(100) << " us" << std::endl;
+        return 0;
+    }
+};
+
+} // namespace
+#endif
+
+/**
+ * Listens and serves games until interrupted.
+ */
+int GameServer::run(const ServerOptions& options) {
+#ifdef __linux__
+    Server server(options);
+    return server.serve();
+#else
+    (void)options;
+    std::cerr << "chess serve needs Linux (epoll)" << std::endl;
+    return 2;
+#endif
+}
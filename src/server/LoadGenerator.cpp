@@ -0,0 +1,386 @@
+#include "server/LoadGenerator.h"
+#include <iostream>
+
+#ifdef __linux__
+#include "board/Board.h"
+#include "engine/Search.h"
+#include "game/Game.h"
+#include "util/LatencyStats.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int MAX_EVENTS = 256;
+
+/**
+ * One simulated player and its copy of the game.
+ */
+struct Client {
+    int fd = -1;
+    Board board;
+    Color side = Color::WHITE;       // side to move on the local board
+    int plies = 0;
+    std::optional<Move> sentMove;    // waiting for "ok"
+    Clock::time_point sentAt;
+    bool watchingOutput = false;
+    std::string input;
+    std::string output;
+};
+
+/**
+ * Gets the other color.
+ */
+Color opponent(Color color) {
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+/**
+ * Checks whether a state word from the server means the game goes on.
+ */
+bool isPlayable(std::string_view state) {
+    return state == "ongoing" || state == "check";
+}
+
+/**
+ * Opens a blocking connection to the server, then makes it non-blocking.
+ */
+int connectTo(const LoadOptions& options) {
+    int fd;
+    if (options.port > 0) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    } else {
+        sockaddr_un address{};
+        if (options.socketPath.size() >= sizeof(address.sun_path)) return -1;
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * Drives all clients from one epoll loop and collects the measurements.
+ */
+class Generator {
+private:
+    const LoadOptions& options;
+    int epollFd = -1;
+    std::vector<Client> clients;
+    std::mt19937 rng;
+    // Clients waiting out their think time: (due time, client index).
+    std::priority_queue<std::pair<Clock::time_point, size_t>,
+                        std::vector<std::pair<Clock::time_point, size_t>>,
+                        std::greater<std::pair<Clock::time_point, size_t>>> sleeping;
+
+    bool measuring = false;
+    uint64_t moves = 0;
+    uint64_t engineMoves = 0;
+    uint64_t gamesFinished = 0;
+    uint64_t errors = 0;
+    uint64_t disconnects = 0;
+    LatencyStats latency;
+
+    /**
+     * Sends queued output and watches for writability while some is left.
+     */
+    void flush(Client& client) {
+        if (client.fd < 0) return;
+        size_t sent = 0;
+        while (sent < client.output.size()) {
+            ssize_t count = send(client.fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+            if (count < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) disconnect(client);
+                break;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        if (client.fd < 0) return;
+        client.output.erase(0, sent);
+        bool pending = !client.output.empty();
+        if (pending != client.watchingOutput) {
+            epoll_event event{};
+            event.events = EPOLLIN | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            event.data.u64 = static_cast<uint64_t>(&client - clients.data());
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+            client.watchingOutput = pending;
+        }
+    }
+
+    /**
+     * Closes a client whose connection failed.
+     */
+    void disconnect(Client& client) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+        close(client.fd);
+        client.fd = -1;
+        disconnects++;
+    }
+
+    /**
+     * Starts a new game on a client.
+     */
+    void newGame(Client& client) {
+        int halfmoves = 0;
+        int fullmoves = 1;
+        client.board.loadFen(Game::START_FEN, client.side, halfmoves, fullmoves);
+        client.plies = 0;
+        client.sentMove.reset();
+        client.output += options.engine ? "new white\n" : "new\n";
+    }
+
+    /**
+     * Lets a client move now, or after its think time.
+     */
+    void scheduleMove(size_t index) {
+        if (options.thinkMs > 0) {
+            sleeping.push({Clock::now() + std::chrono::milliseconds(options.thinkMs), index});
+        } else {
+            sendMove(clients[index]);
+        }
+    }
+
+    /**
+     * Sends a random legal move, or starts over when the game is too long.
+     */
+    void sendMove(Client& client) {
+        std::vector<Move> legal = Search::generateLegalMoves(client.board, client.side);
+        if (legal.empty() || client.plies >= options.maxPlies) {
+            newGame(client);
+        } else {
+            client.sentMove = legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(rng)];
+            client.output += "move " + client.sentMove->toString() + "\n";
+            client.sentAt = Clock::now();
+        }
+        flush(client);
+    }
+
+    /**
+     * Plays a move on the local board.
+     */
+    void apply(Client& client, const Move& move) {
+        client.board.applyMove(move);
+        client.side = opponent(client.side);
+        client.plies++;
+    }
+
+    /**
+     * Reacts to one line from the server.
+     */
+    void handleLine(size_t index, std::string_view line) {
+        Client& client = clients[index];
+        size_t split = line.find(' ');
+        std::string_view word = line.substr(0, split);
+        std::string_view state = line.substr(line.rfind(' ') + 1);
+
+        if (word == "ok" && line == "ok new") {
+            if (!options.engine || client.side == Color::WHITE) scheduleMove(index);
+        } else if (word == "ok" && client.sentMove.has_value()) {
+            if (measuring) {
+                latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - client.sentAt).count());
+                moves++;
+            }
+            apply(client, client.sentMove.value());
+            client.sentMove.reset();
+            if (!isPlayable(state)) {
+                if (measuring) gamesFinished++;
+                newGame(client);
+                flush(client);
+            } else if (!options.engine) {
+                scheduleMove(index);
+            }
+        } else if (word == "engine") {
+            std::string_view text = line.substr(split + 1, line.rfind(' ') - split - 1);
+            std::vector<Move> legal = Search::generateLegalMoves(client.board, client.side);
+            auto match = std::find_if(legal.begin(), legal.end(),
+                                      [text](const Move& move) { return move.toString() == text; });
+            if (match == legal.end()) {
+                errors++;
+                newGame(client);
+                flush(client);
+                return;
+            }
+            if (measuring) engineMoves++;
+            apply(client, *match);
+            if (isPlayable(state)) {
+                scheduleMove(index);
+            } else {
+                if (measuring) gamesFinished++;
+                newGame(client);
+                flush(client);
+            }
+        } else {
+            // "illegal" or "error": the boards disagree, so start over.
+            errors++;
+            newGame(client);
+            flush(client);
+        }
+    }
+
+    /**
+     * Reads from a client and handles its complete lines.
+     */
+    void readFrom(size_t index) {
+        Client& client = clients[index];
+        char buffer[4096];
+        ssize_t count = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            disconnect(client);
+            return;
+        }
+        if (count < 0) return;
+        client.input.append(buffer, static_cast<size_t>(count));
+        size_t start = 0;
+        size_t newline;
+        while (client.fd >= 0 && (newline = client.input.find('\n', start)) != std::string::npos) {
+            std::string line = client.input.substr(start, newline - start);
+            start = newline + 1;
+            handleLine(index, line);
+        }
+        client.input.erase(0, start);
+    }
+
+    /**
+     * Waits for and handles events until a time.
+     */
+    void runUntil(Clock::time_point end) {
+        epoll_event events[MAX_EVENTS];
+        while (true) {
+            Clock::time_point now = Clock::now();
+            while (!sleeping.empty() && sleeping.top().first <= now) {
+                size_t index = sleeping.top().second;
+                sleeping.pop();
+                if (clients[index].fd >= 0) sendMove(clients[index]);
+            }
+            if (now >= end) return;
+
+            Clock::time_point wake = end;
+            if (!sleeping.empty()) wake = std::min(wake, sleeping.top().first);
+            auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(wake - now).count();
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, static_cast<int>(std::max<int64_t>(timeout, 0)));
+            for (int i = 0; i < count; i++) {
+                size_t index = static_cast<size_t>(events[i].data.u64);
+                if (clients[index].fd < 0) continue;
+                if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) readFrom(index);
+                if (clients[index].fd >= 0 && (events[i].events & EPOLLOUT)) flush(clients[index]);
+            }
+        }
+    }
+
+public:
+    /**
+     * Creates the generator (nothing is connected yet).
+     */
+    explicit Generator(const LoadOptions& options) : options(options), rng(options.seed) {}
+
+    /**
+     * Closes all connections.
+     */
+    ~Generator() {
+        for (Client& client : clients) {
+            if (client.fd >= 0) close(client.fd);
+        }
+        if (epollFd >= 0) close(epollFd);
+    }
+
+    /**
+     * Connects, plays and prints the report.
+     */
+    int run() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) return 1;
+
+        // Clients are never added after this, so their addresses stay put.
+        clients.resize(static_cast<size_t>(std::max(1, options.games)));
+        auto connectStart = Clock::now();
+        for (size_t i = 0; i < clients.size(); i++) {
+            int fd = connectTo(options);
+            if (fd < 0) {
+                std::cerr << "Connection " << i + 1 << " failed: " << std::strerror(errno) << std::endl;
+                return 1;
+            }
+            clients[i].fd = fd;
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        }
+        double connectSeconds = std::chrono::duration<double>(Clock::now() - connectStart).count();
+        std::cout << "Connected " << clients.size() << " games in " << connectSeconds << " s" << std::endl;
+
+        for (Client& client : clients) {
+            newGame(client);
+            flush(client);
+        }
+        // A short warm-up so the games are spread out before measuring.
+        runUntil(Clock::now() + std::chrono::seconds(1));
+        measuring = true;
+        auto start = Clock::now();
+        runUntil(start + std::chrono::seconds(std::max(1, options.seconds)));
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "Games: " << clients.size() << " concurrent, " << gamesFinished << " finished, "
+                  << disconnects << " disconnected, " << errors << " errors" << std::endl;
+        std::cout << "Moves: " << moves << " in " << seconds << " s (" << static_cast<uint64_t>(moves / seconds)
+                  << " moves/s)";
+        if (options.engine) std::cout << ", engine replies: " << engineMoves;
+        std::cout << std::endl;
+        std::cout << "Move validation round trip: p50 " << latency.percentileUs(50) << " us, p99 "
+                  << latency.percentileUs(99) << " us, max " << latency.percentileUs(100) << " us" << std::endl;
+        return disconnects == 0 ? 0 : 1;
+    }
+};
+
+} // namespace
+#endif
+
+/**
+ * Connects the clients, plays for the configured time and prints the report.
+ */
+int LoadGenerator::run(const LoadOptions& options) {
+#ifdef __linux__
+    Generator generator(options);
+    return generator.run();
+#else
+    (void)options;
+    std::cerr << "chess loadgen needs Linux (epoll)" << std::endl;
+    return 2;
+#endif
+}
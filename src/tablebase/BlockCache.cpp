@@ -0,0 +1,106 @@
+#include "tablebase/BlockCache.h"
+#include <algorithm>
+
+/**
+ * Creates a cache holding up to the given number of blocks.
+ */
+BlockCache::BlockCache(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+/**
+ * Looks up a block and marks it as recently used.
+ */
+BlockCache::Block BlockCache::get(uint64_t key) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    order.splice(order.begin(), order, it->second);
+    return it->second->second;
+}
+
+/**
+ * Inserts a block, evicting the least recently used ones if full.
+ */
+void BlockCache::put(uint64_t key, Block block) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        // Another thread decompressed the same block first.
+        order.splice(order.begin(), order, it->second);
+        return;
+    }
+
+    order.emplace_front(key, std::move(block));
+    entries[key] = order.begin();
+    while (entries.size() > capacity) {
+        entries.erase(order.back().first);
+        order.pop_back();
+    }
+}
+
+/**
+ * Changes the capacity, evicting blocks if needed.
+ */
+void BlockCache::setCapacity(size_t blocks) {
+    std::lock_guard<std::mutex> guard(lock);
+    capacity = std::max<size_t>(1, blocks);
+    while (entries.size() > capacity) {
+        entries.erase(order.back().first);
+        order.pop_back();
+    }
+}
+
+/**
+ * Drops every block and resets the statistics.
+ */
+void BlockCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    order.clear();
+    entries.clear();
+    hits = 0;
+    misses = 0;
+}
+
+/**
+ * Resets the hit and miss counters, keeping the blocks.
+ */
+void BlockCache::resetStats() {
+    std::lock_guard<std::mutex> guard(lock);
+    hits = 0;
+    misses = 0;
+}
+
+/**
+ * Gets the number of cached blocks.
+ */
+size_t BlockCache::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+}
+
+/**
+ * Gets the maximum number of cached blocks.
+ */
+size_t BlockCache::getCapacity() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return capacity;
+}
+
+/**
+ * Gets the number of lookups that found their block.
+ */
+uint64_t BlockCache::getHits() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return hits;
+}
+
+/**
+ * Gets the number of lookups that missed.
+ */
+uint64_t BlockCache::getMisses() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return misses;
+}
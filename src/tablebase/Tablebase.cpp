@@ -0,0 +1,359 @@
+#include "tablebase/Tablebase.h"
+#include "engine/Search.h"
+#include "pieces/Piece.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+std::map<std::string, std::unique_ptr<Tablebase::Table>> Tablebase::tables;
+int Tablebase::largestTable = 0;
+BlockCache Tablebase::cache;
+std::atomic<uint64_t> Tablebase::probes{0};
+std::atomic<uint64_t> Tablebase::decompressionNs{0};
+std::atomic<int> Tablebase::tablesMapped{0};
+
+const uint8_t Tablebase::DRAW;
+const uint8_t Tablebase::ILLEGAL;
+const uint32_t Tablebase::VERSION;
+const size_t Tablebase::HEADER_SIZE;
+const uint32_t Tablebase::BLOCK_SIZE;
+
+/**
+ * Registers every "*.cctb" file in a directory, reading only the headers.
+ */
+int Tablebase::init(const std::string& directory) {
+    clear();
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) return 0;
+
+    int nextId = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".cctb") continue;
+        std::string material = entry.path().stem().string();
+        if (!TablebaseIndex::isValidMaterial(material)) continue;
+
+        std::ifstream in(entry.path(), std::ios::binary);
+        char header[HEADER_SIZE + 8] = {};
+        if (!in.read(header, HEADER_SIZE)) continue;
+
+        auto table = std::make_unique<Table>(material);
+        uint64_t entries;
+        char name[9] = {};
+        std::memcpy(&table->version, header + 4, 4);
+        std::memcpy(name, header + 8, 8);
+        std::memcpy(&entries, header + 16, 8);
+        if (std::memcmp(header, "CCTB", 4) != 0 || material != name || entries != table->index.size()) continue;
+
+        uint64_t fileSize = std::filesystem::file_size(entry.path(), error);
+        if (error) continue;
+        if (table->version == 1) {
+            if (fileSize != HEADER_SIZE + entries) continue;
+        } else if (table->version == VERSION) {
+            if (!in.read(header + HEADER_SIZE, 8)) continue;
+            std::memcpy(&table->blockSize, header + HEADER_SIZE, 4);
+            std::memcpy(&table->blockCount, header + HEADER_SIZE + 4, 4);
+            if (table->blockSize == 0 ||
+                table->blockCount != (entries + table->blockSize - 1) / table->blockSize) {
+                continue;
+            }
+        } else {
+            continue;
+        }
+
+        table->path = entry.path().string();
+        table->id = nextId++;
+        largestTable = std::max(largestTable, table->index.pieceCount());
+        tables[material] = std::move(table);
+    }
+    return static_cast<int>(tables.size());
+}
+
+/**
+ * Unmaps all tables and empties the block cache.
+ */
+void Tablebase::clear() {
+    tables.clear();
+    largestTable = 0;
+    cache.clear();
+    resetStats();
+    tablesMapped = 0;
+}
+
+/**
+ * Sets how many decompressed blocks the shared cache may hold.
+ */
+void Tablebase::setCacheSize(size_t blocks) {
+    cache.setCapacity(blocks);
+}
+
+/**
+ * Gets probe and cache counters.
+ */
+TablebaseStats Tablebase::getStats() {
+    TablebaseStats stats;
+    stats.probes = probes.load(std::memory_order_relaxed);
+    stats.cacheHits = cache.getHits();
+    stats.cacheMisses = cache.getMisses();
+    stats.decompressionNs = decompressionNs.load(std::memory_order_relaxed);
+    stats.tablesMapped = tablesMapped.load(std::memory_order_relaxed);
+    stats.cachedBlocks = cache.size();
+    return stats;
+}
+
+/**
+ * Resets the probe and cache counters (cached blocks are kept).
+ */
+void Tablebase::resetStats() {
+    probes = 0;
+    decompressionNs = 0;
+    cache.resetStats();
+}
+
+/**
+ * Encodes one block as a sequence of tokens: a byte t < 0x80 is followed by
+ * t + 1 literal values, a byte t >= 0x80 by one value repeated (t & 0x7F) + 3 times.
+ */
+std::vector<uint8_t> Tablebase::compressBlock(const uint8_t* values, size_t count) {
+    const size_t minRun = 3, maxRun = 0x7F + minRun, maxLiteral = 0x80;
+    std::vector<uint8_t> out;
+    size_t literalStart = 0;
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            size_t length = std::min(maxLiteral, end - literalStart);
+            out.push_back(static_cast<uint8_t>(length - 1));
+            out.insert(out.end(), values + literalStart, values + literalStart + length);
+            literalStart += length;
+        }
+    };
+
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && run < maxRun && values[i + run] == values[i]) run++;
+        if (run >= minRun) {
+            flushLiterals(i);
+            out.push_back(static_cast<uint8_t>(0x80 | (run - minRun)));
+            out.push_back(values[i]);
+            i += run;
+            literalStart = i;
+        } else {
+            i += run;
+        }
+    }
+    flushLiterals(count);
+    return out;
+}
+
+/**
+ * Decodes a block written by compressBlock().
+ */
+bool Tablebase::decompressBlock(const char* data, size_t length, size_t count, std::vector<uint8_t>& out) {
+    out.resize(count);
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+    size_t pos = 0, filled = 0;
+    while (pos < length) {
+        uint8_t token = in[pos++];
+        if (token & 0x80) {
+            size_t run = (token & 0x7F) + 3;
+            if (pos >= length || run > count - filled) return false;
+            std::memset(out.data() + filled, in[pos++], run);
+            filled += run;
+        } else {
+            size_t literal = token + 1u;
+            if (literal > length - pos || literal > count - filled) return false;
+            std::memcpy(out.data() + filled, in + pos, literal);
+            pos += literal;
+            filled += literal;
+        }
+    }
+    return filled == count;
+}
+
+/**
+ * Gets the material names of the registered tables.
+ */
+std::vector<std::string> Tablebase::getMaterials() {
+    std::vector<std::string> materials;
+    for (const auto& entry : tables) materials.push_back(entry.first);
+    return materials;
+}
+
+/**
+ * Gets the largest number of men covered by a loaded table.
+ */
+int Tablebase::maxPieces() {
+    return largestTable;
+}
+
+/**
+ * Maps a table's file on first use (double-checked so probes stay lock-free).
+ */
+bool Tablebase::ensureMapped(Table& table) {
+    if (table.mapped.load(std::memory_order_acquire)) return true;
+
+    std::lock_guard<std::mutex> guard(table.openLock);
+    if (table.mapped.load(std::memory_order_relaxed)) return true;
+    if (!table.file.open(table.path)) return false;
+
+    if (table.version == VERSION) {
+        // The offsets must cover the data exactly.
+        size_t tableStart = HEADER_SIZE + 8;
+        size_t dataStart = tableStart + (static_cast<size_t>(table.blockCount) + 1) * 8;
+        uint64_t dataSize = 0;
+        if (table.file.size() >= dataStart) {
+            std::memcpy(&dataSize, table.file.data() + tableStart + table.blockCount * 8ull, 8);
+        }
+        if (table.file.size() < dataStart || dataStart + dataSize != table.file.size()) {
+            table.file.close();
+            return false;
+        }
+    }
+
+    tablesMapped++;
+    table.mapped.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Reads one value, decompressing its block on a cache miss.
+ */
+std::optional<uint8_t> Tablebase::readValue(Table& table, uint64_t index) {
+    probes.fetch_add(1, std::memory_order_relaxed);
+    if (!ensureMapped(table)) return std::nullopt;
+    const char* data = table.file.data();
+    if (table.version == 1) return static_cast<uint8_t>(data[HEADER_SIZE + index]);
+
+    uint32_t block = static_cast<uint32_t>(index / table.blockSize);
+    uint64_t key = (static_cast<uint64_t>(table.id) << 32) | block;
+    BlockCache::Block values = cache.get(key);
+    if (!values) {
+        auto started = std::chrono::steady_clock::now();
+
+        size_t tableStart = HEADER_SIZE + 8;
+        size_t dataStart = tableStart + (static_cast<size_t>(table.blockCount) + 1) * 8;
+        uint64_t begin, end;
+        std::memcpy(&begin, data + tableStart + block * 8ull, 8);
+        std::memcpy(&end, data + tableStart + (block + 1) * 8ull, 8);
+        uint64_t count = std::min<uint64_t>(table.blockSize, table.index.size() - block * static_cast<uint64_t>(table.blockSize));
+
+        auto decoded = std::make_shared<std::vector<uint8_t>>();
+        if (end < begin || dataStart + end > table.file.size() ||
+            !decompressBlock(data + dataStart + begin, end - begin, count, *decoded)) {
+            return std::nullopt;
+        }
+        values = decoded;
+        cache.put(key, values);
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        decompressionNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                  std::memory_order_relaxed);
+    }
+    return (*values)[index % table.blockSize];
+}
+
+/**
+ * Looks up a raw table value.
+ */
+std::optional<uint8_t> Tablebase::probeRaw(const std::string& material, const int* squares, bool strongToMove) {
+    auto it = tables.find(material);
+    if (it == tables.end()) return std::nullopt;
+    Table& table = *it->second;
+    return readValue(table, table.index.index(squares, strongToMove));
+}
+
+/**
+ * Looks up a position.
+ */
+std::optional<TablebaseResult> Tablebase::probe(const Board& board, Color sideToMove) {
+    const std::vector<Piece*>& white = board.getPieces(Color::WHITE);
+    const std::vector<Piece*>& black = board.getPieces(Color::BLACK);
+    size_t total = white.size() + black.size();
+    if (total == 2) return TablebaseResult();  // bare kings
+    if (total > static_cast<size_t>(largestTable) || (white.size() > 1 && black.size() > 1)) {
+        return std::nullopt;
+    }
+    // Tables assume no castling (possible only with an unmoved king and rook).
+    if (board.getCastlingRights() != 0) return std::nullopt;
+
+    Color strong = white.size() > 1 ? Color::WHITE : Color::BLACK;
+    const std::vector<Piece*>& strongPieces = strong == Color::WHITE ? white : black;
+    const std::vector<Piece*>& weakPieces = strong == Color::WHITE ? black : white;
+
+    // The strong side always plays up the board in the tables.
+    auto squareOf = [strong](const Piece* piece) {
+        int square = piece->getRank() * 8 + piece->getFile();
+        return strong == Color::WHITE ? square : square ^ 56;
+    };
+
+    std::vector<const Piece*> others;
+    int squares[TablebaseIndex::MAX_PIECES];
+    for (const Piece* piece : strongPieces) {
+        if (piece->getType() == PieceType::KING) {
+            squares[0] = squareOf(piece);
+        } else {
+            others.push_back(piece);
+        }
+    }
+    squares[1] = squareOf(weakPieces.front());
+    std::stable_sort(others.begin(), others.end(), [](const Piece* a, const Piece* b) {
+        return a->getType() < b->getType();
+    });
+
+    std::vector<PieceType> types;
+    for (size_t i = 0; i < others.size(); i++) {
+        squares[i + 2] = squareOf(others[i]);
+        types.push_back(others[i]->getType());
+    }
+
+    // A lone minor piece cannot mate: no table needed.
+    if (types.size() == 1 && (types[0] == PieceType::BISHOP || types[0] == PieceType::KNIGHT)) {
+        return TablebaseResult();
+    }
+
+    bool strongToMove = sideToMove == strong;
+    std::optional<uint8_t> value = probeRaw(TablebaseIndex::materialName(types), squares, strongToMove);
+    if (!value.has_value() || value.value() == ILLEGAL) return std::nullopt;
+
+    TablebaseResult result;
+    if (value.value() == DRAW) return result;
+    result.wdl = strongToMove ? Wdl::WIN : Wdl::LOSS;
+    result.pliesToMate = value.value() - 1;
+    return result;
+}
+
+/**
+ * Picks the move that keeps the best tablebase value.
+ */
+std::optional<Move> Tablebase::bestMove(const Board& board, Color sideToMove) {
+    if (!probe(board, sideToMove).has_value()) return std::nullopt;
+
+    Color opponent = sideToMove == Color::WHITE ? Color::BLACK : Color::WHITE;
+    std::optional<Move> best;
+    int bestRank = 0;
+
+    for (const Move& move : Search::generateLegalMoves(board, sideToMove)) {
+        Board child = board;
+        child.applyMove(move);
+
+        std::optional<TablebaseResult> reply = probe(child, opponent);
+        int rank;
+        if (!reply.has_value()) {
+            continue;  // material without a table (e.g. underpromotion)
+        } else if (reply->wdl == Wdl::LOSS) {
+            rank = 1000 - reply->pliesToMate;      // our win: fastest mate first
+        } else if (reply->wdl == Wdl::DRAW) {
+            rank = 0;
+        } else {
+            rank = -1000 + reply->pliesToMate;     // our loss: longest defence first
+        }
+
+        if (!best.has_value() || rank > bestRank) {
+            best = move;
+            bestRank = rank;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,613 @@
+#include "tablebase/TablebaseGenerator.h"
+#include "tablebase/Tablebase.h"
+#include "tablebase/TablebaseIndex.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace {
+
+const int ROOK_DIRECTIONS[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+const int BISHOP_DIRECTIONS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+const uint64_t BLOCK = 1 << 14;
+
+typedef std::atomic<uint8_t> Value;
+
+uint64_t bit(int square) {
+    return 1ULL << square;
+}
+
+/**
+ * Precomputed step attacks and the squares between aligned squares.
+ */
+struct Geometry {
+    uint64_t king[64] = {};
+    uint64_t knight[64] = {};
+    uint64_t between[64][64] = {};
+    bool orthogonal[64][64] = {};
+    bool diagonal[64][64] = {};
+
+    Geometry() {
+        const int kingSteps[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+        const int knightSteps[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+
+        for (int square = 0; square < 64; square++) {
+            int file = square & 7, rank = square >> 3;
+            for (int i = 0; i < 8; i++) {
+                int f = file + kingSteps[i][0], r = rank + kingSteps[i][1];
+                if (f >= 0 && f < 8 && r >= 0 && r < 8) king[square] |= bit(r * 8 + f);
+                f = file + knightSteps[i][0];
+                r = rank + knightSteps[i][1];
+                if (f >= 0 && f < 8 && r >= 0 && r < 8) knight[square] |= bit(r * 8 + f);
+            }
+            for (int i = 0; i < 8; i++) {
+                int df = kingSteps[i][0], dr = kingSteps[i][1];
+                uint64_t path = 0;
+                for (int f = file + df, r = rank + dr; f >= 0 && f < 8 && r >= 0 && r < 8; f += df, r += dr) {
+                    int target = r * 8 + f;
+                    between[square][target] = path;
+                    (df == 0 || dr == 0 ? orthogonal : diagonal)[square][target] = true;
+                    path |= bit(target);
+                }
+            }
+        }
+    }
+};
+
+const Geometry& geometry() {
+    static const Geometry instance;
+    return instance;
+}
+
+/**
+ * One table under construction. Squares follow TablebaseIndex order; type[1]
+ * is the bare king.
+ */
+struct Builder {
+    const TablebaseIndex& index;
+    Value* values;
+    int count;
+    PieceType type[TablebaseIndex::MAX_PIECES];
+    std::string captureTable[TablebaseIndex::MAX_PIECES];  // material left after taking a piece ("" = draw)
+
+    Builder(const TablebaseIndex& index, Value* values) : index(index), values(values) {
+        count = index.pieceCount();
+        type[0] = PieceType::KING;
+        type[1] = PieceType::KING;
+        for (int i = 2; i < count; i++) type[i] = index.getPieces()[i - 2];
+        for (int i = 2; i < count; i++) {
+            std::vector<PieceType> rest = index.getPieces();
+            rest.erase(rest.begin() + (i - 2));
+            if (canWin(rest)) captureTable[i] = TablebaseIndex::materialName(rest);
+        }
+    }
+
+    /**
+     * Checks whether pieces against a bare king can still win: not bare
+     * kings and not a lone bishop or knight.
+     */
+    static bool canWin(const std::vector<PieceType>& pieces) {
+        return !pieces.empty() && !(pieces.size() == 1 && (pieces[0] == PieceType::BISHOP ||
+                                                           pieces[0] == PieceType::KNIGHT));
+    }
+
+    uint8_t valueAt(const int* squares, bool strongToMove) const {
+        return values[index.index(squares, strongToMove)].load(std::memory_order_relaxed);
+    }
+
+    bool claim(const int* squares, bool strongToMove, uint8_t value) const {
+        uint8_t expected = Tablebase::DRAW;
+        return values[index.index(squares, strongToMove)].compare_exchange_strong(
+            expected, value, std::memory_order_relaxed);
+    }
+
+    uint64_t occupancy(const int* squares) const {
+        uint64_t occupied = 0;
+        for (int i = 0; i < count; i++) occupied |= bit(squares[i]);
+        return occupied;
+    }
+
+    /**
+     * Checks whether a strong piece attacks a square.
+     */
+    bool attacks(int piece, const int* squares, int target, uint64_t occupied) const {
+        const Geometry& g = geometry();
+        int from = squares[piece];
+        switch (type[piece]) {
+            case PieceType::KING:   return (g.king[from] & bit(target)) != 0;
+            case PieceType::KNIGHT: return (g.knight[from] & bit(target)) != 0;
+            case PieceType::PAWN:
+                return ((from & 7) > 0 && target == from + 7) || ((from & 7) < 7 && target == from + 9);
+            case PieceType::ROOK:
+                return g.orthogonal[from][target] && !(g.between[from][target] & occupied);
+            case PieceType::BISHOP:
+                return g.diagonal[from][target] && !(g.between[from][target] & occupied);
+            case PieceType::QUEEN:
+                return (g.orthogonal[from][target] || g.diagonal[from][target]) &&
+                       !(g.between[from][target] & occupied);
+        }
+        return false;
+    }
+
+    /**
+     * Checks whether the strong side attacks a square, ignoring one piece.
+     */
+    bool attacked(const int* squares, int target, uint64_t occupied, int ignore) const {
+        for (int i = 0; i < count; i++) {
+            if (i == 1 || i == ignore) continue;
+            if (attacks(i, squares, target, occupied)) return true;
+        }
+        return false;
+    }
+
+    int pieceOn(const int* squares, int square) const {
+        for (int i = 0; i < count; i++) {
+            if (squares[i] == square) return i;
+        }
+        return -1;
+    }
+
+    /**
+     * Checks the basic legality of a position (ignoring whose move it is).
+     */
+    bool isLegal(const int* squares, bool strongToMove) const {
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                if (squares[i] == squares[j]) return false;
+            }
+            if (type[i] == PieceType::PAWN && (squares[i] < 8 || squares[i] >= 56)) return false;
+        }
+        if (geometry().king[squares[0]] & bit(squares[1])) return false;
+        // The side that just moved cannot have left the bare king in check.
+        return !(strongToMove && attacked(squares, squares[1], occupancy(squares), -1));
+    }
+
+    /**
+     * Looks up the position after the bare king takes a piece in the smaller
+     * table, strong side to move. The capture must be legal.
+     */
+    uint8_t captureValue(const int* squares, int captured) const {
+        if (captureTable[captured].empty()) return Tablebase::DRAW;
+        int next[TablebaseIndex::MAX_PIECES];
+        int used = 0;
+        next[used++] = squares[0];
+        next[used++] = squares[captured];
+        for (int i = 2; i < count; i++) {
+            if (i != captured) next[used++] = squares[i];
+        }
+        std::optional<uint8_t> value = Tablebase::probeRaw(captureTable[captured], next, true);
+        return value.has_value() && value.value() != Tablebase::ILLEGAL ? value.value() : Tablebase::DRAW;
+    }
+
+    /**
+     * Gets the longest win the bare king runs into by capturing, or DRAW if
+     * it has no legal capture or one of them reaches a drawn ending.
+     */
+    uint8_t longestCapture(const int* squares) const {
+        uint64_t occupied = occupancy(squares) & ~bit(squares[1]);
+        uint64_t targets = geometry().king[squares[1]];
+        uint8_t longest = Tablebase::DRAW;
+        while (targets) {
+            int target = __builtin_ctzll(targets);
+            targets &= targets - 1;
+
+            int captured = pieceOn(squares, target);
+            if (captured < 2 || attacked(squares, target, occupied & ~bit(target), captured)) continue;
+            uint8_t value = captureValue(squares, captured);
+            if (value == Tablebase::DRAW) return Tablebase::DRAW;
+            longest = std::max(longest, value);
+        }
+        return longest;
+    }
+
+    /**
+     * Examines the bare king's moves. Reports whether it has any legal move
+     * and whether every move runs into a win for the strong side decided in
+     * at most limit (value) plies. Captures are looked up in the smaller table.
+     */
+    void weakMoves(const int* squares, uint8_t limit, bool& anyMove, bool& allLose) const {
+        anyMove = false;
+        allLose = true;
+        uint64_t occupied = occupancy(squares) & ~bit(squares[1]);
+        uint64_t targets = geometry().king[squares[1]];
+
+        int next[TablebaseIndex::MAX_PIECES];
+        std::copy(squares, squares + count, next);
+
+        while (targets) {
+            int target = __builtin_ctzll(targets);
+            targets &= targets - 1;
+
+            int captured = pieceOn(squares, target);
+            if (captured == 0) continue;
+            uint8_t value;
+            if (captured > 0) {
+                if (attacked(squares, target, occupied & ~bit(target), captured)) continue;
+                value = captureValue(squares, captured);
+            } else {
+                if (attacked(squares, target, occupied, -1)) continue;
+                next[1] = target;
+                value = valueAt(next, true);
+            }
+
+            anyMove = true;
+            // ILLEGAL is above any limit.
+            if (value == Tablebase::DRAW || value > limit) {
+                allLose = false;
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * Runs a function over [0, count) on several threads, handing out blocks.
+ */
+template <typename Function>
+void parallelFor(uint64_t count, int threads, Function function) {
+    std::atomic<uint64_t> next{0};
+    auto worker = [&]() {
+        while (true) {
+            uint64_t begin = next.fetch_add(BLOCK);
+            if (begin >= count) return;
+            uint64_t end = std::min(count, begin + BLOCK);
+            for (uint64_t i = begin; i < end; i++) function(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker);
+    worker();
+    for (std::thread& thread : workers) thread.join();
+}
+
+/**
+ * Finds the fastest win by promoting the pawn on the 7th rank, using the
+ * already generated tables. Returns the stored value or DRAW.
+ */
+uint8_t promotionValue(const Builder& builder, const int* squares) {
+    uint8_t best = Tablebase::DRAW;
+    for (int i = 2; i < builder.count; i++) {
+        if (builder.type[i] != PieceType::PAWN || (squares[i] >> 3) != 6) continue;
+        int target = squares[i] + 8;
+        if (builder.pieceOn(squares, target) >= 0) continue;
+
+        for (PieceType promotion : { PieceType::QUEEN, PieceType::ROOK }) {
+            std::vector<std::pair<PieceType, int>> pieces;
+            for (int j = 2; j < builder.count; j++) {
+                pieces.emplace_back(j == i ? promotion : builder.type[j], j == i ? target : squares[j]);
+            }
+            std::stable_sort(pieces.begin(), pieces.end(),
+                             [](const std::pair<PieceType, int>& a, const std::pair<PieceType, int>& b) {
+                                 return a.first < b.first;
+                             });
+
+            int promoted[TablebaseIndex::MAX_PIECES] = { squares[0], squares[1] };
+            std::vector<PieceType> types;
+            for (size_t j = 0; j < pieces.size(); j++) {
+                promoted[j + 2] = pieces[j].second;
+                types.push_back(pieces[j].first);
+            }
+
+            std::optional<uint8_t> value =
+                Tablebase::probeRaw(TablebaseIndex::materialName(types), promoted, false);
+            if (!value.has_value() || value.value() == Tablebase::DRAW || value.value() == Tablebase::ILLEGAL) {
+                continue;
+            }
+            // Bare king lost in (value - 1) plies, so the promotion wins in value plies.
+            uint8_t win = static_cast<uint8_t>(value.value() + 1);
+            if (best == Tablebase::DRAW || win < best) best = win;
+        }
+    }
+    return best;
+}
+
+/**
+ * Lists the materials a table needs: the endings left after the bare king
+ * takes a piece, and those its pawns promote into.
+ */
+std::vector<std::string> requiredMaterials(const std::string& material) {
+    std::vector<std::string> needed;
+    auto add = [&needed](const std::vector<PieceType>& pieces) {
+        if (!Builder::canWin(pieces)) return;
+        std::string name = TablebaseIndex::materialName(pieces);
+        if (std::find(needed.begin(), needed.end(), name) == needed.end()) needed.push_back(name);
+    };
+
+    TablebaseIndex index(material);
+    for (size_t i = 0; i < index.getPieces().size(); i++) {
+        std::vector<PieceType> pieces = index.getPieces();
+        pieces.erase(pieces.begin() + i);
+        add(pieces);
+        if (index.getPieces()[i] != PieceType::PAWN) continue;
+        for (PieceType promotion : { PieceType::QUEEN, PieceType::ROOK }) {
+            pieces = index.getPieces();
+            pieces[i] = promotion;
+            add(pieces);
+        }
+    }
+    return needed;
+}
+
+/**
+ * Orders materials so every table comes after the ones it needs: fewer
+ * men first, then fewer pawns.
+ */
+bool buildsBefore(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return a.size() < b.size();
+    return std::count(a.begin(), a.end(), 'P') < std::count(b.begin(), b.end(), 'P');
+}
+
+} // namespace
+
+/**
+ * Generates one table and writes it to the directory.
+ */
+bool TablebaseGenerator::generate(const std::string& material, const std::string& directory, int threads) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    TablebaseIndex index(material);
+    uint64_t size = index.size();
+    std::unique_ptr<Value[]> values(new Value[size]);
+    Builder builder(index, values.get());
+    threads = std::max(1, threads);
+
+    for (const std::string& needed : requiredMaterials(material)) {
+        int squares[TablebaseIndex::MAX_PIECES] = {};
+        if (!Tablebase::probeRaw(needed, squares, true).has_value()) {
+            std::cerr << material << " needs " << needed << ".cctb to be generated first" << std::endl;
+            return false;
+        }
+    }
+
+    // Pass 0: illegal positions, mates, promotion wins and bare king
+    // positions whose longest defence may be a capture.
+    std::mutex promotionsLock;
+    std::vector<std::pair<uint8_t, uint64_t>> promotions;
+    std::vector<std::pair<uint8_t, uint64_t>> captures;
+
+    parallelFor(size, threads, [&](uint64_t i) {
+        int squares[TablebaseIndex::MAX_PIECES];
+        bool strongToMove;
+        index.decode(i, squares, strongToMove);
+
+        uint8_t value = Tablebase::DRAW;
+        // Symmetric duplicates of another entry are never probed.
+        if (!builder.isLegal(squares, strongToMove) || index.index(squares, strongToMove) != i) {
+            value = Tablebase::ILLEGAL;
+        } else if (!strongToMove) {
+            bool anyMove, allLose;
+            builder.weakMoves(squares, Tablebase::DRAW, anyMove, allLose);
+            bool inCheck = builder.attacked(squares, squares[1], builder.occupancy(squares), -1);
+            if (!anyMove && inCheck) value = 1;  // mated: lost in 0 plies
+            uint8_t capture = anyMove ? builder.longestCapture(squares) : Tablebase::DRAW;
+            if (capture != Tablebase::DRAW) {
+                std::lock_guard<std::mutex> guard(promotionsLock);
+                captures.emplace_back(capture, i);
+            }
+        } else if (index.hasPawns()) {
+            uint8_t promotion = promotionValue(builder, squares);
+            if (promotion != Tablebase::DRAW) {
+                std::lock_guard<std::mutex> guard(promotionsLock);
+                promotions.emplace_back(promotion, i);
+            }
+        }
+        values[i].store(value, std::memory_order_relaxed);
+    });
+    std::sort(promotions.begin(), promotions.end());
+    std::sort(captures.begin(), captures.end());
+
+    // Pass p handles the positions decided in exactly p plies.
+    size_t nextPromotion = 0;
+    size_t nextCapture = 0;
+    int maxPlies = 0;
+    for (int plies = 0; plies + 2 < Tablebase::ILLEGAL; plies++) {
+        uint8_t frontier = static_cast<uint8_t>(plies + 1);
+        uint8_t decided = static_cast<uint8_t>(plies + 2);
+        std::atomic<bool> progress{false};
+
+        parallelFor(size, threads, [&](uint64_t i) {
+            if (values[i].load(std::memory_order_relaxed) != frontier) return;
+            progress.store(true, std::memory_order_relaxed);
+
+            int squares[TablebaseIndex::MAX_PIECES];
+            bool strongToMove;
+            index.decode(i, squares, strongToMove);
+            uint64_t occupied = builder.occupancy(squares);
+            const Geometry& g = geometry();
+
+            if (!strongToMove) {
+                // Lost for the bare king: every strong move into it is a win.
+                for (int piece = 0; piece < builder.count; piece++) {
+                    if (piece == 1) continue;
+                    int to = squares[piece];
+                    int saved = squares[piece];
+                    auto tryFrom = [&](int from) {
+                        squares[piece] = from;
+                        builder.claim(squares, true, decided);
+                        squares[piece] = saved;
+                    };
+
+                    switch (builder.type[piece]) {
+                        case PieceType::KING:
+                        case PieceType::KNIGHT: {
+                            uint64_t sources = (builder.type[piece] == PieceType::KING ? g.king[to] : g.knight[to])
+                                             & ~occupied;
+                            while (sources) {
+                                tryFrom(__builtin_ctzll(sources));
+                                sources &= sources - 1;
+                            }
+                            break;
+                        }
+                        case PieceType::PAWN:
+                            if ((to >> 3) >= 2 && !(occupied & bit(to - 8))) {
+                                tryFrom(to - 8);
+                                if ((to >> 3) == 3 && !(occupied & bit(to - 16))) tryFrom(to - 16);
+                            }
+                            break;
+                        default: {
+                            bool straight = builder.type[piece] != PieceType::BISHOP;
+                            bool diagonal = builder.type[piece] != PieceType::ROOK;
+                            for (int d = 0; d < 8; d++) {
+                                const int* step = d < 4 ? ROOK_DIRECTIONS[d] : BISHOP_DIRECTIONS[d - 4];
+                                if ((d < 4 && !straight) || (d >= 4 && !diagonal)) continue;
+                                int f = (to & 7) + step[0], r = (to >> 3) + step[1];
+                                while (f >= 0 && f < 8 && r >= 0 && r < 8 && !(occupied & bit(r * 8 + f))) {
+                                    tryFrom(r * 8 + f);
+                                    f += step[0];
+                                    r += step[1];
+                                }
+                            }
+                            break;
+                        }
+                    }
+                }
+            } else {
+                // Won for the strong side: bare king moves into it may now be losses.
+                uint64_t sources = g.king[squares[1]] & ~occupied;
+                int saved = squares[1];
+                while (sources) {
+                    squares[1] = __builtin_ctzll(sources);
+                    sources &= sources - 1;
+                    if (builder.valueAt(squares, false) != Tablebase::DRAW) continue;
+
+                    bool anyMove, allLose;
+                    builder.weakMoves(squares, frontier, anyMove, allLose);
+                    if (anyMove && allLose) builder.claim(squares, false, decided);
+                }
+                squares[1] = saved;
+            }
+        });
+
+        // Promotion wins join the wins found in this pass.
+        bool pendingPromotions = nextPromotion < promotions.size();
+        while (nextPromotion < promotions.size() && promotions[nextPromotion].first == decided) {
+            uint8_t expected = Tablebase::DRAW;
+            values[promotions[nextPromotion].second].compare_exchange_strong(expected, decided);
+            nextPromotion++;
+        }
+
+        // A bare king position whose longest line is a capture into a smaller
+        // table has no successor here to trigger it; check it once that
+        // line's length is reached.
+        bool pendingCaptures = nextCapture < captures.size();
+        while (nextCapture < captures.size() && captures[nextCapture].first <= frontier) {
+            uint64_t i = captures[nextCapture++].second;
+            if (values[i].load(std::memory_order_relaxed) != Tablebase::DRAW) continue;
+
+            int squares[TablebaseIndex::MAX_PIECES];
+            bool strongToMove;
+            index.decode(i, squares, strongToMove);
+            bool anyMove, allLose;
+            builder.weakMoves(squares, frontier, anyMove, allLose);
+            if (anyMove && allLose) builder.claim(squares, false, decided);
+        }
+
+        if (progress.load()) maxPlies = plies;
+        if (!progress.load() && !pendingPromotions && !pendingCaptures) break;
+    }
+
+    // Statistics and output.
+    uint64_t wins = 0, losses = 0, draws = 0, illegal = 0;
+    for (uint64_t i = 0; i < size; i++) {
+        uint8_t value = values[i].load(std::memory_order_relaxed);
+        if (value == Tablebase::ILLEGAL) illegal++;
+        else if (value == Tablebase::DRAW) draws++;
+        else if (i < size / 2) wins++;
+        else losses++;
+    }
+
+    std::string filename = (std::filesystem::path(directory) / (material + ".cctb")).string();
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Cannot write " << filename << std::endl;
+        return false;
+    }
+
+    char name[8] = {};
+    std::copy(material.begin(), material.end(), name);
+    uint32_t version = Tablebase::VERSION;
+    out.write("CCTB", 4);
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(name, sizeof(name));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+
+    // Compress in fixed-size blocks so probes only decode what they touch.
+    uint32_t blockSize = Tablebase::BLOCK_SIZE;
+    uint32_t blockCount = static_cast<uint32_t>((size + blockSize - 1) / blockSize);
+    std::vector<uint64_t> offsets(1, 0);
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> block(blockSize);
+    for (uint32_t b = 0; b < blockCount; b++) {
+        uint64_t first = static_cast<uint64_t>(b) * blockSize;
+        size_t count = static_cast<size_t>(std::min<uint64_t>(blockSize, size - first));
+        for (size_t i = 0; i < count; i++) {
+            block[i] = values[first + i].load(std::memory_order_relaxed);
+        }
+        std::vector<uint8_t> encoded = Tablebase::compressBlock(block.data(), count);
+        data.insert(data.end(), encoded.begin(), encoded.end());
+        offsets.push_back(data.size());
+    }
+
+    out.write(reinterpret_cast<const char*>(&blockSize), sizeof(blockSize));
+    out.write(reinterpret_cast<const char*>(&blockCount), sizeof(blockCount));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << material << ": " << size << " entries, " << wins << " wins, " << losses << " losses, "
+              << draws << " draws, " << illegal << " illegal, longest mate " << maxPlies << " plies, "
+              << data.size() + offsets.size() * sizeof(uint64_t) << " bytes compressed, " << seconds << " s"
+              << std::endl;
+    return out.good();
+}
+
+/**
+ * Generates several tables and the missing ones they depend on, in
+ * dependency order.
+ */
+int TablebaseGenerator::generateAll(const std::string& directory, int threads, std::vector<std::string> materials) {
+    if (materials.empty()) materials = { "KQK", "KRK", "KPK", "KBNK" };
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (const std::string& material : materials) {
+        if (!TablebaseIndex::isValidMaterial(material)) {
+            std::cerr << "Unsupported material: " << material << std::endl;
+            return 2;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Add the tables the requested ones need that the directory lacks.
+    Tablebase::init(directory);
+    for (size_t i = 0; i < materials.size(); i++) {
+        for (const std::string& needed : requiredMaterials(materials[i])) {
+            int squares[TablebaseIndex::MAX_PIECES] = {};
+            if (std::find(materials.begin(), materials.end(), needed) != materials.end() ||
+                Tablebase::probeRaw(needed, squares, true).has_value()) {
+                continue;
+            }
+            std::cout << materials[i] << " needs " << needed << ", generating it too" << std::endl;
+            materials.push_back(needed);
+        }
+    }
+    std::stable_sort(materials.begin(), materials.end(), buildsBefore);
+
+    std::cout << "Generating with " << threads << " thread(s)" << std::endl;
+    for (const std::string& material : materials) {
+        if (!requiredMaterials(material).empty()) Tablebase::init(directory);
+        if (!generate(material, directory, threads)) return 1;
+    }
+    Tablebase::init(directory);
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "tablebase/TablebaseIndex.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// a1, b1, c1, d1, b2, c2, d2, c3, d3, d4
+const int TRIANGLE[10] = { 0, 1, 2, 3, 9, 10, 11, 18, 19, 27 };
+
+/**
+ * Gets the position of a square in TRIANGLE, or -1.
+ */
+int triangleSlot(int square) {
+    for (int i = 0; i < 10; i++) {
+        if (TRIANGLE[i] == square) return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+const int TablebaseIndex::MAX_PIECES;
+
+/**
+ * Creates the index for a material string such as "KQK" or "KBNK".
+ */
+TablebaseIndex::TablebaseIndex(const std::string& material) : pawns(false), entries(0) {
+    if (!isValidMaterial(material)) {
+        throw std::invalid_argument("Unsupported tablebase material: " + material);
+    }
+    for (size_t i = 1; i + 1 < material.size(); i++) {
+        pieces.push_back(charToPieceType(material[i]).value());
+        if (pieces.back() == PieceType::PAWN) pawns = true;
+    }
+
+    entries = 2 * static_cast<uint64_t>(pawns ? 64 : 10) * 64;
+    for (size_t i = 0; i < pieces.size(); i++) entries *= 64;
+}
+
+/**
+ * Checks whether a material string describes a supported table.
+ */
+bool TablebaseIndex::isValidMaterial(const std::string& material) {
+    if (material.size() < 3 || static_cast<int>(material.size()) > MAX_PIECES) return false;
+    if (material.front() != 'K' || material.back() != 'K') return false;
+
+    int previous = static_cast<int>(PieceType::KING);
+    for (size_t i = 1; i + 1 < material.size(); i++) {
+        std::optional<PieceType> type = charToPieceType(material[i]);
+        if (!type.has_value() || type.value() == PieceType::KING) return false;
+        // Pieces in type order; equal pieces may repeat (KRRK). Their two
+        // orders get separate, equally valued entries.
+        if (static_cast<int>(type.value()) < previous) return false;
+        previous = static_cast<int>(type.value());
+    }
+    return true;
+}
+
+/**
+ * Builds a material string from the strong side's pieces.
+ */
+std::string TablebaseIndex::materialName(std::vector<PieceType> pieces) {
+    std::sort(pieces.begin(), pieces.end());
+    std::string name = "K";
+    for (PieceType type : pieces) name += pieceTypeToChar(type);
+    return name + "K";
+}
+
+/**
+ * Gets the number of men (kings included).
+ */
+int TablebaseIndex::pieceCount() const {
+    return static_cast<int>(pieces.size()) + 2;
+}
+
+/**
+ * Gets the strong side's non-king pieces in index order.
+ */
+const std::vector<PieceType>& TablebaseIndex::getPieces() const {
+    return pieces;
+}
+
+/**
+ * Checks whether the table contains pawns.
+ */
+bool TablebaseIndex::hasPawns() const {
+    return pawns;
+}
+
+/**
+ * Gets the number of entries in the table.
+ */
+uint64_t TablebaseIndex::size() const {
+    return entries;
+}
+
+/**
+ * Computes the index of a position, applying the board symmetry first.
+ */
+uint64_t TablebaseIndex::index(const int* squares, bool strongToMove) const {
+    int count = pieceCount();
+    int mapped[MAX_PIECES];
+    std::copy(squares, squares + count, mapped);
+
+    if (!pawns) {
+        // Mirror files and ranks to bring the strong king to the a1-d4 quadrant.
+        int file = mapped[0] & 7, rank = mapped[0] >> 3;
+        bool flipFile = file > 3;
+        bool flipRank = rank > 3;
+        if (flipFile) file = 7 - file;
+        if (flipRank) rank = 7 - rank;
+        for (int i = 0; i < count; i++) {
+            int f = mapped[i] & 7, r = mapped[i] >> 3;
+            if (flipFile) f = 7 - f;
+            if (flipRank) r = 7 - r;
+            mapped[i] = r * 8 + f;
+        }
+
+        // Mirror along a1-h8 to reach the triangle. With the king on the
+        // diagonal, the first piece off it decides, so that every symmetric
+        // variant maps to the same index.
+        bool transpose = false;
+        for (int i = 0; i < count; i++) {
+            int f = mapped[i] & 7, r = mapped[i] >> 3;
+            if (f != r) {
+                transpose = r > f;
+                break;
+            }
+        }
+        if (transpose) {
+            for (int i = 0; i < count; i++) {
+                mapped[i] = (mapped[i] & 7) * 8 + (mapped[i] >> 3);
+            }
+        }
+    }
+
+    uint64_t result = strongToMove ? 0 : 1;
+    result = result * (pawns ? 64 : 10) + (pawns ? mapped[0] : triangleSlot(mapped[0]));
+    for (int i = 1; i < count; i++) {
+        result = result * 64 + mapped[i];
+    }
+    return result;
+}
+
+/**
+ * Recovers a position from an index.
+ */
+void TablebaseIndex::decode(uint64_t index, int* squares, bool& strongToMove) const {
+    int count = pieceCount();
+    for (int i = count - 1; i >= 1; i--) {
+        squares[i] = static_cast<int>(index % 64);
+        index /= 64;
+    }
+    int kingSlots = pawns ? 64 : 10;
+    int slot = static_cast<int>(index % kingSlots);
+    squares[0] = pawns ? slot : TRIANGLE[slot];
+    strongToMove = (index / kingSlots) == 0;
+}
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <sstream>
 #include "board/Board.h"
 #include "board/Square.h"
 #include "board/Move.h"
@@ -16,6 +20,14 @@
 #include "cli/PieceRenderer.h"
 #include "game/Game.h"
 #include "input/PGNHandler.h"
+#include "archive/ArchiveConverter.h"
+#include "archive/GameArchive.h"
+#include "book/OpeningBook.h"
+#include "input/PGNReader.h"
+#include "tools/Benchmark.h"
+#include "eval/Evaluator.h"
+#include "eval/Nnue.h"
+#include "util/LatencyStats.h"
 
 void printTestHeader(const std::string& testName) {
     std::cout << "\n========================================" << std::endl;
@@ -142,3 +154,349 @@ int runDarianTests() {
     testPGNHandler();
     return 0;
 }
+
+// ---------------------------------------------------------------------------
+// Assertion tests, run by "chess test" and registered with CTest. Each check
+// prints a line on failure; runTests() returns the number of failed checks.
+// ---------------------------------------------------------------------------
+
+int testFailures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        testFailures++;
+        std::cout << "FAIL: " << what << std::endl;
+    }
+}
+
+// Special moves seen by playRandomMoves().
+struct MoveKinds {
+    int castles = 0;
+    int enPassants = 0;
+    int promotions = 0;
+};
+
+// Positions from which random play soon castles, captures en passant and promotes.
+const char* RANDOM_START_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "8/2P2k2/8/8/8/8/2p2K2/8 w - - 0 1",
+};
+
+// One game played by playRandomMoves().
+struct RandomGame {
+    std::string startFen;
+    std::vector<Move> moves;
+};
+
+// Plays random legal moves (underpromotions included) from each start
+// position, calling visit(board, sideToMove) after every move. The games
+// played are appended to games if it is given.
+template <typename Visit>
+MoveKinds playRandomMoves(unsigned seed, int gamesPerStart, int plies, Visit visit,
+                          std::vector<RandomGame>* games = nullptr) {
+    std::mt19937 rng(seed);
+    MoveKinds kinds;
+    for (const char* fen : RANDOM_START_FENS) {
+        for (int g = 0; g < gamesPerStart; g++) {
+            Board board;
+            Color side;
+            int halfmoves, fullmoves;
+            if (!board.loadFen(fen, side, halfmoves, fullmoves)) {
+                check(false, std::string("load start position ") + fen);
+                break;
+            }
+            if (games != nullptr) games->push_back({fen, {}});
+            for (int ply = 0; ply < plies; ply++) {
+                std::vector<Move> moves = GameArchive::legalMoves(board, side);
+                if (moves.empty()) break;
+                Move move = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+
+                const Piece* moving = board.getPieceAt(move.getFrom());
+                int fileChange = std::abs(move.getTo().getFile() - move.getFrom().getFile());
+                if (moving->getType() == PieceType::KING && fileChange == 2) kinds.castles++;
+                if (moving->getType() == PieceType::PAWN && fileChange == 1 && board.getPieceAt(move.getTo()) == nullptr) {
+                    kinds.enPassants++;
+                }
+                if (move.isPromotion()) kinds.promotions++;
+                if (games != nullptr) games->back().moves.push_back(move);
+
+                board.applyMove(move);
+                side = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+                visit(board, side);
+            }
+        }
+    }
+    return kinds;
+}
+
+// Checks that random play covered every kind of special move.
+void checkCoverage(const MoveKinds& kinds, const std::string& test) {
+    check(kinds.castles > 0, test + ": random play castled");
+    check(kinds.enPassants > 0, test + ": random play captured en passant");
+    check(kinds.promotions > 0, test + ": random play promoted");
+}
+
+void testFenRoundTrip() {
+    printTestHeader("TEST: FEN import/export round trip");
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq - 7 42",
+        "8/8/8/4k3/8/8/4K3/8 w - - 99 150",
+    };
+    for (const char* fen : fens) {
+        Game game;
+        check(game.loadFen(fen) && game.toFen() == fen, std::string("FEN round trip of ") + fen);
+    }
+
+    const char* invalid[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1BNR w KQkq - 0 1",   // no white king
+        "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",   // rank too long
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1",   // bad side to move
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",            // seven ranks
+    };
+    for (const char* fen : invalid) {
+        Game game;
+        check(!game.loadFen(fen), std::string("reject invalid FEN ") + fen);
+    }
+
+    // Every position of random play survives export and import unchanged.
+    int mismatches = 0;
+    playRandomMoves(36, 4, 80, [&](const Board& board, Color side) {
+        std::string fen = board.toFen(side);
+        Board copy;
+        Color copySide;
+        int halfmoves, fullmoves;
+        bool same = copy.loadFen(fen, copySide, halfmoves, fullmoves) && copy.toFen(copySide) == fen &&
+                    copy.getHashKey(copySide) == board.getHashKey(side);
+        if (!same && mismatches++ == 0) check(false, "random position FEN round trip at " + fen);
+    });
+}
+
+void testPerft() {
+    printTestHeader("TEST: Perft from FEN positions");
+    struct Case { const char* fen; int depth; uint64_t nodes; };
+    const Case cases[] = {
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8902 },
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+        { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238 },
+        { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467 },
+        { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379 },
+    };
+    for (const Case& c : cases) {
+        Board board;
+        Color side;
+        int halfmoves, fullmoves;
+        check(board.loadFen(c.fen, side, halfmoves, fullmoves), std::string("load ") + c.fen);
+        uint64_t nodes = Benchmark::perft(board, side, c.depth);
+        check(nodes == c.nodes, std::string("perft ") + std::to_string(c.depth) + " of " + c.fen + " = " +
+                                std::to_string(nodes) + ", expected " + std::to_string(c.nodes));
+    }
+}
+
+void testPstIncremental() {
+    printTestHeader("TEST: Incremental PST evaluation vs full recompute");
+    int positions = 0, mismatches = 0;
+    MoveKinds kinds = playRandomMoves(26, 20, 120, [&](const Board& board, Color side) {
+        positions++;
+        if (!Evaluator::verify(board) || Evaluator::evaluatePst(board, side) != Evaluator::evaluateFull(board, side)) {
+            if (mismatches++ == 0) check(false, "PST sums differ from a full recompute at " + board.toFen(side));
+        }
+    });
+    checkCoverage(kinds, "PST");
+    std::cout << positions << " positions, " << mismatches << " mismatches" << std::endl;
+}
+
+void testNnueIncremental() {
+    printTestHeader("TEST: NNUE accumulator vs full recompute");
+    std::string weights = (std::filesystem::temp_directory_path() / "chess_test.nnue").string();
+    bool loaded = Nnue::writeRandomWeights(weights, 28) && Nnue::load(weights);
+    check(loaded, "write and load random NNUE weights");
+    if (!loaded) return;
+
+    int positions = 0, mismatches = 0;
+    MoveKinds kinds = playRandomMoves(28, 20, 120, [&](const Board& board, Color side) {
+        positions++;
+        if (!Nnue::verify(board) || Nnue::evaluate(board, side) != Nnue::evaluateFull(board, side)) {
+            if (mismatches++ == 0) check(false, "NNUE accumulator differs from a full refresh at " + board.toFen(side));
+        }
+    });
+    Nnue::unload();
+    std::filesystem::remove(weights);
+
+    checkCoverage(kinds, "NNUE");
+    std::cout << positions << " positions, " << mismatches << " mismatches" << std::endl;
+}
+
+void testPromotionMove() {
+    printTestHeader("TEST: Promotion in Board::applyMove");
+    // The promoted pawn is deleted; the en passant update must not read it.
+    struct Case { const char* fen; Move move; const char* expected; };
+    const Case cases[] = {
+        { "8/P6k/8/8/8/8/8/K7 w - - 0 1", Move(Square(0, 6), Square(0, 7), PieceType::QUEEN),
+          "Q7/7k/8/8/8/8/8/K7 b - - 0 1" },
+        { "1r5k/P7/8/8/8/8/8/K7 w - - 0 1", Move(Square(0, 6), Square(1, 7), PieceType::KNIGHT),
+          "1N5k/8/8/8/8/8/8/K7 b - - 0 1" },
+        { "k7/8/8/8/8/8/p7/7K b - - 0 1", Move(Square(0, 1), Square(0, 0), PieceType::ROOK),
+          "k7/8/8/8/8/8/8/r6K w - - 0 1" },
+    };
+    for (const Case& c : cases) {
+        Board board;
+        Color side;
+        int halfmoves, fullmoves;
+        check(board.loadFen(c.fen, side, halfmoves, fullmoves), std::string("load ") + c.fen);
+        board.applyMove(c.move);
+        Color next = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+        check(board.toFen(next, 0, 1) == c.expected, std::string("promotion from ") + c.fen + " gives " + c.expected);
+    }
+}
+
+void testArchiveRoundTrip() {
+    printTestHeader("TEST: Game archive pack/unpack round trip");
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string archiveFile = (dir / "chess_test.ccga").string();
+
+    // Random games (castling, en passant, underpromotions) through the writer and reader.
+    std::vector<RandomGame> games;
+    MoveKinds kinds = playRandomMoves(42, 4, 150, [](const Board&, Color) {}, &games);
+    checkCoverage(kinds, "archive");
+    {
+        GameArchiveWriter writer(archiveFile);
+        check(writer.isOpen(), "create " + archiveFile);
+        for (size_t i = 0; i < games.size(); i++) {
+            ArchivedGame archived;
+            archived.header.round = std::to_string(i + 1);
+            archived.startFen = games[i].startFen;
+            Board board;
+            Color side;
+            int halfmoves, fullmoves;
+            board.loadFen(games[i].startFen, side, halfmoves, fullmoves);
+            for (const Move& move : games[i].moves) {
+                std::vector<Move> legal = GameArchive::legalMoves(board, side);
+                archived.moves.push_back(static_cast<uint8_t>(std::find(legal.begin(), legal.end(), move) - legal.begin()));
+                board.applyMove(move);
+                side = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+            }
+            writer.add(archived);
+        }
+        check(writer.close(), "close " + archiveFile);
+    }
+    GameArchive archive;
+    check(archive.open(archiveFile) && archive.size() == games.size(), "reopen archive with every game");
+    for (uint64_t i = 0; i < archive.size(); i++) {
+        ArchivedGame archived;
+        std::vector<Move> moves;
+        bool same = archive.read(i, archived) && GameArchive::decode(archived, moves) &&
+                    archived.header.round == std::to_string(i + 1) && archived.startFen == games[i].startFen &&
+                    moves == games[i].moves;
+        check(same, "archived game " + std::to_string(i + 1) + " decodes to the moves played");
+    }
+    archive.close();
+
+    // PGN -> archive -> PGN keeps tags, the start position and every move.
+    std::string pgnFile = (dir / "chess_test_in.pgn").string();
+    std::string unpackedFile = (dir / "chess_test_out.pgn").string();
+    {
+        std::ofstream out(pgnFile);
+        out << "[Event \"Test\"]\n[Site \"?\"]\n[Date \"2025.01.01\"]\n[Round \"1\"]\n"
+               "[White \"A\"]\n[Black \"B\"]\n[Result \"*\"]\n\n"
+               "1. e4 Nf6 2. e5 d5 3. exd6 e6 4. dxc7 Be7 5. cxb8=N O-O 6. Nf3 Nd5 7. Bc4 Qa5 8. O-O *\n\n"
+               "[Event \"Test\"]\n[Site \"?\"]\n[Date \"2025.01.02\"]\n[Round \"2\"]\n"
+               "[White \"C\"]\n[Black \"D\"]\n[Result \"*\"]\n[SetUp \"1\"]\n"
+               "[FEN \"8/2P2k2/8/8/8/8/2p2K2/8 w - - 0 1\"]\n\n"
+               "1. c8=R c1=B 2. Rc7+ Ke6 *\n";
+    }
+    check(ArchiveConverter::pack(pgnFile, archiveFile) == 0, "pack " + pgnFile);
+    check(ArchiveConverter::unpack(archiveFile, unpackedFile) == 0, "unpack " + archiveFile);
+
+    PGNReader original(pgnFile);
+    PGNReader unpacked(unpackedFile);
+    PGNGame before, after;
+    int compared = 0;
+    while (original.next(before)) {
+        if (!unpacked.next(after)) break;
+        compared++;
+        std::string what = "unpacked game " + std::to_string(compared);
+        for (const char* tag : {"Event", "Date", "Round", "White", "Black", "Result", "FEN"}) {
+            check(before.tag(tag) == after.tag(tag), what + " keeps tag " + tag);
+        }
+        check(before.moves == after.moves, what + " keeps its moves");
+    }
+    check(compared == 2 && !unpacked.next(after), "unpacked file has both games");
+
+    std::filesystem::remove(archiveFile);
+    std::filesystem::remove(pgnFile);
+    std::filesystem::remove(unpackedFile);
+    std::cout << games.size() << " random games, " << compared << " PGN games round-tripped" << std::endl;
+}
+
+void testPolyglotKeys() {
+    printTestHeader("TEST: Polyglot book keys");
+    // Reference keys from the Polyglot book format specification.
+    struct Case { const char* moves; uint64_t key; };
+    const Case cases[] = {
+        { "", 0x463B96181691FC9CULL },
+        { "e2e4", 0x823C9B50FD114196ULL },
+        { "e2e4 d7d5", 0x0756B94461C50FB0ULL },
+        { "e2e4 d7d5 e4e5", 0x662FAFB965DB29D4ULL },
+        { "e2e4 d7d5 e4e5 f7f5", 0x22A48B5A8E47FF78ULL },
+        { "e2e4 d7d5 e4e5 f7f5 e1e2", 0x652A607CA3F242C1ULL },
+        { "e2e4 d7d5 e4e5 f7f5 e1e2 e8f7", 0x00FDD303C946BDD9ULL },
+        { "a2a4 b7b5 h2h4 b5b4 c2c4", 0x3C8123EA7B067637ULL },
+        { "a2a4 b7b5 h2h4 b5b4 c2c4 b4c3 a1a3", 0x5C3F9B829B279560ULL },
+    };
+    for (const Case& c : cases) {
+        Board board;
+        Color side;
+        int halfmoves, fullmoves;
+        board.loadFen(Game::START_FEN, side, halfmoves, fullmoves);
+        std::istringstream moves(c.moves);
+        std::string move;
+        while (moves >> move) {
+            Square from(0, 0), to(0, 0);
+            Square::fromString(move.substr(0, 2), from);
+            Square::fromString(move.substr(2, 2), to);
+            board.applyMove(Move(from, to));
+            side = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+        }
+        check(OpeningBook::key(board, side) == c.key, std::string("Polyglot key after \"") + c.moves + "\"");
+    }
+}
+
+void testLatencyStats() {
+    printTestHeader("TEST: Latency histogram percentiles");
+    LatencyStats stats;
+    check(stats.percentileUs(50) == 0, "no samples gives 0");
+    // 1 us .. 100 ms: bucketed percentiles must stay within 1/32 above the exact ones.
+    for (int64_t micros = 1; micros <= 100000; micros++) stats.add(micros * 1000);
+    check(stats.count() == 100000, "count every sample");
+    for (double percent : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        uint32_t exact = static_cast<uint32_t>(percent * 1000);
+        uint32_t reported = stats.percentileUs(percent);
+        check(reported >= exact && reported <= exact + exact / 32, "p" + std::to_string(percent) + " near " +
+              std::to_string(exact) + " us, got " + std::to_string(reported));
+    }
+    check(stats.percentileUs(100) == 100000, "maximum is exact");
+    stats.add(int64_t(1) << 62);
+    check(stats.percentileUs(100) == UINT32_MAX, "huge samples are clamped");
+    stats.clear();
+    check(stats.count() == 0 && stats.percentileUs(99) == 0, "clear removes all samples");
+}
+
+int runTests() {
+    testFailures = 0;
+    testFenRoundTrip();
+    testPerft();
+    testPromotionMove();
+    testPstIncremental();
+    testNnueIncremental();
+    testArchiveRoundTrip();
+    testPolyglotKeys();
+    testLatencyStats();
+    std::cout << (testFailures == 0 ? "All tests passed" : std::to_string(testFailures) + " check(s) failed")
+              << std::endl;
+    return testFailures;
+}
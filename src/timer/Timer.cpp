@@ -6,12 +6,13 @@
 /**
  * Constructs a timer with specified minutes per player.
  */
-Timer::Timer(int minutesPerPlayer)
+Timer::Timer(int minutesPerPlayer, int incrementSeconds)
     : whiteTime(minutesPerPlayer * 60),
       blackTime(minutesPerPlayer * 60),
       running(Color::WHITE),
       stopFlag(false),
-      totalSeconds(minutesPerPlayer * 60) {}
+      totalSeconds(minutesPerPlayer * 60),
+      incrementSeconds(incrementSeconds) {}
 
 /**
  * Destructor - stops the timer thread.
@@ -72,6 +73,11 @@ void Timer::timerLoop() {
  * Switches the turn to the other player.
  */
 void Timer::switchTurn() {
+    if (running == Color::WHITE) {
+        whiteTime += incrementSeconds;
+    } else {
+        blackTime += incrementSeconds;
+    }
     running = (running == Color::WHITE) ? Color::BLACK : Color::WHITE;
     printTime();
 }
@@ -110,4 +116,18 @@ int Timer::getRemainingSeconds(Color color) const {
  */
 bool Timer::isTimeOver(Color color) const {
     return getRemainingSeconds(color) <= 0;
-}
\ No newline at end of file
+}
+
+/**
+ * Gets the per-move increment.
+ */
+int Timer::getIncrementSeconds() const {
+    return incrementSeconds;
+}
+
+/**
+ * Gets whose clock is currently running.
+ */
+Color Timer::getRunningColor() const {
+    return running.load();
+}
@@ -0,0 +1,585 @@
+#include "tools/Benchmark.h"
+#include "engine/Search.h"
+#include "engine/TranspositionTable.h"
+#include "eval/Evaluator.h"
+#include "eval/Nnue.h"
+#include "input/MoveParser.h"
+#include "input/PGNHandler.h"
+#include "input/PGNReader.h"
+#include "input/PGNWriter.h"
+#include "tablebase/Tablebase.h"
+#include "tablebase/TablebaseIndex.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+/**
+ * Plays deterministic pseudo-random games and collects every position reached.
+ */
+std::vector<Game> Benchmark::samplePositions(int games, int maxPlies, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Game> positions;
+
+    for (int g = 0; g < games; g++) {
+        Game game;
+        positions.push_back(game);
+        for (int ply = 0; ply < maxPlies; ply++) {
+            std::vector<Move> moves = game.getLegalMoves();
+            if (moves.empty()) break;
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            if (!game.makeMove(moves[pick(rng)])) break;
+            positions.push_back(game);
+            if (game.getState() != GameState::ONGOING && game.getState() != GameState::CHECK) break;
+        }
+    }
+    return positions;
+}
+
+/**
+ * Verifies incremental PST sums and measures evaluations per second.
+ */
+int Benchmark::runEval(long iterations) {
+    std::vector<Game> positions = samplePositions(20, 120, 12345);
+
+    int mismatches = 0;
+    for (const Game& game : positions) {
+        if (!Evaluator::verify(game.getBoard())) mismatches++;
+    }
+    std::cout << "Verified " << positions.size() << " positions, "
+              << mismatches << " mismatches" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    long long sink = 0;
+
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; i++) {
+        const Game& game = positions[i % positions.size()];
+        sink += Evaluator::evaluatePst(game.getBoard(), game.getCurrentPlayer());
+    }
+    double incremental = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (long i = 0; i < iterations; i++) {
+        const Game& game = positions[i % positions.size()];
+        sink -= Evaluator::evaluateFull(game.getBoard(), game.getCurrentPlayer());
+    }
+    double full = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const PawnHashTable& pawns = Evaluator::pawnTable();
+    std::cout << "Incremental: " << static_cast<long long>(iterations / incremental) << " evals/s" << std::endl;
+    std::cout << "Pawn hash:   " << pawns.getHits() << "/" << pawns.getProbes() << " hits ("
+              << static_cast<int>(pawns.getHitRate() * 100) << "%)" << std::endl;
+    std::cout << "Full scan:   " << static_cast<long long>(iterations / full) << " evals/s" << std::endl;
+    std::cout << "Checksum:    " << sink << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Verifies NNUE accumulators and compares evals/sec against the PST evaluator.
+ */
+int Benchmark::runNnue(const std::string& weightsFile, long iterations) {
+    if (!Nnue::load(weightsFile)) {
+        std::cerr << "Cannot load NNUE weights: " << weightsFile << std::endl;
+        return 1;
+    }
+
+    // Positions are sampled after loading, so every accumulator was built
+    // incrementally by the Board move executor.
+    std::vector<Game> positions = samplePositions(20, 120, 12345);
+
+    int mismatches = 0;
+    for (const Game& game : positions) {
+        const Board& board = game.getBoard();
+        if (!Nnue::verify(board) ||
+            Nnue::evaluate(board, game.getCurrentPlayer()) != Nnue::evaluateFull(board, game.getCurrentPlayer())) {
+            mismatches++;
+        }
+    }
+    std::cout << "Verified " << positions.size() << " accumulators, "
+              << mismatches << " mismatches" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    long long sink = 0;
+
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; i++) {
+        const Game& game = positions[i % positions.size()];
+        sink += Nnue::evaluate(game.getBoard(), game.getCurrentPlayer());
+    }
+    double nnue = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (long i = 0; i < iterations; i++) {
+        const Game& game = positions[i % positions.size()];
+        sink += Evaluator::evaluatePst(game.getBoard(), game.getCurrentPlayer());
+    }
+    double pst = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "NNUE: " << static_cast<long long>(iterations / nnue) << " evals/s" << std::endl;
+    std::cout << "PST:  " << static_cast<long long>(iterations / pst) << " evals/s" << std::endl;
+    std::cout << "Checksum: " << sink << std::endl;
+
+    Nnue::unload();
+    return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Checks perft from the starting position, then times fixed-depth searches.
+ */
+int Benchmark::runSearch(int depth) {
+    const uint64_t expected[] = { 1, 20, 400, 8902 };
+    Game start;
+    bool perftOk = true;
+    for (int d = 1; d <= 3; d++) {
+        uint64_t count = perft(start.getBoard(), Color::WHITE, d);
+        std::cout << "Perft " << d << ": " << count
+                  << (count == expected[d] ? "" : " (expected " + std::to_string(expected[d]) + ")") << std::endl;
+        if (count != expected[d]) perftOk = false;
+    }
+
+    std::vector<Game> positions = samplePositions(4, 40, 12345);
+    TranspositionTable table(16);
+    Search search(table);
+    SearchLimits limits;
+    limits.depth = depth;
+
+    using Clock = std::chrono::steady_clock;
+    uint64_t totalNodes = 0;
+    auto begin = Clock::now();
+    for (size_t i = 0; i < positions.size(); i += 10) {
+        const Game& game = positions[i];
+        if (game.getLegalMoves().empty()) continue;
+        table.clear();
+        SearchResult result = search.run(game.getBoard(), game.getCurrentPlayer(), limits);
+        totalNodes += result.nodes;
+        std::cout << "Position " << i << ": " << result.bestMove->toString()
+                  << " score " << result.score << " nodes " << result.nodes << std::endl;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::cout << "Nodes: " << totalNodes << std::endl;
+    std::cout << "NPS:   " << static_cast<long long>(totalNodes / seconds) << std::endl;
+    return perftOk ? 0 : 1;
+}
+
+/**
+ * Probes random table entries through a small and a default-sized block cache.
+ */
+int Benchmark::runTablebase(const std::string& directory, long probes, int threads) {
+    if (Tablebase::init(directory) == 0) {
+        std::cerr << "No tablebases in " << directory << std::endl;
+        return 1;
+    }
+    std::vector<std::string> materials = Tablebase::getMaterials();
+    threads = std::max(1, threads);
+
+    // Each thread probes its own deterministic sequence, so both passes read
+    // exactly the same entries and their checksums must match.
+    auto pass = [&](size_t cacheBlocks) {
+        Tablebase::clear();
+        Tablebase::init(directory);
+        Tablebase::setCacheSize(cacheBlocks);
+        std::atomic<uint64_t> checksum{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                std::mt19937_64 rng(7919 + t);
+                uint64_t sum = 0;
+                for (long i = t; i < probes; i += threads) {
+                    const std::string& material = materials[rng() % materials.size()];
+                    TablebaseIndex index(material);
+                    int squares[TablebaseIndex::MAX_PIECES];
+                    for (int p = 0; p < index.pieceCount(); p++) squares[p] = static_cast<int>(rng() % 64);
+                    bool strongToMove = (rng() & 1) != 0;
+                    std::optional<uint8_t> value = Tablebase::probeRaw(material, squares, strongToMove);
+                    sum += (value.has_value() ? value.value() + 1 : 0) * (i + 1);
+                }
+                checksum += sum;
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+        return checksum.load();
+    };
+
+    using Clock = std::chrono::steady_clock;
+    bool consistent = true;
+    uint64_t reference = 0;
+    const size_t cacheSizes[] = { 16, 1024 };
+    for (size_t cacheBlocks : cacheSizes) {
+        auto begin = Clock::now();
+        uint64_t checksum = pass(cacheBlocks);
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        if (cacheBlocks == cacheSizes[0]) reference = checksum;
+        else if (checksum != reference) consistent = false;
+
+        TablebaseStats stats = Tablebase::getStats();
+        uint64_t lookups = stats.cacheHits + stats.cacheMisses;
+        std::cout << "Cache " << cacheBlocks << " blocks: " << stats.probes << " probes, "
+                  << static_cast<long long>(stats.probes / seconds) << " probes/s, hit rate "
+                  << (lookups ? 100.0 * stats.cacheHits / lookups : 0.0) << "%, "
+                  << stats.cacheMisses << " blocks decompressed in " << stats.decompressionNs / 1000000.0
+                  << " ms, " << stats.tablesMapped << " tables mapped" << std::endl;
+    }
+
+    std::cout << (consistent ? "Both passes read identical values" : "MISMATCH between passes") << std::endl;
+    return consistent ? 0 : 1;
+}
+
+/**
+ * Streams a PGN file and reports throughput.
+ */
+int Benchmark::runPgnScan(const std::string& filename, bool replay) {
+    PGNReader reader(filename);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read " << filename << std::endl;
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto begin = Clock::now();
+    PGNGame pgn;
+    uint64_t moves = 0, failed = 0;
+    while (reader.next(pgn)) {
+        moves += pgn.moves.size();
+        if (replay) {
+            Game game;
+            if (!PGNHandler::replay(game, pgn)) failed++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    uint64_t games = reader.getGamesRead();
+    std::cout << "Games:  " << games << (replay ? " (" + std::to_string(failed) + " failed to replay)" : "") << std::endl;
+    std::cout << "Moves:  " << moves << std::endl;
+    std::cout << "Bytes:  " << reader.getBytesRead() << " (largest game buffer " << reader.getGameCapacity()
+              << " bytes)" << std::endl;
+    std::cout << "Time:   " << seconds << " s, " << static_cast<long long>(games / seconds) << " games/s, "
+              << static_cast<long long>(moves / seconds) << " moves/s, "
+              << reader.getBytesRead() / seconds / (1 << 20) << " MB/s" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+namespace {
+
+/**
+ * Formats a game the way PGN export used to: one stringstream per game.
+ */
+std::string legacyPgn(const Game& game) {
+    std::stringstream ss;
+    ss << "[Event \"Console Chess Game\"]\n";
+    ss << "[Date \"????.??.??\"]\n";
+    ss << "\n";
+    std::vector<std::string> history = game.getMoveHistory();
+    for (size_t i = 0; i < history.size(); ++i) {
+        if (i % 2 == 0) ss << (1 + i / 2) << ". ";
+        ss << history[i] << " ";
+    }
+    return ss.str();
+}
+
+/**
+ * Splits a game the way PGNReader::tokenize used to: one character at a time.
+ */
+void legacyTokenize(std::string_view text, PGNGame& game) {
+    game.tags.clear();
+    game.moves.clear();
+    game.result = std::string_view();
+    game.text = text;
+
+    const char* data = text.data();
+    size_t size = text.size();
+    size_t i = 0;
+    int variationDepth = 0;
+    bool lineStart = true;
+
+    while (i < size) {
+        char c = data[i];
+        if (c == '\n') {
+            lineStart = true;
+            i++;
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+            continue;
+        }
+        bool atLineStart = lineStart;
+        lineStart = false;
+
+        if (c == '[' && variationDepth == 0) {
+            // [Name "Value"]
+            size_t end = text.find('\n', i);
+            if (end == std::string_view::npos) end = size;
+            size_t nameStart = i + 1;
+            size_t nameEnd = nameStart;
+            while (nameEnd < end && !std::isspace(static_cast<unsigned char>(data[nameEnd]))) nameEnd++;
+            size_t open = text.find('"', nameEnd);
+            size_t close = open == std::string_view::npos ? std::string_view::npos : text.find('"', open + 1);
+            if (open < end && close < end) {
+                game.tags.emplace_back(std::string_view(data + nameStart, nameEnd - nameStart),
+                                       std::string_view(data + open + 1, close - open - 1));
+            }
+            i = end;
+            continue;
+        }
+        if (c == '%' && atLineStart) {
+            // Escape line.
+            size_t end = text.find('\n', i);
+            i = end == std::string_view::npos ? size : end;
+            continue;
+        }
+        if (c == '{') {
+            size_t end = text.find('}', i);
+            i = end == std::string_view::npos ? size : end + 1;
+            continue;
+        }
+        if (c == ';') {
+            size_t end = text.find('\n', i);
+            i = end == std::string_view::npos ? size : end;
+            continue;
+        }
+        if (c == '(') {
+            variationDepth++;
+            i++;
+            continue;
+        }
+        if (c == ')') {
+            if (variationDepth > 0) variationDepth--;
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < size && !std::isspace(static_cast<unsigned char>(data[i])) &&
+               data[i] != '{' && data[i] != '(' && data[i] != ')' && data[i] != ';') {
+            i++;
+        }
+        if (variationDepth > 0) continue;
+        std::string_view token(data + start, i - start);
+
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            game.result = token;
+            continue;
+        }
+        if (token[0] == '$') continue;  // NAG
+
+        // Move numbers, possibly glued to the move ("12.", "12...", "12.Nf3").
+        if (std::isdigit(static_cast<unsigned char>(token[0]))) {
+            size_t dot = token.find_last_of('.');
+            if (dot == std::string_view::npos) continue;
+            token.remove_prefix(dot + 1);
+            if (token.empty()) continue;
+        }
+        // Annotation suffixes ("e4!?", "Nf3?") are not part of SAN.
+        while (!token.empty() && (token.back() == '!' || token.back() == '?')) token.remove_suffix(1);
+        if (!token.empty()) game.moves.push_back(token);
+    }
+}
+
+/**
+ * Checks whether two tokenizer outputs are the same.
+ */
+bool sameTokens(const PGNGame& a, const PGNGame& b) {
+    return a.tags == b.tags && a.moves == b.moves && a.result == b.result;
+}
+
+} // namespace
+
+/**
+ * Times the stringstream export path against PGNWriter.
+ */
+int Benchmark::runPgnWrite(const std::string& filename, long games) {
+    // A pool of distinct games, written round-robin so formatting dominates
+    // rather than game generation.
+    const int poolSize = 200;
+    std::mt19937 rng(2025);
+    std::vector<Game> pool;
+    uint64_t poolMoves = 0;
+    for (int g = 0; g < poolSize; g++) {
+        Game game;
+        for (int ply = 0; ply < 160; ply++) {
+            std::vector<Move> moves = game.getLegalMoves();
+            if (moves.empty()) break;
+            std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+            if (!game.makeMove(moves[pick(rng)])) break;
+            if (game.getState() != GameState::ONGOING && game.getState() != GameState::CHECK) break;
+        }
+        poolMoves += game.getMoveHistory().size();
+        pool.push_back(game);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    PGNHeader header;
+    header.white = "Engine A";
+    header.black = "Engine B";
+    auto report = [&](const char* name, double seconds, uint64_t bytes) {
+        std::cout << name << seconds << " s, " << static_cast<long long>(games / seconds) << " games/s, "
+                  << bytes / seconds / (1 << 20) << " MB/s" << std::endl;
+    };
+
+    auto begin = Clock::now();
+    uint64_t legacyBytes = 0;
+    {
+        std::ofstream out(filename);
+        for (long i = 0; i < games; i++) {
+            std::string text = legacyPgn(pool[i % poolSize]);
+            out << text << "\n\n";
+            legacyBytes += text.size() + 2;
+        }
+    }
+    report("stringstream:        ", std::chrono::duration<double>(Clock::now() - begin).count(), legacyBytes);
+
+    for (bool background : {false, true}) {
+        begin = Clock::now();
+        PGNWriter writer(filename, 1 << 20, background);
+        if (!writer.isOpen()) {
+            std::cerr << "Cannot write " << filename << std::endl;
+            return 1;
+        }
+        for (long i = 0; i < games; i++) writer.write(pool[i % poolSize], header);
+        if (!writer.close()) {
+            std::cerr << "Write failed: " << filename << std::endl;
+            return 1;
+        }
+        report(background ? "PGNWriter background: " : "PGNWriter:           ",
+               std::chrono::duration<double>(Clock::now() - begin).count(), writer.getBytesWritten());
+    }
+
+    // Read the last output back.
+    PGNReader reader(filename);
+    PGNGame pgn;
+    uint64_t movesRead = 0, expectedMoves = 0, resultsMatched = 0;
+    for (long i = 0; i < games; i++) expectedMoves += pool[i % poolSize].getMoveHistory().size();
+    for (long i = 0; reader.next(pgn); i++) {
+        movesRead += pgn.moves.size();
+        if (i < games && pgn.result == PGNWriter::result(pool[i % poolSize])) resultsMatched++;
+    }
+    bool ok = reader.getGamesRead() == static_cast<uint64_t>(games) && movesRead == expectedMoves &&
+              resultsMatched == static_cast<uint64_t>(games);
+    std::cout << "Read back: " << reader.getGamesRead() << " games, " << movesRead << " moves ("
+              << (ok ? "ok" : "MISMATCH") << "; " << poolMoves / poolSize << " moves per game on average)" << std::endl;
+    return ok ? 0 : 1;
+}
+
+/**
+ * Times SAN resolution against move application over a PGN file.
+ */
+int Benchmark::runSan(const std::string& filename) {
+    PGNReader reader(filename);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read " << filename << std::endl;
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    PGNGame pgn;
+    Game game;
+    uint64_t resolved = 0, failed = 0;
+    double resolveSeconds = 0, applySeconds = 0;
+    while (reader.next(pgn)) {
+        game = Game();
+        std::string_view fen = pgn.tag("FEN");
+        if (!fen.empty() && !game.loadFen(std::string(fen))) {
+            failed++;
+            continue;
+        }
+        for (std::string_view san : pgn.moves) {
+            auto start = Clock::now();
+            std::optional<Move> move = MoveParser::resolveSan(san, game.getBoard(), game.getCurrentPlayer());
+            auto resolvedAt = Clock::now();
+            resolveSeconds += std::chrono::duration<double>(resolvedAt - start).count();
+            if (!move.has_value()) {
+                failed++;
+                break;
+            }
+            resolved++;
+            bool applied = game.makeMove(move.value());
+            applySeconds += std::chrono::duration<double>(Clock::now() - resolvedAt).count();
+            if (!applied) {
+                failed++;
+                break;
+            }
+        }
+    }
+
+    std::cout << "Games:    " << reader.getGamesRead() << " (" << failed << " stopped at an invalid FEN or unresolved move)" << std::endl;
+    std::cout << "Resolve:  " << resolved << " SAN moves in " << resolveSeconds << " s, "
+              << static_cast<long long>(resolved / std::max(resolveSeconds, 1e-9)) << " moves/s" << std::endl;
+    std::cout << "Apply:    " << applySeconds << " s in Game::makeMove, "
+              << static_cast<long long>(resolved / std::max(applySeconds, 1e-9)) << " moves/s" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * Times the block-scanning tokenizer against the per-character one.
+ */
+int Benchmark::runTokenize(const std::string& filename, int passes) {
+    PGNReader reader(filename);
+    if (!reader.isOpen()) {
+        std::cerr << "Cannot read " << filename << std::endl;
+        return 1;
+    }
+    std::vector<std::string> texts;
+    std::string text;
+    uint64_t bytes = 0;
+    while (reader.nextText(text)) {
+        bytes += text.size();
+        texts.push_back(text);
+    }
+
+    // Both tokenizers must agree on every game.
+    PGNGame fast, slow;
+    uint64_t moves = 0, mismatches = 0;
+    for (const std::string& game : texts) {
+        PGNReader::tokenize(game, fast);
+        legacyTokenize(game, slow);
+        moves += fast.moves.size();
+        if (!sameTokens(fast, slow)) mismatches++;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    passes = std::max(1, passes);
+    auto time = [&](void (*tokenize)(std::string_view, PGNGame&)) {
+        PGNGame game;
+        auto begin = Clock::now();
+        for (int pass = 0; pass < passes; pass++) {
+            for (const std::string& text : texts) tokenize(text, game);
+        }
+        return std::chrono::duration<double>(Clock::now() - begin).count();
+    };
+    double legacySeconds = time(legacyTokenize);
+    double blockSeconds = time(PGNReader::tokenize);
+
+    double megabytes = static_cast<double>(bytes) * passes / (1 << 20);
+    std::cout << "Games:      " << texts.size() << ", " << moves << " moves, " << bytes << " bytes, " << passes
+              << " pass(es)" << std::endl;
+    std::cout << "Per char:   " << legacySeconds << " s, " << megabytes / legacySeconds << " MB/s" << std::endl;
+    std::cout << "Blocks:     " << blockSeconds << " s, " << megabytes / blockSeconds << " MB/s ("
+              << legacySeconds / blockSeconds << "x)" << std::endl;
+    std::cout << (mismatches == 0 ? "Both tokenizers agree on every game"
+                                  : std::to_string(mismatches) + " game(s) tokenized differently") << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Counts leaf nodes of the legal move tree.
+ */
+uint64_t Benchmark::perft(const Board& board, Color side, int depth) {
+    std::vector<Move> moves = Search::generateLegalMoves(board, side);
+    if (depth <= 1) return depth == 1 ? moves.size() : 1;
+
+    Color next = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+    uint64_t count = 0;
+    for (const Move& move : moves) {
+        Board child = board;
+        child.applyMove(move);
+        count += perft(child, next, depth - 1);
+    }
+    return count;
+}
@@ -0,0 +1,233 @@
+#include "tools/EpdRunner.h"
+#include "engine/Search.h"
+#include "engine/TranspositionTable.h"
+#include "game/Game.h"
+#include "input/MoveParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+/**
+ * Result of searching one EPD position.
+ */
+struct EpdResult {
+    std::optional<Move> bestMove;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+    int64_t solutionMs = -1;  // -1 if not solved
+};
+
+/**
+ * Checks whether a move satisfies a position's bm/am operations.
+ */
+bool isCorrect(const EpdPosition& position, const std::optional<Move>& move) {
+    if (!move.has_value()) return false;
+    const std::vector<Move>& best = position.bestMoves;
+    const std::vector<Move>& avoid = position.avoidMoves;
+    if (!best.empty() && std::find(best.begin(), best.end(), move.value()) == best.end()) return false;
+    return std::find(avoid.begin(), avoid.end(), move.value()) == avoid.end();
+}
+
+/**
+ * Quotes a string for JSON output.
+ */
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+/**
+ * Joins moves in coordinate notation with spaces.
+ */
+std::string joinMoves(const std::vector<Move>& moves) {
+    std::string out;
+    for (const Move& move : moves) {
+        if (!out.empty()) out += ' ';
+        out += move.toString();
+    }
+    return out;
+}
+
+} // namespace
+
+/**
+ * Parses one EPD line.
+ */
+std::optional<EpdPosition> EpdRunner::parseLine(const std::string& line) {
+    std::istringstream in(line);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        if (!(in >> field)) return std::nullopt;
+    }
+
+    EpdPosition position;
+    position.fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+    Game game;
+    if (!game.loadFen(position.fen)) return std::nullopt;
+
+    // Operations: "opcode operand...;", operands may be quoted.
+    std::string rest;
+    std::getline(in, rest);
+    size_t pos = 0;
+    while (pos < rest.size()) {
+        size_t end = pos;
+        bool quoted = false;
+        while (end < rest.size() && (quoted || rest[end] != ';')) {
+            if (rest[end] == '"') quoted = !quoted;
+            end++;
+        }
+        std::istringstream op(rest.substr(pos, end - pos));
+        pos = end + 1;
+
+        std::string opcode;
+        if (!(op >> opcode)) continue;
+        if (opcode == "id") {
+            std::string operand;
+            std::getline(op, operand);
+            size_t first = operand.find('"');
+            size_t last = operand.rfind('"');
+            position.id = first != std::string::npos && last > first
+                ? operand.substr(first + 1, last - first - 1)
+                : operand.substr(std::min(operand.size(), operand.find_first_not_of(' ')));
+        } else if (opcode == "bm" || opcode == "am") {
+            std::string san;
+            while (op >> san) {
+                ParsedMove parsed = MoveParser::parse(san, game.getBoard(), game.getCurrentPlayer());
+                if (!parsed.isValid || !parsed.move.has_value()) return std::nullopt;
+                (opcode == "bm" ? position.bestMoves : position.avoidMoves).push_back(parsed.move.value());
+            }
+        }
+    }
+    return position;
+}
+
+/**
+ * Solves every position of a suite.
+ */
+int EpdRunner::run(const std::string& filename, int timeMs, int threads, bool csv) {
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        std::cerr << "Cannot read " << filename << std::endl;
+        return 1;
+    }
+
+    std::vector<EpdPosition> positions;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') continue;
+        std::optional<EpdPosition> position = parseLine(line);
+        if (position.has_value()) {
+            positions.push_back(position.value());
+        } else {
+            std::cerr << filename << ":" << lineNumber << ": skipped invalid EPD record" << std::endl;
+        }
+    }
+
+    threads = std::max(1, std::min<int>(threads, static_cast<int>(positions.size())));
+    std::vector<EpdResult> results(positions.size());
+    std::atomic<size_t> next{0};
+    std::mutex outputLock;
+
+    if (csv) std::cout << "index,id,solved,move,expected,avoid,score,depth,nodes,time_ms,solution_ms" << std::endl;
+
+    // One position per worker at a time; each worker owns its search and table.
+    auto worker = [&]() {
+        TranspositionTable table(16);
+        Search search(table);
+        for (size_t i = next++; i < positions.size(); i = next++) {
+            const EpdPosition& position = positions[i];
+            EpdResult& result = results[i];
+
+            Game game;
+            game.loadFen(position.fen);
+            table.clear();
+            search.setInfoCallback([&](const SearchResult& iteration) {
+                if (!isCorrect(position, iteration.bestMove)) {
+                    result.solutionMs = -1;
+                } else if (result.solutionMs < 0) {
+                    result.solutionMs = iteration.timeMs;
+                }
+            });
+
+            SearchLimits limits;
+            limits.time.softMs = timeMs;
+            limits.time.hardMs = timeMs;
+            result.solutionMs = -1;
+            SearchResult final = search.run(game.getBoard(), game.getCurrentPlayer(), limits);
+            result.bestMove = final.bestMove;
+            result.score = final.score;
+            result.depth = final.depth;
+            result.nodes = final.nodes;
+            result.timeMs = final.timeMs;
+            if (!isCorrect(position, final.bestMove)) result.solutionMs = -1;
+
+            bool solved = result.solutionMs >= 0;
+            std::string move = result.bestMove.has_value() ? result.bestMove->toString() : "";
+            std::lock_guard<std::mutex> guard(outputLock);
+            if (csv) {
+                std::string id = position.id;
+                std::replace(id.begin(), id.end(), ',', ';');
+                std::cout << i << "," << id << "," << (solved ? 1 : 0) << "," << move << ","
+                          << joinMoves(position.bestMoves) << "," << joinMoves(position.avoidMoves) << ","
+                          << result.score << "," << result.depth << "," << result.nodes << ","
+                          << result.timeMs << "," << result.solutionMs << std::endl;
+            } else {
+                std::cout << "{\"index\":" << i << ",\"id\":" << jsonString(position.id)
+                          << ",\"solved\":" << (solved ? "true" : "false") << ",\"move\":" << jsonString(move)
+                          << ",\"expected\":" << jsonString(joinMoves(position.bestMoves))
+                          << ",\"avoid\":" << jsonString(joinMoves(position.avoidMoves))
+                          << ",\"score\":" << result.score << ",\"depth\":" << result.depth
+                          << ",\"nodes\":" << result.nodes << ",\"time_ms\":" << result.timeMs
+                          << ",\"solution_ms\":" << result.solutionMs << "}" << std::endl;
+            }
+        }
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker);
+    for (std::thread& thread : pool) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    size_t solved = 0;
+    int64_t solutionTotal = 0;
+    uint64_t nodes = 0;
+    for (const EpdResult& result : results) {
+        nodes += result.nodes;
+        if (result.solutionMs >= 0) {
+            solved++;
+            solutionTotal += result.solutionMs;
+        }
+    }
+    double averageMs = solved ? static_cast<double>(solutionTotal) / solved : 0.0;
+    long long nps = seconds > 0 ? static_cast<long long>(nodes / seconds) : 0;
+
+    char average[32];
+    std::snprintf(average, sizeof(average), "%.1f", averageMs);
+    if (csv) {
+        std::cout << "# positions " << positions.size() << ", solved " << solved << ", avg solution ms "
+                  << average << ", nodes " << nodes << ", nps " << nps << ", threads " << threads << std::endl;
+    } else {
+        std::cout << "{\"summary\":true,\"positions\":" << positions.size() << ",\"solved\":" << solved
+                  << ",\"avg_solution_ms\":" << average << ",\"nodes\":" << nodes << ",\"nps\":" << nps
+                  << ",\"threads\":" << threads << ",\"time_per_position_ms\":" << timeMs << "}" << std::endl;
+    }
+    return 0;
+}
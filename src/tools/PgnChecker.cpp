@@ -0,0 +1,434 @@
+#include "tools/PgnChecker.h"
+#include "input/MoveParser.h"
+#include "input/PGNPipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+const size_t PgnChecker::MERGE_WAYS;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int ERROR_TYPES = 6;
+
+// Records read from each run per refill during a merge.
+const size_t READ_BATCH = 1 << 14;
+
+/**
+ * Hash of a valid game and its number in the file.
+ */
+struct GameKey {
+    uint64_t hash[2];
+    uint64_t number;
+};
+
+/**
+ * Orders keys by hash, then by game number, so the first game of a set of
+ * duplicates comes first.
+ */
+bool keyLess(const GameKey& a, const GameKey& b) {
+    if (a.hash[0] != b.hash[0]) return a.hash[0] < b.hash[0];
+    if (a.hash[1] != b.hash[1]) return a.hash[1] < b.hash[1];
+    return a.number < b.number;
+}
+
+/**
+ * Mixes a value into both halves of a game hash: FNV-1a for one, the
+ * splitmix64 finalizer for the other.
+ */
+void mixHash(uint64_t hash[2], uint64_t value) {
+    hash[0] = (hash[0] ^ value) * 0x100000001b3ULL;
+    uint64_t z = hash[1] + value + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    hash[1] = z ^ (z >> 31);
+}
+
+/**
+ * Seconds elapsed since a time point.
+ */
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * Counters and buffers of one worker.
+ */
+struct WorkerResult {
+    uint64_t errors[ERROR_TYPES] = {};
+    uint64_t firstError[ERROR_TYPES] = {};  // 0-based number of the first example
+    std::string example[ERROR_TYPES];       // its offending token
+    uint64_t valid = 0;
+    uint64_t moves = 0;
+    std::vector<uint64_t> invalid;          // numbers of rejected games
+    std::vector<GameKey> keys;              // hashes not yet spilled
+};
+
+/**
+ * Writes sorted keys to a run file.
+ */
+bool writeRun(const std::string& name, const GameKey* keys, size_t count) {
+    std::ofstream file(name, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(keys), static_cast<std::streamsize>(count * sizeof(GameKey)));
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * Sequential reader of a run file.
+ */
+class RunReader {
+private:
+    std::ifstream file;
+    std::vector<GameKey> buffer;
+    size_t used = 0;
+    size_t position = 0;
+
+public:
+    /**
+     * Opens a run file.
+     */
+    explicit RunReader(const std::string& filename) : file(filename, std::ios::binary), buffer(READ_BATCH) {}
+
+    /**
+     * Reads the next key; false at the end of the run.
+     */
+    bool next(GameKey& key) {
+        if (position == used) {
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(GameKey)));
+            used = static_cast<size_t>(file.gcount()) / sizeof(GameKey);
+            position = 0;
+            if (used == 0) return false;
+        }
+        key = buffer[position++];
+        return true;
+    }
+};
+
+/**
+ * Visits the keys of several sorted runs in merged order.
+ */
+template <typename Visitor>
+void mergeRuns(const std::vector<std::string>& runs, Visitor visit) {
+    std::vector<std::unique_ptr<RunReader>> readers;
+    typedef std::pair<GameKey, size_t> Head;
+    auto greater = [](const Head& a, const Head& b) { return keyLess(b.first, a.first); };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+    for (const std::string& run : runs) {
+        readers.push_back(std::make_unique<RunReader>(run));
+        GameKey key;
+        if (readers.back()->next(key)) heads.push({ key, readers.size() - 1 });
+    }
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        visit(head.first);
+        GameKey key;
+        if (readers[head.second]->next(key)) heads.push({ key, head.second });
+    }
+}
+
+/**
+ * Copies one game's text, restoring the blank lines PGNReader drops
+ * between the tags and the movetext and after the game.
+ */
+void appendGame(std::string& out, const std::string& text) {
+    bool inTags = true;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        bool isTag = text[start] == '[';
+        if (inTags && !isTag) {
+            if (start > 0) out += '\n';
+            inTags = false;
+        }
+        out.append(text, start, end - start);
+        out += '\n';
+        start = end + 1;
+    }
+    out += '\n';
+}
+
+} // namespace
+
+/**
+ * Replays one game with full legality checks and hashes it.
+ */
+GameError PgnChecker::check(const PGNGame& pgn, Game& game, uint64_t hash[2], std::string_view& badToken) {
+    game = Game();
+    hash[0] = 0xcbf29ce484222325ULL;
+    hash[1] = 0;
+    badToken = std::string_view();
+
+    std::string_view fen = pgn.tag("FEN");
+    if (!fen.empty()) {
+        badToken = fen;
+        if (!game.loadFen(std::string(fen))) return GameError::BAD_FEN;
+        for (char c : fen) mixHash(hash, static_cast<unsigned char>(c));
+    }
+
+    for (std::string_view san : pgn.moves) {
+        badToken = san;
+        GameState state = game.getState();
+        if (state == GameState::CHECKMATE || state == GameState::STALEMATE) return GameError::MOVE_AFTER_END;
+
+        const Board& board = game.getBoard();
+        Color side = game.getCurrentPlayer();
+        std::optional<Move> move = MoveParser::resolveSan(san, board, side);
+        if (!move.has_value()) return GameError::BAD_MOVE;
+
+        // "e8" and "e8=Q" are the same move.
+        Move resolved = move.value();
+        const Piece* piece = board.getPieceAt(resolved.getFrom());
+        int lastRank = side == Color::WHITE ? 7 : 0;
+        if (!resolved.isPromotion() && piece->getType() == PieceType::PAWN && resolved.getTo().getRank() == lastRank) {
+            resolved = Move(resolved.getFrom(), resolved.getTo(), PieceType::QUEEN);
+        }
+        if (!game.makeMove(resolved)) return GameError::REJECTED_MOVE;
+        mixHash(hash, resolved.encode());
+    }
+    mixHash(hash, pgn.moves.size());
+
+    // The movetext result and the Result tag must agree with each other and
+    // with a finished position.
+    std::string_view tag = pgn.tag("Result");
+    std::string_view result = pgn.result.empty() ? tag : pgn.result;
+    badToken = result;
+    if (!tag.empty() && !pgn.result.empty() && tag != pgn.result) return GameError::WRONG_RESULT;
+    bool decided = result == "1-0" || result == "0-1" || result == "1/2-1/2";
+    std::string_view expected;
+    if (game.getState() == GameState::CHECKMATE) expected = game.getCurrentPlayer() == Color::WHITE ? "0-1" : "1-0";
+    if (game.getState() == GameState::STALEMATE) expected = "1/2-1/2";
+    if (decided && !expected.empty() && result != expected) return GameError::WRONG_RESULT;
+
+    badToken = std::string_view();
+    return GameError::NONE;
+}
+
+/**
+ * Describes an error type.
+ */
+const char* PgnChecker::describe(GameError error) {
+    switch (error) {
+        case GameError::NONE: return "valid";
+        case GameError::BAD_FEN: return "invalid FEN tag";
+        case GameError::BAD_MOVE: return "illegal, ambiguous or malformed SAN";
+        case GameError::REJECTED_MOVE: return "move rejected by Game::makeMove";
+        case GameError::MOVE_AFTER_END: return "moves after mate or stalemate";
+        case GameError::WRONG_RESULT: return "result contradicts the game";
+    }
+    return "unknown";
+}
+
+/**
+ * Checks a PGN file: validation and hashing in parallel, then duplicate
+ * detection over sorted runs, then (optionally) the clean copy.
+ */
+int PgnChecker::run(const std::string& filename, const PgnCheckOptions& options) {
+    auto begin = Clock::now();
+    PipelineOptions pipeline;
+    pipeline.threads = options.threads;
+    pipeline.replay = false;  // check() replays with its own error reporting
+    int workers = PGNPipeline::workerCount(pipeline);
+
+    size_t capacity = std::max<size_t>(1024, (options.memoryMb << 20) / workers / sizeof(GameKey));
+    std::vector<WorkerResult> results(workers);
+    std::vector<Game> games(workers);
+
+    std::string runPrefix = (options.output.empty() ? filename : options.output) + ".check";
+    std::vector<std::string> runs;
+    std::mutex runsMutex;
+    std::atomic<int> nextRun{0};
+    std::atomic<bool> writeFailed{false};
+
+    // Sorts a worker's keys and writes them out as a run.
+    auto spill = [&](std::vector<GameKey>& keys) {
+        std::sort(keys.begin(), keys.end(), keyLess);
+        std::string name = runPrefix + std::to_string(nextRun++);
+        {
+            std::lock_guard<std::mutex> lock(runsMutex);
+            runs.push_back(name);
+        }
+        if (!writeRun(name, keys.data(), keys.size())) writeFailed = true;
+        keys.clear();
+    };
+
+    auto onGame = [&](int worker, const PGNGame& pgn, const Game&, bool) {
+        WorkerResult& mine = results[worker];
+        GameKey key;
+        key.number = pgn.number;
+        std::string_view badToken;
+        GameError error = check(pgn, games[worker], key.hash, badToken);
+        mine.moves += games[worker].getMoveHistory().size();
+        if (error != GameError::NONE) {
+            int type = static_cast<int>(error);
+            if (mine.errors[type]++ == 0 || pgn.number < mine.firstError[type]) {
+                mine.firstError[type] = pgn.number;
+                mine.example[type] = std::string(badToken);
+            }
+            mine.invalid.push_back(pgn.number);
+            return;
+        }
+        mine.valid++;
+        if (mine.keys.capacity() < capacity) mine.keys.reserve(capacity);
+        mine.keys.push_back(key);
+        if (mine.keys.size() >= capacity) spill(mine.keys);
+    };
+
+    PipelineStats stats = PGNPipeline::run(filename, pipeline, onGame);
+    if (!stats.opened) {
+        std::cerr << "Cannot read " << filename << std::endl;
+        return 1;
+    }
+    double checkSeconds = secondsSince(begin);
+
+    // Duplicates: equal hashes are adjacent in sorted order, first game first.
+    auto dedupStart = Clock::now();
+    std::vector<uint64_t> skipped;
+    bool havePrevious = false;
+    GameKey previous{};
+    uint64_t duplicates = 0;
+    auto visit = [&](const GameKey& key) {
+        if (havePrevious && key.hash[0] == previous.hash[0] && key.hash[1] == previous.hash[1]) {
+            skipped.push_back(key.number);
+            duplicates++;
+        }
+        previous = key;
+        havePrevious = true;
+    };
+
+    size_t runCount = runs.size();
+    if (runs.empty()) {
+        // Everything fit in memory.
+        std::vector<GameKey> keys;
+        for (WorkerResult& result : results) {
+            keys.insert(keys.end(), result.keys.begin(), result.keys.end());
+            std::vector<GameKey>().swap(result.keys);
+        }
+        std::sort(keys.begin(), keys.end(), keyLess);
+        for (const GameKey& key : keys) visit(key);
+    } else {
+        for (WorkerResult& result : results) {
+            if (!result.keys.empty()) spill(result.keys);
+            std::vector<GameKey>().swap(result.keys);
+        }
+        runCount = runs.size();
+        // Merge in passes of at most MERGE_WAYS runs until one pass can finish.
+        while (!writeFailed && runs.size() > MERGE_WAYS) {
+            std::vector<std::string> merged;
+            for (size_t first = 0; first < runs.size(); first += MERGE_WAYS) {
+                std::vector<std::string> group(runs.begin() + first,
+                                               runs.begin() + std::min(runs.size(), first + MERGE_WAYS));
+                std::string name = runPrefix + std::to_string(nextRun++);
+                std::ofstream out(name, std::ios::binary | std::ios::trunc);
+                std::vector<GameKey> pending;
+                mergeRuns(group, [&](const GameKey& key) {
+                    pending.push_back(key);
+                    if (pending.size() == READ_BATCH) {
+                        out.write(reinterpret_cast<const char*>(pending.data()),
+                                  static_cast<std::streamsize>(pending.size() * sizeof(GameKey)));
+                        pending.clear();
+                    }
+                });
+                out.write(reinterpret_cast<const char*>(pending.data()),
+                          static_cast<std::streamsize>(pending.size() * sizeof(GameKey)));
+                out.close();
+                if (out.fail()) writeFailed = true;
+                for (const std::string& run : group) std::remove(run.c_str());
+                merged.push_back(name);
+            }
+            runs = merged;
+        }
+        if (!writeFailed) mergeRuns(runs, visit);
+        for (const std::string& run : runs) std::remove(run.c_str());
+    }
+    if (writeFailed) {
+        std::cerr << "Cannot write temporary files " << runPrefix << "*" << std::endl;
+        return 1;
+    }
+    double dedupSeconds = secondsSince(dedupStart);
+
+    // Copy the valid, unique games in file order.
+    double writeSeconds = 0;
+    uint64_t written = 0;
+    if (!options.output.empty()) {
+        auto writeStart = Clock::now();
+        for (const WorkerResult& result : results) skipped.insert(skipped.end(), result.invalid.begin(), result.invalid.end());
+        std::sort(skipped.begin(), skipped.end());
+
+        PGNReader reader(filename);
+        std::ofstream out(options.output, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Cannot write " << options.output << std::endl;
+            return 1;
+        }
+        std::string buffer;
+        std::string text;
+        size_t nextSkip = 0;
+        for (uint64_t number = 0; reader.nextText(text); number++) {
+            if (nextSkip < skipped.size() && skipped[nextSkip] == number) {
+                nextSkip++;
+                continue;
+            }
+            appendGame(buffer, text);
+            written++;
+            if (buffer.size() >= (1 << 20)) {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.close();
+        if (out.fail()) {
+            std::cerr << "Cannot write " << options.output << std::endl;
+            return 1;
+        }
+        writeSeconds = secondsSince(writeStart);
+    }
+
+    // Summary.
+    WorkerResult total;
+    for (const WorkerResult& result : results) {
+        total.valid += result.valid;
+        total.moves += result.moves;
+        for (int type = 1; type < ERROR_TYPES; type++) {
+            if (result.errors[type] == 0) continue;
+            if (total.errors[type] == 0 || result.firstError[type] < total.firstError[type]) {
+                total.firstError[type] = result.firstError[type];
+                total.example[type] = result.example[type];
+            }
+            total.errors[type] += result.errors[type];
+        }
+    }
+    double seconds = secondsSince(begin);
+    uint64_t invalid = stats.games - total.valid;
+
+    std::cout << "Games:      " << stats.games << " read, " << total.valid << " valid, " << invalid << " invalid, "
+              << duplicates << " duplicate(s), " << total.valid - duplicates << " unique" << std::endl;
+    for (int type = 1; type < ERROR_TYPES; type++) {
+        if (total.errors[type] == 0) continue;
+        std::cout << "  " << describe(static_cast<GameError>(type)) << ": " << total.errors[type] << " (first: game "
+                  << total.firstError[type] + 1 << ", \"" << total.example[type] << "\")" << std::endl;
+    }
+    std::cout << "Moves:      " << total.moves << " replayed with " << workers << " thread(s)" << std::endl;
+    std::cout << "Time:       " << seconds << " s, " << static_cast<long long>(stats.games / seconds) << " games/s, "
+              << static_cast<long long>(total.moves / seconds) << " moves/s, "
+              << stats.bytes / seconds / (1 << 20) << " MB/s" << std::endl;
+    std::cout << "Stages:     check " << checkSeconds << " s, dedup " << dedupSeconds << " s ("
+              << (runCount == 0 ? std::string("in memory") : std::to_string(runCount) + " run(s) on disk") << ")";
+    if (!options.output.empty()) std::cout << ", write " << writeSeconds << " s";
+    std::cout << std::endl;
+    if (!options.output.empty()) std::cout << "Output:     " << written << " game(s) -> " << options.output << std::endl;
+    return 0;
+}
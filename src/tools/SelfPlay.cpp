@@ -0,0 +1,313 @@
+#include "tools/SelfPlay.h"
+#include "engine/Search.h"
+#include "engine/TimeManager.h"
+#include "engine/TranspositionTable.h"
+#include "game/Game.h"
+#include "input/PGNWriter.h"
+#include "pieces/Piece.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int TERMINATIONS = 8;
+
+/**
+ * Work and time of one pool thread.
+ */
+struct ThreadStats {
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    double gameSeconds = 0;    // playing games
+    double searchSeconds = 0;  // of which searching
+};
+
+/**
+ * Checks whether neither side has mating material: bare kings, or a single
+ * bishop or knight against a bare king.
+ */
+bool isBareMaterial(const Board& board) {
+    std::vector<Piece*> pieces = board.getPieces(Color::WHITE);
+    std::vector<Piece*> black = board.getPieces(Color::BLACK);
+    pieces.insert(pieces.end(), black.begin(), black.end());
+    if (pieces.size() == 2) return true;
+    if (pieces.size() != 3) return false;
+    for (const Piece* piece : pieces) {
+        if (piece->getType() == PieceType::BISHOP || piece->getType() == PieceType::KNIGHT) return true;
+    }
+    return false;
+}
+
+/**
+ * Checks whether a field is a non-negative number.
+ */
+bool isNumber(const std::string& field) {
+    return !field.empty() && field.find_first_not_of("0123456789") == std::string::npos;
+}
+
+/**
+ * Plays random legal moves so that games from the same position differ.
+ */
+void playRandomOpening(Game& game, int plies, unsigned seed) {
+    std::mt19937 rng(seed);
+    for (int ply = 0; ply < plies; ply++) {
+        std::vector<Move> moves = Search::generateLegalMoves(game.getBoard(), game.getCurrentPlayer());
+        if (moves.empty()) return;
+        Move move = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+        if (!game.makeMove(move)) return;
+    }
+}
+
+/**
+ * Gets today's date in PGN form (YYYY.MM.DD).
+ */
+std::string today() {
+    std::time_t now = std::time(nullptr);
+    char date[16];
+    if (std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now)) == 0) return "????.??.??";
+    return date;
+}
+
+/**
+ * Gets the result of a game lost by a side.
+ */
+const char* lossFor(Color side) {
+    return side == Color::WHITE ? "0-1" : "1-0";
+}
+
+/**
+ * Plays one game from the position already loaded into game.
+ */
+Termination playGame(Game& game, Search& search, const SelfPlayOptions& options, ThreadStats& stats,
+                     std::string& result, int& plies) {
+    bool timed = options.baseMs > 0;
+    int clock[2] = {options.baseMs, options.baseMs};
+    int halfmoves = 0;
+    std::unordered_map<uint64_t, int> seen;
+    seen[game.getBoard().getHashKey(game.getCurrentPlayer())]++;
+    plies = 0;
+
+    while (true) {
+        Board& board = game.getBoard();
+        Color side = game.getCurrentPlayer();
+        uint64_t key = board.getHashKey(side);
+
+        // Game::makeMove has already run updateGameState for this position.
+        if (game.getState() == GameState::CHECKMATE) {
+            result = lossFor(side);
+            return Termination::CHECKMATE;
+        }
+        result = "1/2-1/2";
+        if (game.getState() == GameState::STALEMATE) return Termination::STALEMATE;
+        if (seen[key] >= 3) return Termination::REPETITION;
+        if (halfmoves >= 100) return Termination::FIFTY_MOVES;
+        if (isBareMaterial(board)) return Termination::MATERIAL;
+        if (plies >= options.maxPlies) return Termination::MAX_PLIES;
+
+        int mover = side == Color::WHITE ? 0 : 1;
+        SearchLimits limits;
+        if (options.depth > 0) limits.depth = options.depth;
+        limits.nodes = options.nodes;
+        if (timed) limits.time = TimeManager::allocate(clock[mover], options.incrementMs);
+
+        auto start = Clock::now();
+        SearchResult found = search.run(board, side, limits);
+        auto elapsed = Clock::now() - start;
+        stats.searchSeconds += std::chrono::duration<double>(elapsed).count();
+
+        if (timed) {
+            clock[mover] -= static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+            if (clock[mover] < 0) {
+                result = lossFor(side);
+                return Termination::TIME;
+            }
+            clock[mover] += options.incrementMs;
+        }
+
+        // A move the game refuses loses, as in any engine tournament.
+        if (!found.bestMove.has_value()) {
+            result = lossFor(side);
+            return Termination::ILLEGAL_MOVE;
+        }
+        const Move& move = found.bestMove.value();
+        const Piece* moving = board.getPieceAt(move.getFrom());
+        bool resetsClock = (moving != nullptr && moving->getType() == PieceType::PAWN) ||
+                           board.getPieceAt(move.getTo()) != nullptr;
+        if (!game.makeMove(move)) {
+            result = lossFor(side);
+            return Termination::ILLEGAL_MOVE;
+        }
+
+        halfmoves = resetsClock ? 0 : halfmoves + 1;
+        plies++;
+        stats.moves++;
+        seen[game.getBoard().getHashKey(game.getCurrentPlayer())]++;
+    }
+}
+
+} // namespace
+
+/**
+ * Reads opening positions from a FEN or EPD file.
+ */
+bool SelfPlay::loadOpenings(const std::string& filename, std::vector<std::string>& fens) {
+    std::ifstream in(filename);
+    if (!in.is_open()) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') continue;
+        // Both formats start with placement, side, castling and en passant.
+        // A FEN's move counters are kept; EPD operations are dropped.
+        std::istringstream fields(line);
+        std::string field;
+        std::string fen;
+        for (int i = 0; i < 4 && fields >> field; i++) fen += (i == 0 ? "" : " ") + field;
+        std::string halfmoves, fullmoves;
+        if (fields >> halfmoves >> fullmoves && isNumber(halfmoves) && isNumber(fullmoves)) {
+            fens.push_back(fen + " " + halfmoves + " " + fullmoves);
+        } else {
+            fens.push_back(fen + " 0 1");
+        }
+    }
+    return true;
+}
+
+/**
+ * Describes a termination.
+ */
+const char* SelfPlay::describe(Termination termination) {
+    switch (termination) {
+        case Termination::CHECKMATE:    return "checkmate";
+        case Termination::STALEMATE:    return "stalemate";
+        case Termination::REPETITION:   return "repetition";
+        case Termination::FIFTY_MOVES:  return "fifty moves";
+        case Termination::MATERIAL:     return "insufficient material";
+        case Termination::MAX_PLIES:    return "max plies";
+        case Termination::TIME:         return "time forfeit";
+        case Termination::ILLEGAL_MOVE: return "illegal move";
+    }
+    return "?";
+}
+
+/**
+ * Plays the games on a thread pool and prints the summary.
+ */
+int SelfPlay::run(const SelfPlayOptions& options) {
+    std::vector<std::string> openings;
+    if (options.openings.empty()) {
+        openings.push_back(Game::START_FEN);
+    } else if (!loadOpenings(options.openings, openings) || openings.empty()) {
+        std::cerr << "No opening positions in " << options.openings << std::endl;
+        return 1;
+    }
+
+    PGNWriter writer(options.output);
+    if (!writer.isOpen()) {
+        std::cerr << "Cannot write " << options.output << std::endl;
+        return 1;
+    }
+
+    int games = std::max(0, options.games);
+    int threads = options.threads > 0 ? options.threads
+                                      : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::max(1, std::min(threads, games));
+
+    std::vector<ThreadStats> stats(threads);
+    std::atomic<int> next{0};
+    std::mutex resultLock;
+    uint64_t whiteWins = 0;
+    uint64_t blackWins = 0;
+    uint64_t draws = 0;
+    uint64_t badOpenings = 0;
+    uint64_t endings[TERMINATIONS] = {};
+    std::string date = today();
+
+    // One game per thread at a time; each thread owns its search and table.
+    auto worker = [&](int index) {
+        ThreadStats& own = stats[index];
+        TranspositionTable table(options.hashMb);
+        Search search(table);
+        for (int number = next++; number < games; number = next++) {
+            const std::string& opening = openings[number % openings.size()];
+            Game game;
+            if (!game.loadFen(opening)) {
+                std::lock_guard<std::mutex> guard(resultLock);
+                badOpenings++;
+                std::cerr << "Game " << number + 1 << ": invalid opening " << opening << std::endl;
+                continue;
+            }
+
+            if (options.openings.empty()) playRandomOpening(game, options.randomPlies, static_cast<unsigned>(number));
+
+            auto start = Clock::now();
+            table.clear();
+            std::string result;
+            int plies = 0;
+            Termination termination = playGame(game, search, options, own, result, plies);
+            own.gameSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            own.games++;
+
+            PGNHeader header;
+            header.event = "Console Chess Self-Play";
+            header.date = date;
+            header.round = std::to_string(number + 1);
+            header.white = "Console Chess";
+            header.black = "Console Chess";
+            header.result = result;
+
+            std::lock_guard<std::mutex> guard(resultLock);
+            writer.write(game, header);
+            if (result == "1-0") whiteWins++;
+            else if (result == "0-1") blackWins++;
+            else draws++;
+            endings[static_cast<int>(termination)]++;
+            std::cout << "Game " << number + 1 << "/" << games << ": " << result << " (" << describe(termination)
+                      << ", " << plies << " plies, thread " << index + 1 << ")" << std::endl;
+        }
+    };
+
+    auto begin = Clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker, t);
+    for (std::thread& thread : pool) thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    bool written = writer.close();
+
+    uint64_t played = whiteWins + blackWins + draws;
+    uint64_t moves = 0;
+    for (const ThreadStats& own : stats) moves += own.moves;
+    double wall = std::max(seconds, 1e-9);
+
+    std::cout << "Games:      " << played << " (white wins " << whiteWins << ", black wins " << blackWins
+              << ", draws " << draws << ")";
+    if (badOpenings > 0) std::cout << ", " << badOpenings << " invalid openings";
+    std::cout << ", written to " << options.output << std::endl;
+    std::cout << "Endings:   ";
+    for (int i = 0; i < TERMINATIONS; i++) {
+        if (endings[i] == 0) continue;
+        std::cout << " " << describe(static_cast<Termination>(i)) << " " << endings[i] << ";";
+    }
+    std::cout << std::endl;
+    std::cout << "Time:       " << seconds << " s, " << static_cast<uint64_t>(played * 3600.0 / wall)
+              << " games/hour, " << static_cast<uint64_t>(moves / wall) << " moves/s with " << threads
+              << " thread(s)" << std::endl;
+    for (int t = 0; t < threads; t++) {
+        const ThreadStats& own = stats[t];
+        std::cout << "Thread " << t + 1 << ":   " << own.games << " games, " << own.moves << " moves, busy "
+                  << static_cast<int>(100 * own.gameSeconds / wall) << "%, searching "
+                  << static_cast<int>(100 * own.searchSeconds / wall) << "%" << std::endl;
+    }
+    return written && badOpenings == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include "util/LatencyStats.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+const int LatencyStats::SUB_BITS;
+const int LatencyStats::BUCKETS;
+
+/**
+ * Gets the bucket of a value: values below 2 * 2^SUB_BITS have their own
+ * bucket, larger ones keep their top SUB_BITS + 1 bits.
+ */
+int LatencyStats::bucketOf(uint32_t micros) {
+    const uint32_t linear = 2u << SUB_BITS;
+    if (micros < linear) return static_cast<int>(micros);
+    int highBit = 31;
+    while ((micros >> highBit) == 0) highBit--;
+    int shift = highBit - SUB_BITS;
+    return static_cast<int>(linear) + ((shift - 1) << SUB_BITS) + static_cast<int>((micros >> shift) - (1u << SUB_BITS));
+}
+
+/**
+ * Gets the largest value that falls into a bucket.
+ */
+uint32_t LatencyStats::bucketTop(int bucket) {
+    const int linear = 2 << SUB_BITS;
+    if (bucket < linear) return static_cast<uint32_t>(bucket);
+    int shift = ((bucket - linear) >> SUB_BITS) + 1;
+    uint64_t mantissa = (1u << SUB_BITS) + ((bucket - linear) & ((1 << SUB_BITS) - 1));
+    return static_cast<uint32_t>(std::min<uint64_t>(((mantissa + 1) << shift) - 1, UINT32_MAX));
+}
+
+/**
+ * Adds a sample, rounded to whole microseconds.
+ */
+void LatencyStats::add(int64_t nanoseconds) {
+    int64_t micros = std::max<int64_t>(0, (nanoseconds + 500) / 1000);
+    uint32_t value = static_cast<uint32_t>(std::min<int64_t>(micros, UINT32_MAX));
+    buckets[bucketOf(value)]++;
+    samples++;
+    largest = std::max(largest, value);
+}
+
+/**
+ * Gets the number of samples.
+ */
+size_t LatencyStats::count() const {
+    return samples;
+}
+
+/**
+ * Gets a percentile (nearest rank) by walking the buckets.
+ */
+uint32_t LatencyStats::percentileUs(double percent) const {
+    if (samples == 0) return 0;
+    double rank = std::ceil(percent / 100.0 * static_cast<double>(samples));
+    uint64_t target = std::min<uint64_t>(static_cast<uint64_t>(std::max(1.0, rank)), samples);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= target) return std::min(bucketTop(bucket), largest);
+    }
+    return largest;
+}
+
+/**
+ * Removes all samples.
+ */
+void LatencyStats::clear() {
+    std::fill(std::begin(buckets), std::end(buckets), 0);
+    samples = 0;
+    largest = 0;
+}
@@ -0,0 +1,86 @@
+#include "util/MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Destructor - unmaps the file.
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * Maps a file, replacing any previous mapping.
+ */
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) return false;
+
+    bytes = static_cast<const char*>(addr);
+    length = static_cast<size_t>(st.st_size);
+    return true;
+#else
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+    fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (fallback.empty()) return false;
+    bytes = fallback.data();
+    length = fallback.size();
+    return true;
+#endif
+}
+
+/**
+ * Unmaps the file.
+ */
+void MappedFile::close() {
+#ifndef _WIN32
+    if (bytes != nullptr) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+    fallback.clear();
+    bytes = nullptr;
+    length = 0;
+}
+
+/**
+ * Checks whether a file is mapped.
+ */
+bool MappedFile::isOpen() const {
+    return bytes != nullptr;
+}
+
+/**
+ * Gets the mapped bytes.
+ */
+const char* MappedFile::data() const {
+    return bytes;
+}
+
+/**
+ * Gets the mapped length.
+ */
+size_t MappedFile::size() const {
+    return length;
+}